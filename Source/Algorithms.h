@@ -0,0 +1,309 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "Quaternion.h"
+#include "Matrix4x4Base.h"
+#include "BoundingBoxBase.h"
+
+// The standard parallel algorithms are used only when the standard library provides them.
+// Note: libstdc++ implements them on top of TBB, so the program has to be linked with -ltbb
+// when the TBB headers are installed; define USE_EXECUTION_POLICIES as DISABLE to avoid it.
+#if USE_EXECUTION_POLICIES && defined(__has_include)
+#if __has_include(<execution>)
+#include <execution>
+#endif
+#endif
+
+#if USE_EXECUTION_POLICIES && defined(__cpp_lib_execution)
+#define HAS_EXECUTION_POLICIES          ENABLE
+#else
+#define HAS_EXECUTION_POLICIES          DISABLE
+#endif
+
+/// <summary>
+///     Bulk vector algorithms taking a standard execution policy as the first argument,
+///     e.g. vm::algorithms::transform_points(std::execution::par_unseq, ...).
+///     When the standard library has no parallel algorithms, the policies in vm::algorithms::execution
+///     are plain tags and every algorithm runs sequentially.
+/// </summary>
+namespace vm
+{
+    namespace algorithms
+    {
+#if HAS_EXECUTION_POLICIES
+        namespace execution = std::execution;
+#else
+        namespace execution
+        {
+            struct sequenced_policy {};
+            struct parallel_policy {};
+            struct parallel_unsequenced_policy {};
+
+            constexpr sequenced_policy seq{};
+            constexpr parallel_policy par{};
+            constexpr parallel_unsequenced_policy par_unseq{};
+        }
+#endif
+
+        namespace detail
+        {
+            template<typename TPolicy>
+            constexpr bool IsParallelPolicy()
+            {
+#if HAS_EXECUTION_POLICIES
+                return std::is_execution_policy<typename std::decay<TPolicy>::type>::value;
+#else
+                return false;
+#endif
+            }
+
+            template<typename TPolicy, typename TInput, typename TOutput, typename TFunction>
+            TOutput Transform(TPolicy&& policy, TInput first, TInput last, TOutput destination, TFunction function)
+            {
+#if HAS_EXECUTION_POLICIES
+                if constexpr (IsParallelPolicy<TPolicy>())
+                    return std::transform(std::forward<TPolicy>(policy), first, last, destination, function);
+                else
+#endif
+                    return std::transform(first, last, destination, function);
+            }
+
+            template<typename TPolicy, typename TInput1, typename TInput2, typename TOutput, typename TFunction>
+            TOutput Transform(TPolicy&& policy, TInput1 first1, TInput1 last1, TInput2 first2, TOutput destination, TFunction function)
+            {
+#if HAS_EXECUTION_POLICIES
+                if constexpr (IsParallelPolicy<TPolicy>())
+                    return std::transform(std::forward<TPolicy>(policy), first1, last1, first2, destination, function);
+                else
+#endif
+                    return std::transform(first1, last1, first2, destination, function);
+            }
+
+            template<typename TPolicy, typename TInput, typename TValue, typename TReduce, typename TFunction>
+            TValue TransformReduce(TPolicy&& policy, TInput first, TInput last, TValue initial, TReduce reduce, TFunction function)
+            {
+#if HAS_EXECUTION_POLICIES
+                if constexpr (IsParallelPolicy<TPolicy>())
+                    return std::transform_reduce(std::forward<TPolicy>(policy), first, last, initial, reduce, function);
+                else
+#endif
+                    return std::transform_reduce(first, last, initial, reduce, function);
+            }
+
+            template<typename TVector>
+            TVector Fill(const typename TVector::value_type value)
+            {
+                TVector result;
+                for (auto i = size_t(0); i < TVector::Dimension; i++)
+                    result[i] = value;
+
+                return result;
+            }
+
+            template<typename TVector, typename TOperation>
+            TVector PerComponent(const TVector& a, const TVector& b, TOperation operation)
+            {
+                TVector result;
+                for (auto i = size_t(0); i < TVector::Dimension; i++)
+                    result[i] = operation(a[i], b[i]);
+
+                return result;
+            }
+
+            template<typename T>
+            struct MinMax
+            {
+                Vector3Base<T> minimum;
+                Vector3Base<T> maximum;
+            };
+        }
+
+        /// <summary>
+        ///     Transforms an array of vectors by a matrix, see Vector3Base::Transform.
+        /// </summary>
+        /// <param name="policy">The execution policy.</param>
+        /// <param name="first">The beginning of the source range.</param>
+        /// <param name="last">The end of the source range.</param>
+        /// <param name="destination">The beginning of the destination range, can be the same as first.</param>
+        /// <param name="matrix">The transformation matrix.</param>
+        /// <returns>The end of the destination range.</returns>
+        template<typename TPolicy, typename TInput, typename TOutput, typename T>
+        TOutput transform_points(TPolicy&& policy, TInput first, TInput last, TOutput destination, const Matrix4x4Base<T>& matrix)
+        {
+            typedef typename std::iterator_traits<TInput>::value_type Vector;
+
+            return detail::Transform(std::forward<TPolicy>(policy), first, last, destination, [&matrix](const Vector& point)
+            {
+                return Vector::Transform(point, matrix);
+            });
+        }
+
+        /// <summary>
+        ///     Rotates an array of vectors by a quaternion, see Vector3Base::Transform.
+        /// </summary>
+        /// <param name="policy">The execution policy.</param>
+        /// <param name="first">The beginning of the source range.</param>
+        /// <param name="last">The end of the source range.</param>
+        /// <param name="destination">The beginning of the destination range, can be the same as first.</param>
+        /// <param name="rotation">The rotation.</param>
+        /// <returns>The end of the destination range.</returns>
+        template<typename TPolicy, typename TInput, typename TOutput>
+        TOutput transform_points(TPolicy&& policy, TInput first, TInput last, TOutput destination, const Quaternion& rotation)
+        {
+            typedef typename std::iterator_traits<TInput>::value_type Vector;
+
+            return detail::Transform(std::forward<TPolicy>(policy), first, last, destination, [&rotation](const Vector& point)
+            {
+                return Vector::Transform(point, rotation);
+            });
+        }
+
+        /// <summary>
+        ///     Multiplies an array of matrices by a matrix (source[i] * matrix).
+        /// </summary>
+        /// <param name="policy">The execution policy.</param>
+        /// <param name="first">The beginning of the source range.</param>
+        /// <param name="last">The end of the source range.</param>
+        /// <param name="destination">The beginning of the destination range, can be the same as first.</param>
+        /// <param name="matrix">The right-hand side matrix.</param>
+        /// <returns>The end of the destination range.</returns>
+        template<typename TPolicy, typename TInput, typename TOutput, typename T>
+        TOutput transform_matrices(TPolicy&& policy, TInput first, TInput last, TOutput destination, const Matrix4x4Base<T>& matrix)
+        {
+            return detail::Transform(std::forward<TPolicy>(policy), first, last, destination, [&matrix](const Matrix4x4Base<T>& source)
+            {
+                return source * matrix;
+            });
+        }
+
+        /// <summary>
+        ///     Normalizes an array of vectors or quaternions in place.
+        /// </summary>
+        /// <param name="policy">The execution policy.</param>
+        /// <param name="first">The beginning of the range.</param>
+        /// <param name="last">The end of the range.</param>
+        template<typename TPolicy, typename TIterator>
+        void normalize_all(TPolicy&& policy, TIterator first, TIterator last)
+        {
+            typedef typename std::iterator_traits<TIterator>::value_type Value;
+
+            detail::Transform(std::forward<TPolicy>(policy), first, last, first, [](Value value)
+            {
+                value.Normalize();
+                return value;
+            });
+        }
+
+        /// <summary>
+        ///     Normalized linear interpolation of two quaternion arrays, see Quaternion::Lerp.
+        /// </summary>
+        /// <param name="policy">The execution policy.</param>
+        /// <param name="fromFirst">The beginning of the start rotation range.</param>
+        /// <param name="fromLast">The end of the start rotation range.</param>
+        /// <param name="toFirst">The beginning of the end rotation range.</param>
+        /// <param name="destination">The beginning of the destination range.</param>
+        /// <param name="amount">The interpolation amount.</param>
+        /// <returns>The end of the destination range.</returns>
+        template<typename TPolicy, typename TInput1, typename TInput2, typename TOutput>
+        TOutput nlerp_all(TPolicy&& policy, TInput1 fromFirst, TInput1 fromLast, TInput2 toFirst, TOutput destination, const float amount)
+        {
+            return detail::Transform(std::forward<TPolicy>(policy), fromFirst, fromLast, toFirst, destination, [amount](const Quaternion& from, const Quaternion& to)
+            {
+                return Quaternion::Lerp(from, to, amount);
+            });
+        }
+
+        /// <summary>
+        ///     Returns the component-wise sum of an array of vectors.
+        /// </summary>
+        template<typename TPolicy, typename TIterator>
+        typename std::iterator_traits<TIterator>::value_type reduce_sum(TPolicy&& policy, TIterator first, TIterator last)
+        {
+            typedef typename std::iterator_traits<TIterator>::value_type Vector;
+            typedef typename Vector::value_type Scalar;
+
+            return detail::TransformReduce(std::forward<TPolicy>(policy), first, last, detail::Fill<Vector>(Scalar(0)),
+                [](const Vector& a, const Vector& b)
+                {
+                    return detail::PerComponent(a, b, [](const Scalar x, const Scalar y) { return x + y; });
+                },
+                [](const Vector& value) { return value; });
+        }
+
+        /// <summary>
+        ///     Returns the component-wise minimum of an array of vectors,
+        ///     or a vector filled with the largest representable value when the range is empty.
+        /// </summary>
+        template<typename TPolicy, typename TIterator>
+        typename std::iterator_traits<TIterator>::value_type reduce_min(TPolicy&& policy, TIterator first, TIterator last)
+        {
+            typedef typename std::iterator_traits<TIterator>::value_type Vector;
+            typedef typename Vector::value_type Scalar;
+
+            return detail::TransformReduce(std::forward<TPolicy>(policy), first, last, detail::Fill<Vector>(std::numeric_limits<Scalar>::max()),
+                [](const Vector& a, const Vector& b)
+                {
+                    return detail::PerComponent(a, b, [](const Scalar x, const Scalar y) { return Math::Min(x, y); });
+                },
+                [](const Vector& value) { return value; });
+        }
+
+        /// <summary>
+        ///     Returns the component-wise maximum of an array of vectors,
+        ///     or a vector filled with the lowest representable value when the range is empty.
+        /// </summary>
+        template<typename TPolicy, typename TIterator>
+        typename std::iterator_traits<TIterator>::value_type reduce_max(TPolicy&& policy, TIterator first, TIterator last)
+        {
+            typedef typename std::iterator_traits<TIterator>::value_type Vector;
+            typedef typename Vector::value_type Scalar;
+
+            return detail::TransformReduce(std::forward<TPolicy>(policy), first, last, detail::Fill<Vector>(std::numeric_limits<Scalar>::lowest()),
+                [](const Vector& a, const Vector& b)
+                {
+                    return detail::PerComponent(a, b, [](const Scalar x, const Scalar y) { return Math::Max(x, y); });
+                },
+                [](const Vector& value) { return value; });
+        }
+
+        /// <summary>
+        ///     Returns the bounding box of an array of points, see BoundingBoxBase::FromPoints.
+        ///     The minimum and maximum are reduced in a single pass over the points.
+        /// </summary>
+        template<typename TPolicy, typename TIterator>
+        auto reduce_bounds(TPolicy&& policy, TIterator first, TIterator last)
+            -> BoundingBoxBase<typename std::iterator_traits<TIterator>::value_type::value_type>
+        {
+            typedef typename std::iterator_traits<TIterator>::value_type::value_type T;
+            typedef detail::MinMax<T> MinMax;
+
+            if (first == last)
+                return BoundingBoxBase<T>();
+
+            const auto initial = MinMax{ Vector3Base<T>(std::numeric_limits<T>::max()), Vector3Base<T>(std::numeric_limits<T>::lowest()) };
+
+            const auto bounds = detail::TransformReduce(std::forward<TPolicy>(policy), first, last, initial,
+                [](const MinMax& a, const MinMax& b)
+                {
+                    return MinMax{
+                        Vector3Base<T>(Math::Min(a.minimum.x, b.minimum.x), Math::Min(a.minimum.y, b.minimum.y), Math::Min(a.minimum.z, b.minimum.z)),
+                        Vector3Base<T>(Math::Max(a.maximum.x, b.maximum.x), Math::Max(a.maximum.y, b.maximum.y), Math::Max(a.maximum.z, b.maximum.z))
+                    };
+                },
+                [](const Vector3Base<T>& point) { return MinMax{ point, point }; });
+
+            return BoundingBoxBase<T>::FromMinMax(bounds.minimum, bounds.maximum);
+        }
+    }
+}
@@ -0,0 +1,615 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "Quaternion.h"
+#include "AnimationTrack.h"
+
+/// <summary>
+///     Compressed set of Vector3 and Quaternion animation tracks, sampled directly from a single contiguous blob.
+///     Compress drops every key which can be rebuilt by interpolating its neighbours within the given tolerance
+///     and quantizes the remaining ones:
+///         - key times to 16 bits of the track duration,
+///         - Vector3 keys to 16 bits per component within the range of the track,
+///         - Quaternion keys to the smallest three components, 15 bits each within the range of the track,
+///           plus the 2 bit index of the dropped largest one.
+///     Every key takes 8 bytes (2 for the time, 6 for the value) against 16 or 20 of an uncompressed track.
+///     Every source key is checked by sampling the compressed track at its time, exactly as the decoder does,
+///     and the compression fails when the tolerance can't be met: for a tolerance below the value quantization
+///     step (about range / 65535 per component), or for a jump on both sides of a key of a variable rate track.
+/// </summary>
+class CompressedAnimation
+{
+public:
+    static const uint32_t Magic = 0x43414D56u; // "VMAC"
+    static const uint32_t Version = 2;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vectorTrackCount;
+        uint32_t rotationTrackCount;
+    };
+
+    /// <summary>
+    ///     The track headers follow the blob header, the vector tracks first.
+    ///     The key times (keyCount uint16s) and values (3 * keyCount uint16s) of a track are stored at dataOffset.
+    /// </summary>
+    struct TrackHeader
+    {
+        float startTime;
+        float duration;     // The time of the largest quantized time, past the last key for uniformly sampled tracks
+        uint32_t keyCount;
+        uint32_t dataOffset;
+        float minimum[3];   // Rotations only use the first component, all of the stored components share the range
+        float extent[3];
+    };
+
+public:
+    CompressedAnimation() = default;
+
+    /// <summary>
+    ///     Wraps a blob created by Compress, the blob is not copied and has to outlive this object.
+    ///     The blob has to be at least 2-byte aligned. Invalid blobs result in an animation without tracks.
+    /// </summary>
+    CompressedAnimation(const uint8_t* data, const size_t size)
+    {
+        Header header;
+        if (data == nullptr || size < sizeof(Header))
+            return;
+
+        std::memcpy(&header, data, sizeof(Header));
+        const auto trackCount = size_t(header.vectorTrackCount) + header.rotationTrackCount;
+
+        if (header.magic != Magic || header.version != Version || size < sizeof(Header) + trackCount * sizeof(TrackHeader))
+            return;
+
+        std::vector<TrackHeader> headers(trackCount);
+        std::memcpy(headers.data(), data + sizeof(Header), trackCount * sizeof(TrackHeader));
+
+        for (const auto& trackHeader : headers)
+        {
+            if (trackHeader.keyCount == 0 || size_t(trackHeader.dataOffset) + size_t(trackHeader.keyCount) * 4 * sizeof(uint16_t) > size)
+                return;
+        }
+
+        // The reciprocals are computed once here, sampling only multiplies
+        m_tracks.resize(trackCount);
+        for (auto i = size_t(0); i < trackCount; i++)
+        {
+            const auto& trackHeader = headers[i];
+            const auto scale = i < header.vectorTrackCount ? VectorScale : RotationScale;
+            m_tracks[i] = CreateTrack(trackHeader, reinterpret_cast<const uint16_t*>(data + trackHeader.dataOffset), scale);
+        }
+
+        m_vectorTrackCount = header.vectorTrackCount;
+    }
+
+public:
+    /// <summary>
+    ///     Samples a vector track.
+    /// </summary>
+    /// <param name="track">The vector track index.</param>
+    /// <param name="time">The time, clamped to the track range.</param>
+    /// <param name="cursor">The per-track key cursor, makes playing forward O(1).</param>
+    Vector3Base<float> SampleVector(const size_t track, const float time, uint32_t& cursor) const
+    {
+        return SampleTrack(m_tracks[track], time, cursor, static_cast<const Vector3Base<float>*>(nullptr));
+    }
+
+    /// <summary>
+    ///     Samples a rotation track.
+    /// </summary>
+    /// <param name="track">The rotation track index.</param>
+    /// <param name="time">The time, clamped to the track range.</param>
+    /// <param name="cursor">The per-track key cursor, makes playing forward O(1).</param>
+    Quaternion SampleRotation(const size_t track, const float time, uint32_t& cursor) const
+    {
+        return SampleTrack(m_tracks[m_vectorTrackCount + track], time, cursor, static_cast<const Quaternion*>(nullptr));
+    }
+
+    /// <summary>
+    ///     Samples all of the tracks.
+    /// </summary>
+    /// <param name="time">The time.</param>
+    /// <param name="cursors">The key cursors, one per track (vector tracks first), zero initialized before the first call.</param>
+    /// <param name="vectors">The output values of the vector tracks.</param>
+    /// <param name="rotations">The output values of the rotation tracks.</param>
+    void Sample(const float time, uint32_t* cursors, Vector3Base<float>* vectors, Quaternion* rotations) const
+    {
+        for (auto i = size_t(0); i < m_vectorTrackCount; i++)
+            vectors[i] = SampleVector(i, time, cursors[i]);
+
+        for (auto i = size_t(0); i < GetRotationTrackCount(); i++)
+            rotations[i] = SampleRotation(i, time, cursors[m_vectorTrackCount + i]);
+    }
+
+    size_t GetVectorTrackCount() const
+    {
+        return m_vectorTrackCount;
+    }
+
+    size_t GetRotationTrackCount() const
+    {
+        return m_tracks.size() - m_vectorTrackCount;
+    }
+
+    /// <summary>
+    ///     Returns the number of keys kept by the compression for a track, vector tracks first.
+    /// </summary>
+    size_t GetKeyCount(const size_t track) const
+    {
+        return m_tracks[track].keyCount;
+    }
+
+public:
+    /// <summary>
+    ///     Compresses a set of tracks into a blob.
+    /// </summary>
+    /// <param name="vectorTracks">The vector tracks (translations, scales).</param>
+    /// <param name="vectorTrackCount">The vector track count.</param>
+    /// <param name="rotationTracks">The rotation tracks, with normalized keys.</param>
+    /// <param name="rotationTrackCount">The rotation track count.</param>
+    /// <param name="vectorTolerance">The maximum distance between a source key and the compressed track at its time.</param>
+    /// <param name="rotationTolerance">The maximum angle (in radians) between a source key and the compressed track at its time.</param>
+    /// <returns>The blob, empty when a track has no keys or a key can't be reproduced within the tolerance.</returns>
+    static std::vector<uint8_t> Compress(const AnimationTrack<Vector3Base<float>>* vectorTracks, const size_t vectorTrackCount,
+        const AnimationTrack<Quaternion>* rotationTracks, const size_t rotationTrackCount,
+        const float vectorTolerance = 0.001f, const float rotationTolerance = 0.0005f)
+    {
+        const auto trackCount = vectorTrackCount + rotationTrackCount;
+        std::vector<TrackHeader> headers(trackCount);
+        std::vector<std::vector<uint16_t>> data(trackCount);
+
+        for (auto i = size_t(0); i < vectorTrackCount; i++)
+        {
+            if (!CompressTrack(vectorTracks[i], vectorTolerance, headers[i], data[i]))
+                return {};
+        }
+
+        // Unit quaternions of rotations which differ by an angle are 2 * sin(angle / 4) apart
+        const auto maximumChord = 2.0f * std::sin(rotationTolerance * 0.25f);
+        for (auto i = size_t(0); i < rotationTrackCount; i++)
+        {
+            if (!CompressTrack(rotationTracks[i], maximumChord, headers[vectorTrackCount + i], data[vectorTrackCount + i]))
+                return {};
+        }
+
+        auto offset = sizeof(Header) + trackCount * sizeof(TrackHeader);
+        for (auto i = size_t(0); i < trackCount; i++)
+        {
+            headers[i].dataOffset = static_cast<uint32_t>(offset);
+            offset += data[i].size() * sizeof(uint16_t);
+        }
+
+        const Header header = { Magic, Version, static_cast<uint32_t>(vectorTrackCount), static_cast<uint32_t>(rotationTrackCount) };
+
+        std::vector<uint8_t> blob(offset);
+        std::memcpy(blob.data(), &header, sizeof(Header));
+        std::memcpy(blob.data() + sizeof(Header), headers.data(), trackCount * sizeof(TrackHeader));
+
+        for (auto i = size_t(0); i < trackCount; i++)
+            std::memcpy(blob.data() + headers[i].dataOffset, data[i].data(), data[i].size() * sizeof(uint16_t));
+
+        return blob;
+    }
+
+private:
+    static const uint32_t MaxLinearSteps = 4;
+    static const uint32_t TimeScale = 65535;
+    static const uint32_t VectorScale = 65535;
+    static const uint32_t RotationScale = 32767;
+
+    struct Track
+    {
+        float startTime;
+        float timeScale;    // Seconds to quantized time
+        uint32_t keyCount;
+        const uint16_t* times;
+        const uint16_t* values;
+        float minimum[3];
+        float step[3];      // The value of a single quantization step
+    };
+
+    static Track CreateTrack(const TrackHeader& header, const uint16_t* data, const uint32_t valueScale)
+    {
+        Track track;
+        track.startTime = header.startTime;
+        track.timeScale = header.duration > 0.0f ? static_cast<float>(TimeScale) / header.duration : 0.0f;
+        track.keyCount = header.keyCount;
+        track.times = data;
+        track.values = data + header.keyCount;
+
+        for (auto c = 0; c < 3; c++)
+        {
+            track.minimum[c] = header.minimum[c];
+            track.step[c] = header.extent[c] / static_cast<float>(valueScale);
+        }
+
+        return track;
+    }
+
+    static Vector3Base<float> SampleTrack(const Track& track, const float time, uint32_t& cursor, const Vector3Base<float>*)
+    {
+        auto fraction = 0.0f;
+        const auto key = FindKey(track, time, cursor, fraction);
+        const auto next = Math::Min(key + 1, track.keyCount - 1);
+
+        return Vector3Base<float>::Lerp(DecodeVector(track.values + key * 3, track.minimum, track.step),
+            DecodeVector(track.values + next * 3, track.minimum, track.step), fraction);
+    }
+
+    static Quaternion SampleTrack(const Track& track, const float time, uint32_t& cursor, const Quaternion*)
+    {
+        auto fraction = 0.0f;
+        const auto key = FindKey(track, time, cursor, fraction);
+        const auto next = Math::Min(key + 1, track.keyCount - 1);
+
+        const auto from = DecodeRotation(track.values + key * 3, track.minimum[0], track.step[0]);
+        const auto to = DecodeRotation(track.values + next * 3, track.minimum[0], track.step[0]);
+
+        // Quaternion::Lerp, without its zero length checks as the decoded keys are normalized
+        const auto amount = Quaternion::Dot(from, to) < 0.0f ? -fraction : fraction;
+        const auto inverse = 1.0f - fraction;
+
+        Quaternion rotation;
+        for (auto i = 0; i < 4; i++)
+            rotation[i] = inverse * from[i] + amount * to[i];
+
+        const auto inverseLength = 1.0f / Math::Sqrt(Quaternion::Dot(rotation, rotation));
+        for (auto i = 0; i < 4; i++)
+            rotation[i] *= inverseLength;
+
+        return rotation;
+    }
+
+    static uint32_t FindKey(const Track& track, const float time, uint32_t& cursor, float& fraction)
+    {
+        const auto lastKey = track.keyCount - 1;
+        const auto times = track.times;
+
+        if (lastKey == 0 || track.timeScale <= 0.0f)
+        {
+            fraction = 0.0f;
+            return cursor = 0;
+        }
+
+        // Compare in the quantized time domain, the range of uniformly sampled tracks can end past the last key
+        const auto position = Math::Clamp((time - track.startTime) * track.timeScale, 0.0f, static_cast<float>(times[lastKey]));
+        auto key = Math::Min(cursor, lastKey - 1);
+
+        if (static_cast<float>(times[key]) <= position)
+        {
+            auto steps = 0u;
+            while (key + 1 < lastKey && static_cast<float>(times[key + 1]) <= position && steps++ < MaxLinearSteps)
+                key++;
+
+            if (key + 1 < lastKey && static_cast<float>(times[key + 1]) <= position)
+            {
+                const auto found = std::upper_bound(times + key + 1, times + lastKey + 1, position,
+                    [](const float value, const uint16_t element) { return value < static_cast<float>(element); });
+                key = Math::Min(static_cast<uint32_t>(found - times) - 1, lastKey - 1);
+            }
+        }
+        else
+        {
+            const auto found = std::upper_bound(times, times + key + 1, position,
+                [](const float value, const uint16_t element) { return value < static_cast<float>(element); });
+            key = static_cast<uint32_t>(found - times) - 1;
+        }
+
+        const auto span = static_cast<float>(times[key + 1]) - static_cast<float>(times[key]);
+        fraction = span > 0.0f ? (position - static_cast<float>(times[key])) / span : 0.0f;
+        return cursor = key;
+    }
+
+    static uint16_t Quantize(const float value, const float minimum, const float extent, const uint32_t scale)
+    {
+        if (extent <= 0.0f)
+            return 0;
+
+        const auto normalized = Math::Clamp((value - minimum) / extent, 0.0f, 1.0f);
+        return static_cast<uint16_t>(normalized * static_cast<float>(scale) + 0.5f);
+    }
+
+    static float Dequantize(const uint32_t value, const float minimum, const float step)
+    {
+        return minimum + static_cast<float>(value) * step;
+    }
+
+    static void GetSmallestThree(const Quaternion& rotation, uint32_t& largestIndex, float* smallest)
+    {
+        largestIndex = 0;
+        for (auto i = 1u; i < 4; i++)
+        {
+            if (Math::Abs(rotation[i]) > Math::Abs(rotation[largestIndex]))
+                largestIndex = i;
+        }
+
+        // q and -q are the same rotation, the dropped component is made positive
+        const auto sign = rotation[largestIndex] < 0.0f ? -1.0f : 1.0f;
+        for (auto i = 0u, j = 0u; i < 4; i++)
+        {
+            if (i != largestIndex)
+                smallest[j++] = rotation[i] * sign;
+        }
+    }
+
+    static void ComputeRange(const Vector3Base<float>* values, const size_t count, TrackHeader& header)
+    {
+        for (auto c = 0; c < 3; c++)
+        {
+            auto minimum = values[0][c];
+            auto maximum = values[0][c];
+
+            for (auto i = size_t(1); i < count; i++)
+            {
+                minimum = Math::Min(minimum, values[i][c]);
+                maximum = Math::Max(maximum, values[i][c]);
+            }
+
+            header.minimum[c] = minimum;
+            header.extent[c] = maximum - minimum;
+        }
+    }
+
+    static void ComputeRange(const Quaternion* values, const size_t count, TrackHeader& header)
+    {
+        auto minimum = 1.0f;
+        auto maximum = -1.0f;
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            uint32_t largestIndex;
+            float smallest[3];
+            GetSmallestThree(values[i], largestIndex, smallest);
+
+            for (const auto value : smallest)
+            {
+                minimum = Math::Min(minimum, value);
+                maximum = Math::Max(maximum, value);
+            }
+        }
+
+        header.minimum[0] = minimum;
+        header.extent[0] = Math::Max(maximum - minimum, 0.0f);
+        header.minimum[1] = header.minimum[2] = 0.0f;
+        header.extent[1] = header.extent[2] = 0.0f;
+    }
+
+    static void Encode(const Vector3Base<float>& value, const TrackHeader& header, uint16_t* encoded)
+    {
+        for (auto c = 0; c < 3; c++)
+            encoded[c] = Quantize(value[c], header.minimum[c], header.extent[c], VectorScale);
+    }
+
+    static void Encode(const Quaternion& value, const TrackHeader& header, uint16_t* encoded)
+    {
+        uint32_t largestIndex;
+        float smallest[3];
+        GetSmallestThree(value, largestIndex, smallest);
+
+        // The 2 bits of the index are stored in the top bits of the first two components
+        for (auto c = 0; c < 3; c++)
+            encoded[c] = Quantize(smallest[c], header.minimum[0], header.extent[0], RotationScale);
+
+        encoded[0] |= static_cast<uint16_t>((largestIndex & 1u) << 15);
+        encoded[1] |= static_cast<uint16_t>((largestIndex >> 1) << 15);
+    }
+
+    static Vector3Base<float> DecodeVector(const uint16_t* encoded, const float* minimum, const float* step)
+    {
+        return Vector3Base<float>(
+            Dequantize(encoded[0], minimum[0], step[0]),
+            Dequantize(encoded[1], minimum[1], step[1]),
+            Dequantize(encoded[2], minimum[2], step[2]));
+    }
+
+    static Quaternion DecodeRotation(const uint16_t* encoded, const float minimum, const float step)
+    {
+        const auto largestIndex = (encoded[0] >> 15) | ((encoded[1] >> 15) << 1);
+        const auto a = Dequantize(encoded[0] & 0x7FFFu, minimum, step);
+        const auto b = Dequantize(encoded[1] & 0x7FFFu, minimum, step);
+        const auto c = Dequantize(encoded[2] & 0x7FFFu, minimum, step);
+        const auto largest = Math::Sqrt(Math::Max(1.0f - (a * a + b * b + c * c), 0.0f));
+
+        switch (largestIndex)
+        {
+        case 0:
+            return Quaternion(largest, a, b, c);
+        case 1:
+            return Quaternion(a, largest, b, c);
+        case 2:
+            return Quaternion(a, b, largest, c);
+        default:
+            return Quaternion(a, b, c, largest);
+        }
+    }
+
+    static Vector3Base<float> Decode(const uint16_t* encoded, const TrackHeader& header, const Vector3Base<float>*)
+    {
+        const float step[3] = { header.extent[0] / VectorScale, header.extent[1] / VectorScale, header.extent[2] / VectorScale };
+        return DecodeVector(encoded, header.minimum, step);
+    }
+
+    static Quaternion Decode(const uint16_t* encoded, const TrackHeader& header, const Quaternion*)
+    {
+        return DecodeRotation(encoded, header.minimum[0], header.extent[0] / RotationScale);
+    }
+
+    static uint32_t GetValueScale(const Vector3Base<float>*)
+    {
+        return VectorScale;
+    }
+
+    static uint32_t GetValueScale(const Quaternion*)
+    {
+        return RotationScale;
+    }
+
+    static bool IsWithinTolerance(const Vector3Base<float>& value, const Vector3Base<float>& reference, const float tolerance)
+    {
+        return Vector3Base<float>::DistanceSquared(value, reference) <= tolerance * tolerance;
+    }
+
+    static bool IsWithinTolerance(const Quaternion& value, const Quaternion& reference, const float maximumChord)
+    {
+        // The distance between the 4D points is precise for small angles, unlike the dot product which is within an epsilon of 1
+        const auto sign = Quaternion::Dot(value, reference) < 0.0f ? -1.0f : 1.0f;
+
+        auto distanceSquared = 0.0f;
+        for (auto i = 0; i < 4; i++)
+        {
+            const auto difference = value[i] - reference[i] * sign;
+            distanceSquared += difference * difference;
+        }
+
+        return distanceSquared <= maximumChord * maximumChord;
+    }
+
+    template<typename TValue>
+    static bool CompressTrack(const AnimationTrack<TValue>& track, const float tolerance, TrackHeader& header, std::vector<uint16_t>& data)
+    {
+        const auto keyCount = track.GetKeyCount();
+        if (keyCount == 0)
+            return false;
+
+        std::vector<TValue> values(keyCount);
+        for (auto i = size_t(0); i < keyCount; i++)
+            values[i] = track.GetValue(i);
+
+        header.startTime = track.GetKeyTime(0);
+        header.duration = GetTimeRange(track);
+        ComputeRange(values.data(), keyCount, header);
+
+        // Quantize all of the keys first, the reduction measures the error of what the decoder will actually produce
+        const auto timeScale = header.duration > 0.0f ? static_cast<float>(TimeScale) / header.duration : 0.0f;
+        std::vector<uint16_t> times(keyCount);
+        std::vector<float> exactTimes(keyCount);
+        std::vector<uint16_t> encoded(keyCount * 3);
+        std::vector<TValue> decoded(keyCount);
+
+        for (auto i = size_t(0); i < keyCount; i++)
+        {
+            // Mapped to the quantized time domain exactly as FindKey does
+            exactTimes[i] = Math::Clamp((track.GetKeyTime(i) - header.startTime) * timeScale, 0.0f, static_cast<float>(TimeScale));
+            times[i] = static_cast<uint16_t>(exactTimes[i] + 0.5f);
+
+            Encode(values[i], header, encoded.data() + i * 3);
+            decoded[i] = Decode(encoded.data() + i * 3, header, static_cast<const TValue*>(nullptr));
+        }
+
+        // Greedily extend every segment for as long as it reproduces all of the keys it skips
+        std::vector<size_t> kept(1, 0);
+        auto anchor = size_t(0);
+
+        for (auto end = size_t(2); end < keyCount; end++)
+        {
+            const auto span = static_cast<float>(times[end]) - static_cast<float>(times[anchor]);
+            auto valid = true;
+
+            for (auto i = anchor + 1; i < end && valid; i++)
+            {
+                // Sampled at the original key time, as the decoder would
+                const auto fraction = span > 0.0f ? Math::Clamp((exactTimes[i] - static_cast<float>(times[anchor])) / span, 0.0f, 1.0f) : 0.0f;
+                valid = IsWithinTolerance(TValue::Lerp(decoded[anchor], decoded[end], fraction), values[i], tolerance);
+            }
+
+            if (!valid)
+            {
+                anchor = end - 1;
+                kept.push_back(anchor);
+            }
+        }
+
+        if (keyCount > 1)
+            kept.push_back(keyCount - 1);
+
+        // A key time rounded to the quantized time domain can still resolve to the neighbouring segment,
+        // so sample every key through the decoder and keep or re-round the keys which miss the tolerance
+        std::vector<uint8_t> adjusted(keyCount, 0);
+        for (;;)
+        {
+            header.keyCount = static_cast<uint32_t>(kept.size());
+            data.resize(kept.size() * 4);
+
+            for (auto i = size_t(0); i < kept.size(); i++)
+            {
+                data[i] = times[kept[i]];
+                std::memcpy(data.data() + kept.size() + i * 3, encoded.data() + kept[i] * 3, 3 * sizeof(uint16_t));
+            }
+
+            const auto compressed = CreateTrack(header, data.data(), GetValueScale(static_cast<const TValue*>(nullptr)));
+
+            std::vector<size_t> missing;
+            auto moved = false;
+            auto cursor = 0u;
+            auto segment = size_t(0);
+
+            for (auto i = size_t(0); i < keyCount; i++)
+            {
+                while (segment + 1 < kept.size() && kept[segment + 1] <= i)
+                    segment++;
+
+                const auto value = SampleTrack(compressed, track.GetKeyTime(i), cursor, static_cast<const TValue*>(nullptr));
+                if (IsWithinTolerance(value, values[i], tolerance))
+                    continue;
+
+                if (kept[segment] != i)
+                {
+                    missing.push_back(i);
+                    continue;
+                }
+
+                // Move the key to the other side of its exact time, so that it's sampled in the segment without the jump
+                const auto rounded = static_cast<float>(times[i]);
+                const auto other = rounded > exactTimes[i] ? rounded - 1.0f : rounded < exactTimes[i] ? rounded + 1.0f : rounded;
+                const auto previous = segment > 0 ? static_cast<float>(times[kept[segment - 1]]) : -1.0f;
+                const auto next = segment + 1 < kept.size() ? static_cast<float>(times[kept[segment + 1]]) : static_cast<float>(TimeScale) + 1.0f;
+
+                if (adjusted[i] || other == rounded || other <= previous || other >= next)
+                    return false;
+
+                adjusted[i] = 1;
+                times[i] = static_cast<uint16_t>(other);
+                moved = true;
+            }
+
+            if (missing.empty() && !moved)
+                return true;
+
+            std::vector<size_t> merged;
+            merged.reserve(kept.size() + missing.size());
+            std::set_union(kept.begin(), kept.end(), missing.begin(), missing.end(), std::back_inserter(merged));
+            kept.swap(merged);
+        }
+    }
+
+    template<typename TValue>
+    static float GetTimeRange(const AnimationTrack<TValue>& track)
+    {
+        const auto keyCount = track.GetKeyCount();
+        const auto duration = track.GetKeyTime(keyCount - 1) - track.GetKeyTime(0);
+        if (!track.IsUniform() || keyCount < 2 || keyCount - 1 > TimeScale || duration <= 0.0f)
+            return duration;
+
+        // Stretch the range so that the uniformly spaced keys land exactly on the quantized times
+        const auto stepsPerKey = static_cast<uint32_t>(TimeScale / (keyCount - 1));
+        return duration * static_cast<float>(TimeScale) / static_cast<float>(stepsPerKey * (keyCount - 1));
+    }
+
+private:
+    std::vector<Track> m_tracks;
+    size_t m_vectorTrackCount = 0;
+};
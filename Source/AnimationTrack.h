@@ -0,0 +1,416 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "Cpu.h"
+#include "SimdKernels.h"
+#include "Vector3Base.h"
+#include "Quaternion.h"
+
+/// <summary>
+///     Keyframe track of Vector3Base&lt;float&gt; or Quaternion values.
+///     The key times are stored apart from the values, so locating a key only touches the time array.
+///     Uniformly sampled tracks store no times at all, their keys are located with a single multiplication.
+/// </summary>
+template<typename TValue>
+class AnimationTrack
+{
+public:
+    /// <summary>
+    ///     The number of floats per key value.
+    /// </summary>
+    static const size_t ComponentCount = sizeof(TValue) / sizeof(float);
+
+    /// <summary>
+    ///     True when the keys are rotations, which are interpolated along the shortest path and renormalized.
+    /// </summary>
+    static const bool IsRotation = std::is_same<TValue, Quaternion>::value;
+
+public:
+    AnimationTrack() = default;
+
+    /// <summary>
+    ///     Constructs a track with variable key times.
+    /// </summary>
+    /// <param name="times">The key times, in ascending order.</param>
+    /// <param name="values">The key values.</param>
+    /// <param name="keyCount">The key count, at least one.</param>
+    AnimationTrack(const float* times, const TValue* values, const size_t keyCount)
+    {
+        m_times.assign(times, times + keyCount);
+        m_startTime = times[0];
+        m_duration = times[keyCount - 1] - times[0];
+        SetValues(values, keyCount);
+    }
+
+    /// <summary>
+    ///     Constructs a uniformly sampled track.
+    /// </summary>
+    /// <param name="startTime">The time of the first key.</param>
+    /// <param name="sampleRate">The number of keys per second.</param>
+    /// <param name="values">The key values.</param>
+    /// <param name="keyCount">The key count, at least one.</param>
+    AnimationTrack(const float startTime, const float sampleRate, const TValue* values, const size_t keyCount)
+    {
+        m_startTime = startTime;
+        m_sampleRate = sampleRate;
+        m_duration = static_cast<float>(keyCount - 1) / sampleRate;
+        SetValues(values, keyCount);
+    }
+
+public:
+    /// <summary>
+    ///     Finds the key preceding the given time.
+    ///     Keys are searched linearly forward from the cursor first, which makes playing forward O(1),
+    ///     any other jump falls back to a binary search.
+    /// </summary>
+    /// <param name="time">The time, clamped to the track range.</param>
+    /// <param name="cursor">The key index found by the previous call, updated to the one found by this call.</param>
+    /// <param name="fraction">The position between the found key and the next one, in 0..1.</param>
+    /// <returns>The key index.</returns>
+    uint32_t FindKey(const float time, uint32_t& cursor, float& fraction) const
+    {
+        const auto lastKey = static_cast<uint32_t>(m_keyCount - 1);
+
+        if (lastKey == 0)
+        {
+            fraction = 0.0f;
+            return cursor = 0;
+        }
+
+        if (IsUniform())
+        {
+            const auto position = Math::Clamp(time - m_startTime, 0.0f, m_duration) * m_sampleRate;
+            const auto key = Math::Min(static_cast<uint32_t>(position), lastKey - 1);
+
+            fraction = Math::Min(position - static_cast<float>(key), 1.0f);
+            return cursor = key;
+        }
+
+        const auto keyTime = Math::Clamp(time, m_times[0], m_times[lastKey]);
+        auto key = Math::Min(cursor, lastKey - 1);
+
+        if (m_times[key] <= keyTime)
+        {
+            // Forward playback usually ends up in the same or the next few segments
+            auto steps = 0;
+            while (key + 1 < lastKey && m_times[key + 1] <= keyTime && steps++ < MaxLinearSteps)
+                key++;
+
+            if (key + 1 < lastKey && m_times[key + 1] <= keyTime)
+                key = Math::Min(FindKeyBinary(keyTime, key + 1, lastKey), lastKey - 1);
+        }
+        else
+        {
+            key = FindKeyBinary(keyTime, 0, key);
+        }
+
+        const auto span = m_times[key + 1] - m_times[key];
+        fraction = span > 0.0f ? (keyTime - m_times[key]) / span : 0.0f;
+        return cursor = key;
+    }
+
+    /// <summary>
+    ///     Samples the track.
+    /// </summary>
+    /// <param name="time">The time, clamped to the track range.</param>
+    /// <param name="cursor">The per-track cursor, see FindKey.</param>
+    TValue Sample(const float time, uint32_t& cursor) const
+    {
+        auto fraction = 0.0f;
+        const auto key = FindKey(time, cursor, fraction);
+        const auto next = Math::Min(key + 1, static_cast<uint32_t>(m_keyCount - 1));
+
+        return Interpolate(GetValue(key), GetValue(next), fraction);
+    }
+
+    /// <summary>
+    ///     Samples the track without a cursor, the key is found using a binary search.
+    /// </summary>
+    TValue Sample(const float time) const
+    {
+        auto cursor = 0u;
+        return Sample(time, cursor);
+    }
+
+    /// <summary>
+    ///     Interpolates two key values, Vector3Base::Lerp or Quaternion::Lerp (shortest path, normalized).
+    /// </summary>
+    static TValue Interpolate(const TValue& from, const TValue& to, const float amount)
+    {
+        return TValue::Lerp(from, to, amount);
+    }
+
+public:
+    TValue GetValue(const size_t key) const
+    {
+        TValue value;
+        for (auto i = size_t(0); i < ComponentCount; i++)
+            value[i] = m_values[key * ComponentCount + i];
+        return value;
+    }
+
+    /// <summary>
+    ///     Returns the raw key values, ComponentCount floats per key.
+    /// </summary>
+    const float* GetValues() const
+    {
+        return m_values.data();
+    }
+
+    float GetKeyTime(const size_t key) const
+    {
+        return IsUniform() ? m_startTime + static_cast<float>(key) / m_sampleRate : m_times[key];
+    }
+
+    size_t GetKeyCount() const
+    {
+        return m_keyCount;
+    }
+
+    float GetStartTime() const
+    {
+        return m_startTime;
+    }
+
+    float GetDuration() const
+    {
+        return m_duration;
+    }
+
+    bool IsUniform() const
+    {
+        return m_sampleRate > 0.0f;
+    }
+
+private:
+    static const int MaxLinearSteps = 4;
+
+    void SetValues(const TValue* values, const size_t keyCount)
+    {
+        m_keyCount = keyCount;
+        m_values.resize(keyCount * ComponentCount);
+
+        for (auto key = size_t(0); key < keyCount; key++)
+        {
+            for (auto i = size_t(0); i < ComponentCount; i++)
+                m_values[key * ComponentCount + i] = values[key][i];
+        }
+    }
+
+    uint32_t FindKeyBinary(const float time, const uint32_t first, const uint32_t last) const
+    {
+        // The last key not greater than the time, within [first, last]
+        const auto found = std::upper_bound(m_times.data() + first, m_times.data() + last + 1, time);
+        return static_cast<uint32_t>(found - m_times.data()) - 1;
+    }
+
+private:
+    std::vector<float> m_times;
+    std::vector<float> m_values;
+    size_t m_keyCount = 0;
+    float m_startTime = 0.0f;
+    float m_duration = 0.0f;
+    float m_sampleRate = 0.0f;
+};
+
+/// <summary>
+///     Samples many tracks at once and keeps a key cursor for every one of them.
+///     The keys of a block of tracks are located and gathered first, then all of the block is interpolated
+///     in a single component-major pass, which is vectorized with SSE2 when available.
+/// </summary>
+template<typename TValue>
+class AnimationSampler
+{
+private:
+    using Track = AnimationTrack<TValue>;
+
+    static const size_t ComponentCount = Track::ComponentCount;
+    static const size_t BlockSize = 64;
+
+    struct Block
+    {
+        float from[ComponentCount][BlockSize];
+        float to[ComponentCount][BlockSize];
+        float result[ComponentCount][BlockSize];
+        float fraction[BlockSize];
+    };
+
+public:
+    /// <summary>
+    ///     Constructs a sampler for the given number of tracks.
+    /// </summary>
+    explicit AnimationSampler(const size_t trackCount = 0)
+    {
+        m_cursors.resize(trackCount, 0u);
+        m_useSSE2 = Cpu::GetSimdLevel() >= SimdLevel::SSE2;
+    }
+
+public:
+    /// <summary>
+    ///     Samples an array of tracks at the same time.
+    /// </summary>
+    /// <param name="tracks">The tracks, the same ones (in the same order) for every call, otherwise call Reset.</param>
+    /// <param name="trackCount">The track count.</param>
+    /// <param name="time">The time.</param>
+    /// <param name="output">The output values, one per track.</param>
+    void Sample(const Track* tracks, const size_t trackCount, const float time, TValue* output)
+    {
+        if (m_cursors.size() < trackCount)
+            m_cursors.resize(trackCount, 0u);
+
+        Block block;
+
+        for (auto first = size_t(0); first < trackCount; first += BlockSize)
+        {
+            const auto count = Math::Min(BlockSize, trackCount - first);
+
+            // Locate the keys and gather their values
+            for (auto i = size_t(0); i < count; i++)
+            {
+                const auto& track = tracks[first + i];
+                const auto key = track.FindKey(time, m_cursors[first + i], block.fraction[i]);
+                const auto next = Math::Min(key + 1, static_cast<uint32_t>(track.GetKeyCount() - 1));
+                const auto from = track.GetValues() + key * ComponentCount;
+                const auto to = track.GetValues() + next * ComponentCount;
+
+                for (auto c = size_t(0); c < ComponentCount; c++)
+                {
+                    block.from[c][i] = from[c];
+                    block.to[c][i] = to[c];
+                }
+            }
+
+            // Pad the block to whole SIMD lanes
+            const auto laneCount = (count + 3) & ~size_t(3);
+            for (auto i = count; i < laneCount; i++)
+            {
+                block.fraction[i] = 0.0f;
+                for (auto c = size_t(0); c < ComponentCount; c++)
+                    block.from[c][i] = block.to[c][i] = Track::IsRotation && c == 3 ? 1.0f : 0.0f;
+            }
+
+#if SIMD_X86
+            if (m_useSSE2)
+                InterpolateSSE2(block, laneCount);
+            else
+#endif
+                InterpolateScalar(block, count);
+
+            for (auto i = size_t(0); i < count; i++)
+            {
+                auto& value = output[first + i];
+                for (auto c = size_t(0); c < ComponentCount; c++)
+                    value[c] = block.result[c][i];
+            }
+        }
+    }
+
+    /// <summary>
+    ///     Resets all of the cursors, needed when the sampled tracks change.
+    /// </summary>
+    void Reset()
+    {
+        std::fill(m_cursors.begin(), m_cursors.end(), 0u);
+    }
+
+private:
+    static void InterpolateScalar(Block& block, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto amount = block.fraction[i];
+            auto sign = 1.0f;
+
+            if (Track::IsRotation)
+            {
+                auto dot = 0.0f;
+                for (auto c = size_t(0); c < ComponentCount; c++)
+                    dot += block.from[c][i] * block.to[c][i];
+                sign = dot < 0.0f ? -1.0f : 1.0f;
+            }
+
+            auto lengthSquared = 0.0f;
+            for (auto c = size_t(0); c < ComponentCount; c++)
+            {
+                const auto value = (1.0f - amount) * block.from[c][i] + amount * sign * block.to[c][i];
+                block.result[c][i] = value;
+                lengthSquared += value * value;
+            }
+
+            if (Track::IsRotation && lengthSquared > 0.0f)
+            {
+                const auto inverseLength = 1.0f / Math::Sqrt(lengthSquared);
+                for (auto c = size_t(0); c < ComponentCount; c++)
+                    block.result[c][i] *= inverseLength;
+            }
+        }
+    }
+
+#if SIMD_X86
+    SIMD_TARGET_SSE2 static void InterpolateSSE2(Block& block, const size_t laneCount)
+    {
+        const auto zero = _mm_setzero_ps();
+        const auto one = _mm_set1_ps(1.0f);
+        const auto signMask = _mm_set1_ps(-0.0f);
+
+        for (auto i = size_t(0); i < laneCount; i += 4)
+        {
+            const auto amount = _mm_loadu_ps(block.fraction + i);
+            const auto inverse = _mm_sub_ps(one, amount);
+
+            __m128 from[ComponentCount];
+            __m128 to[ComponentCount];
+            for (auto c = size_t(0); c < ComponentCount; c++)
+            {
+                from[c] = _mm_loadu_ps(block.from[c] + i);
+                to[c] = _mm_loadu_ps(block.to[c] + i);
+            }
+
+            if (Track::IsRotation)
+            {
+                // Flip the target to the same hemisphere. Compared as in the scalar path, the sign bit of the
+                // dot product itself would also flip for -0 and negative NaNs
+                auto dot = _mm_mul_ps(from[0], to[0]);
+                for (auto c = size_t(1); c < ComponentCount; c++)
+                    dot = _mm_add_ps(dot, _mm_mul_ps(from[c], to[c]));
+
+                const auto sign = _mm_and_ps(_mm_cmplt_ps(dot, zero), signMask);
+                for (auto c = size_t(0); c < ComponentCount; c++)
+                    to[c] = _mm_xor_ps(to[c], sign);
+            }
+
+            __m128 result[ComponentCount];
+            auto lengthSquared = zero;
+            for (auto c = size_t(0); c < ComponentCount; c++)
+            {
+                result[c] = _mm_add_ps(_mm_mul_ps(inverse, from[c]), _mm_mul_ps(amount, to[c]));
+                lengthSquared = _mm_add_ps(lengthSquared, _mm_mul_ps(result[c], result[c]));
+            }
+
+            if (Track::IsRotation)
+            {
+                // Zero length results are kept as they are, like in the scalar path
+                const auto valid = _mm_cmpgt_ps(lengthSquared, zero);
+                const auto inverseLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+                for (auto c = size_t(0); c < ComponentCount; c++)
+                    result[c] = _mm_or_ps(_mm_and_ps(valid, _mm_mul_ps(result[c], inverseLength)), _mm_andnot_ps(valid, result[c]));
+            }
+
+            for (auto c = size_t(0); c < ComponentCount; c++)
+                _mm_storeu_ps(block.result[c] + i, result[c]);
+        }
+    }
+#endif
+
+private:
+    std::vector<uint32_t> m_cursors;
+    bool m_useSSE2 = false;
+};
@@ -0,0 +1,556 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "Config.h"
+#include "Vector2Base.h"
+#include "Vector3Base.h"
+#include "Vector4Base.h"
+#include "Quaternion.h"
+#include "Matrix4x4Base.h"
+#include "BoundingBoxBase.h"
+#include "BoundingSphereBase.h"
+#include "ColorBase.h"
+#include "MappedFile.h"
+
+/// <summary>
+///     The element types stored in an array archive, checked when a section is read back.
+/// </summary>
+enum class ArrayElementType : uint32_t
+{
+    Raw,
+    Float,
+    Double,
+    UInt32,
+    Vector2F,
+    Vector3F,
+    Vector4F,
+    Vector2D,
+    Vector3D,
+    Vector4D,
+    Quaternion,
+    Matrix4x4F,
+    Matrix4x4D,
+    BoundingBoxF,
+    BoundingBoxD,
+    BoundingSphereF,
+    BoundingSphereD,
+    ColorF
+};
+
+/// <summary>
+///     Maps a C++ type to its archive element type, any other plain data type is stored as Raw.
+/// </summary>
+template<typename T> struct ArrayElementTraits { static constexpr ArrayElementType Type = ArrayElementType::Raw; };
+template<> struct ArrayElementTraits<float> { static constexpr ArrayElementType Type = ArrayElementType::Float; };
+template<> struct ArrayElementTraits<double> { static constexpr ArrayElementType Type = ArrayElementType::Double; };
+template<> struct ArrayElementTraits<uint32_t> { static constexpr ArrayElementType Type = ArrayElementType::UInt32; };
+template<> struct ArrayElementTraits<Vector2Base<float>> { static constexpr ArrayElementType Type = ArrayElementType::Vector2F; };
+template<> struct ArrayElementTraits<Vector3Base<float>> { static constexpr ArrayElementType Type = ArrayElementType::Vector3F; };
+template<> struct ArrayElementTraits<Vector4Base<float>> { static constexpr ArrayElementType Type = ArrayElementType::Vector4F; };
+template<> struct ArrayElementTraits<Vector2Base<double>> { static constexpr ArrayElementType Type = ArrayElementType::Vector2D; };
+template<> struct ArrayElementTraits<Vector3Base<double>> { static constexpr ArrayElementType Type = ArrayElementType::Vector3D; };
+template<> struct ArrayElementTraits<Vector4Base<double>> { static constexpr ArrayElementType Type = ArrayElementType::Vector4D; };
+template<> struct ArrayElementTraits<Quaternion> { static constexpr ArrayElementType Type = ArrayElementType::Quaternion; };
+template<> struct ArrayElementTraits<Matrix4x4Base<float>> { static constexpr ArrayElementType Type = ArrayElementType::Matrix4x4F; };
+template<> struct ArrayElementTraits<Matrix4x4Base<double>> { static constexpr ArrayElementType Type = ArrayElementType::Matrix4x4D; };
+template<> struct ArrayElementTraits<BoundingBoxBase<float>> { static constexpr ArrayElementType Type = ArrayElementType::BoundingBoxF; };
+template<> struct ArrayElementTraits<BoundingBoxBase<double>> { static constexpr ArrayElementType Type = ArrayElementType::BoundingBoxD; };
+template<> struct ArrayElementTraits<BoundingSphereBase<float>> { static constexpr ArrayElementType Type = ArrayElementType::BoundingSphereF; };
+template<> struct ArrayElementTraits<BoundingSphereBase<double>> { static constexpr ArrayElementType Type = ArrayElementType::BoundingSphereD; };
+template<> struct ArrayElementTraits<ColorBase<float>> { static constexpr ArrayElementType Type = ArrayElementType::ColorF; };
+
+/// <summary>
+///     Read-only view of a contiguous array, e.g. a section of a mapped archive.
+/// </summary>
+template<typename T>
+struct ArraySpan
+{
+    const T* data = nullptr;
+    size_t count = 0;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T& operator[](const size_t index) const { return data[index]; }
+};
+
+/// <summary>
+///     Binary container format for arrays of math types.
+///     The file is a header, a table of section headers and the section data. Every section starts at a multiple
+///     of Alignment bytes from the file start, so a mapped file (mappings are page aligned) can be used in place.
+///     The data is stored in the native in-memory layout, archives are only portable between little-endian
+///     platforms using the same precision and component layout.
+/// </summary>
+class ArrayArchive
+{
+public:
+    static const uint32_t Magic = 0x41414D56u; // "VMAA"
+    static const uint32_t Version = 1;
+    static const size_t Alignment = 64;
+    static const size_t MaxNameLength = 31;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t sectionCount;
+        uint32_t sectionTableChecksum;
+        uint64_t fileSize;
+        uint64_t reserved;
+    };
+
+    struct SectionHeader
+    {
+        char name[MaxNameLength + 1];
+        uint32_t type;
+        uint32_t elementSize;
+        uint64_t count;
+        uint64_t offset;
+        uint32_t checksum;
+        uint32_t reserved;
+    };
+
+public:
+    /// <summary>
+    ///     Calculates the CRC-32C of the given data, 8 bytes per step (slicing-by-8).
+    /// </summary>
+    static uint32_t Checksum(const void* data, const size_t size, const uint32_t previous = 0)
+    {
+        const auto& table = GetChecksumTable();
+        auto bytes = static_cast<const uint8_t*>(data);
+        auto crc = ~previous;
+        auto remaining = size;
+
+        for (; remaining >= 8; remaining -= 8, bytes += 8)
+        {
+            uint32_t low, high;
+            std::memcpy(&low, bytes, sizeof(uint32_t));
+            std::memcpy(&high, bytes + 4, sizeof(uint32_t));
+            low ^= crc;
+
+            crc = table[7][low & 0xFFu] ^ table[6][(low >> 8) & 0xFFu] ^ table[5][(low >> 16) & 0xFFu] ^ table[4][low >> 24] ^
+                table[3][high & 0xFFu] ^ table[2][(high >> 8) & 0xFFu] ^ table[1][(high >> 16) & 0xFFu] ^ table[0][high >> 24];
+        }
+
+        for (; remaining > 0; remaining--, bytes++)
+            crc = table[0][(crc ^ *bytes) & 0xFFu] ^ (crc >> 8);
+
+        return ~crc;
+    }
+
+    static size_t AlignOffset(const size_t offset)
+    {
+        return (offset + Alignment - 1) & ~(Alignment - 1);
+    }
+
+private:
+    using ChecksumTable = uint32_t[8][256];
+
+    static const ChecksumTable& GetChecksumTable()
+    {
+        struct Table
+        {
+            ChecksumTable values;
+
+            Table()
+            {
+                for (auto i = 0u; i < 256; i++)
+                {
+                    auto crc = i;
+                    for (auto bit = 0; bit < 8; bit++)
+                        crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+                    values[0][i] = crc;
+                }
+
+                for (auto i = 0u; i < 256; i++)
+                {
+                    for (auto slice = 1; slice < 8; slice++)
+                        values[slice][i] = (values[slice - 1][i] >> 8) ^ values[0][values[slice - 1][i] & 0xFFu];
+                }
+            }
+        };
+
+        static const Table table;
+        return table.values;
+    }
+};
+
+/// <summary>
+///     Collects arrays and writes them as an archive.
+///     The arrays are not copied, they have to stay valid until the archive is written.
+/// </summary>
+class ArrayArchiveWriter
+{
+public:
+    /// <summary>
+    ///     Adds a named array, the name has to be unique and at most ArrayArchive::MaxNameLength characters long.
+    /// </summary>
+    /// <returns>False when the name is invalid or already used.</returns>
+    template<typename T>
+    bool Add(const char* name, const T* data, const size_t count)
+    {
+        // The math types define their own copy operations, plain data is approximated by standard layout without pointers
+        static_assert(std::is_standard_layout<T>::value && !std::is_pointer<T>::value, "Archived elements have to be plain data");
+        static_assert(alignof(T) <= ArrayArchive::Alignment, "Archived elements cannot be aligned to more than ArrayArchive::Alignment");
+
+        const auto nameLength = name != nullptr ? std::strlen(name) : 0;
+        if (nameLength == 0 || nameLength > ArrayArchive::MaxNameLength || Find(name) != nullptr || (data == nullptr && count > 0))
+            return false;
+
+        Section section = {};
+        std::memcpy(section.header.name, name, nameLength);
+        section.header.type = static_cast<uint32_t>(ArrayElementTraits<T>::Type);
+        section.header.elementSize = static_cast<uint32_t>(sizeof(T));
+        section.header.count = count;
+        section.data = data;
+        m_sections.push_back(section);
+        return true;
+    }
+
+    template<typename T>
+    bool Add(const char* name, const std::vector<T>& values)
+    {
+        return Add(name, values.data(), values.size());
+    }
+
+    /// <summary>
+    ///     Returns the size of the archive in bytes.
+    /// </summary>
+    size_t GetSize() const
+    {
+        auto size = ArrayArchive::AlignOffset(sizeof(ArrayArchive::Header) + m_sections.size() * sizeof(ArrayArchive::SectionHeader));
+        for (const auto& section : m_sections)
+            size = ArrayArchive::AlignOffset(size + GetByteSize(section));
+        return size;
+    }
+
+    /// <summary>
+    ///     Writes the archive to a file.
+    /// </summary>
+    /// <returns>False when the file could not be written.</returns>
+    bool Write(const char* path) const
+    {
+        auto file = std::fopen(path, "wb");
+        if (file == nullptr)
+            return false;
+
+        auto result = WriteTo(file);
+        result &= std::fclose(file) == 0;
+        return result;
+    }
+
+    /// <summary>
+    ///     Writes the archive to memory, e.g. for packing into another file.
+    /// </summary>
+    std::vector<uint8_t> Serialize() const
+    {
+        std::vector<uint8_t> data(GetSize(), 0);
+        std::vector<size_t> offsets;
+        const auto headers = BuildHeaders(offsets);
+        std::memcpy(data.data(), headers.data(), headers.size());
+
+        for (auto i = size_t(0); i < m_sections.size(); i++)
+        {
+            const auto size = GetByteSize(m_sections[i]);
+            if (size > 0)
+                std::memcpy(data.data() + offsets[i], m_sections[i].data, size);
+        }
+
+        return data;
+    }
+
+private:
+    struct Section
+    {
+        ArrayArchive::SectionHeader header;
+        const void* data;
+    };
+
+    const Section* Find(const char* name) const
+    {
+        for (const auto& section : m_sections)
+        {
+            if (std::strncmp(section.header.name, name, sizeof(section.header.name)) == 0)
+                return &section;
+        }
+
+        return nullptr;
+    }
+
+    static size_t GetByteSize(const Section& section)
+    {
+        return static_cast<size_t>(section.header.count) * section.header.elementSize;
+    }
+
+    /// <summary>
+    ///     Builds the header and the section table (padded to the first section), checksumming all of the sections.
+    /// </summary>
+    std::vector<uint8_t> BuildHeaders(std::vector<size_t>& offsets) const
+    {
+        const auto tableSize = m_sections.size() * sizeof(ArrayArchive::SectionHeader);
+        std::vector<uint8_t> headers(ArrayArchive::AlignOffset(sizeof(ArrayArchive::Header) + tableSize), 0);
+
+        offsets.resize(m_sections.size());
+        auto offset = headers.size();
+        for (auto i = size_t(0); i < m_sections.size(); i++)
+        {
+            auto sectionHeader = m_sections[i].header;
+            const auto size = GetByteSize(m_sections[i]);
+            sectionHeader.offset = offset;
+            sectionHeader.checksum = ArrayArchive::Checksum(m_sections[i].data, size);
+            std::memcpy(headers.data() + sizeof(ArrayArchive::Header) + i * sizeof(ArrayArchive::SectionHeader), &sectionHeader, sizeof(sectionHeader));
+
+            offsets[i] = offset;
+            offset = ArrayArchive::AlignOffset(offset + size);
+        }
+
+        ArrayArchive::Header header = {};
+        header.magic = ArrayArchive::Magic;
+        header.version = ArrayArchive::Version;
+        header.sectionCount = static_cast<uint32_t>(m_sections.size());
+        header.sectionTableChecksum = ArrayArchive::Checksum(headers.data() + sizeof(ArrayArchive::Header), tableSize);
+        header.fileSize = offset;
+        std::memcpy(headers.data(), &header, sizeof(header));
+        return headers;
+    }
+
+    bool WriteTo(FILE* file) const
+    {
+        static const uint8_t padding[ArrayArchive::Alignment] = {};
+
+        std::vector<size_t> offsets;
+        const auto headers = BuildHeaders(offsets);
+        if (std::fwrite(headers.data(), 1, headers.size(), file) != headers.size())
+            return false;
+
+        // Every section is written straight from the source array, only the padding is added
+        for (const auto& section : m_sections)
+        {
+            const auto size = GetByteSize(section);
+            const auto paddingSize = ArrayArchive::AlignOffset(size) - size;
+
+            if (size > 0 && std::fwrite(section.data, 1, size, file) != size)
+                return false;
+            if (paddingSize > 0 && std::fwrite(padding, 1, paddingSize, file) != paddingSize)
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    std::vector<Section> m_sections;
+};
+
+/// <summary>
+///     Reads an archive in place, from a memory-mapped file or from memory.
+///     Open only validates the header and the section table, the data of a section is checksummed
+///     the first time it is accessed, so sections which are never used are never touched.
+///     The spans point into the mapping and are valid until the reader is closed or destroyed.
+/// </summary>
+class ArrayArchiveReader
+{
+public:
+    ArrayArchiveReader() = default;
+
+    ~ArrayArchiveReader()
+    {
+        Close();
+    }
+
+    ArrayArchiveReader(const ArrayArchiveReader&) = delete;
+    ArrayArchiveReader& operator=(const ArrayArchiveReader&) = delete;
+
+public:
+    /// <summary>
+    ///     Maps an archive file into memory.
+    /// </summary>
+    /// <returns>False when the file cannot be mapped or is not a valid archive.</returns>
+    bool Open(const char* path)
+    {
+        Close();
+
+        if (!m_file.Open(path))
+            return false;
+
+        if (!Attach(m_file.GetData(), m_file.GetSize()))
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    ///     Reads an archive from memory, the data is not copied and has to outlive the reader.
+    ///     The data has to be aligned to at least the alignment of the largest archived element type.
+    /// </summary>
+    /// <returns>False when the data is not a valid archive.</returns>
+    bool Open(const uint8_t* data, const size_t size)
+    {
+        Close();
+        return Attach(data, size);
+    }
+
+    void Close()
+    {
+        m_file.Close();
+        m_data = nullptr;
+        m_sections.clear();
+        m_sectionStates.clear();
+    }
+
+public:
+    bool IsOpen() const
+    {
+        return m_data != nullptr;
+    }
+
+    size_t GetSectionCount() const
+    {
+        return m_sections.size();
+    }
+
+    const ArrayArchive::SectionHeader& GetSection(const size_t index) const
+    {
+        return m_sections[index];
+    }
+
+    /// <summary>
+    ///     Returns the index of the section with the given name or -1.
+    /// </summary>
+    int FindSection(const char* name) const
+    {
+        for (auto i = size_t(0); i < m_sections.size(); i++)
+        {
+            if (std::strncmp(m_sections[i].name, name, sizeof(m_sections[i].name)) == 0)
+                return static_cast<int>(i);
+        }
+
+        return -1;
+    }
+
+    /// <summary>
+    ///     Checks the checksum of a section, the result is cached.
+    ///     Safe to call from multiple threads, concurrent first calls for a section compute the same result.
+    /// </summary>
+    bool Verify(const size_t index) const
+    {
+        auto& state = m_sectionStates[index];
+        auto value = static_cast<SectionState>(state.load(std::memory_order_relaxed));
+        if (value == SectionState::Unverified)
+        {
+            const auto& section = m_sections[index];
+            const auto size = static_cast<size_t>(section.count) * section.elementSize;
+            value = ArrayArchive::Checksum(m_data + section.offset, size) == section.checksum ? SectionState::Valid : SectionState::Corrupted;
+            state.store(static_cast<uint8_t>(value), std::memory_order_relaxed);
+        }
+
+        return value == SectionState::Valid;
+    }
+
+    /// <summary>
+    ///     Checks the checksums of all sections, e.g. when loading content from an untrusted source.
+    /// </summary>
+    bool VerifyAll() const
+    {
+        auto result = true;
+        for (auto i = size_t(0); i < m_sections.size(); i++)
+            result &= Verify(i);
+        return result;
+    }
+
+    /// <summary>
+    ///     Returns a section as a typed span pointing into the archive.
+    /// </summary>
+    /// <param name="name">The section name.</param>
+    /// <param name="verify">When true, the checksum of the section is checked on first access.</param>
+    /// <returns>
+    ///     An empty span when there is no such section, the element type does not match or the checksum does not match.
+    /// </returns>
+    template<typename T>
+    ArraySpan<T> Get(const char* name, const bool verify = true) const
+    {
+        const auto index = FindSection(name);
+        return index >= 0 ? Get<T>(static_cast<size_t>(index), verify) : ArraySpan<T>();
+    }
+
+    template<typename T>
+    ArraySpan<T> Get(const size_t index, const bool verify = true) const
+    {
+        const auto& section = m_sections[index];
+        if (section.type != static_cast<uint32_t>(ArrayElementTraits<T>::Type) || section.elementSize != sizeof(T))
+            return ArraySpan<T>();
+
+        const auto data = m_data + section.offset;
+        if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0 || (verify && !Verify(index)))
+            return ArraySpan<T>();
+
+        ArraySpan<T> span;
+        span.data = reinterpret_cast<const T*>(data);
+        span.count = static_cast<size_t>(section.count);
+        return span;
+    }
+
+private:
+    enum class SectionState : uint8_t
+    {
+        Unverified,
+        Valid,
+        Corrupted
+    };
+
+    bool Attach(const uint8_t* data, const size_t size)
+    {
+        ArrayArchive::Header header;
+        if (data == nullptr || size < sizeof(header))
+            return false;
+
+        std::memcpy(&header, data, sizeof(header));
+        const auto tableSize = size_t(header.sectionCount) * sizeof(ArrayArchive::SectionHeader);
+
+        if (header.magic != ArrayArchive::Magic || header.version != ArrayArchive::Version || header.fileSize > size ||
+            tableSize > size - sizeof(header) || ArrayArchive::Checksum(data + sizeof(header), tableSize) != header.sectionTableChecksum)
+            return false;
+
+        m_sections.resize(header.sectionCount);
+        if (tableSize > 0)
+            std::memcpy(m_sections.data(), data + sizeof(header), tableSize);
+
+        for (const auto& section : m_sections)
+        {
+            // The byte size is computed in 64 bits, a corrupted count cannot wrap around
+            const auto byteSize = section.elementSize > 0 && section.count > UINT64_MAX / section.elementSize ? UINT64_MAX : section.count * section.elementSize;
+            if (section.name[ArrayArchive::MaxNameLength] != '\0' || section.offset % ArrayArchive::Alignment != 0 ||
+                section.offset > header.fileSize || byteSize > header.fileSize - section.offset)
+            {
+                m_sections.clear();
+                return false;
+            }
+        }
+
+        m_data = data;
+        m_sectionStates = std::vector<std::atomic<uint8_t>>(m_sections.size());
+        for (auto& state : m_sectionStates)
+            state.store(static_cast<uint8_t>(SectionState::Unverified), std::memory_order_relaxed);
+
+        return true;
+    }
+
+private:
+    MappedFile m_file;
+    const uint8_t* m_data = nullptr;
+
+    std::vector<ArrayArchive::SectionHeader> m_sections;
+    mutable std::vector<std::atomic<uint8_t>> m_sectionStates; // SectionState, written by the const Verify
+};
@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+
 template<typename T>
 struct BoundingBoxBase
 {
@@ -92,6 +96,77 @@ public:
         return center - size * 0.5f;
     }
 
+    /// <summary>
+    /// Creates the smallest BoundingBox containing all of the given points
+    /// </summary>
+    static BoundingBoxBase<T> FromPoints(const Vector3Base<T>* points, const size_t count)
+    {
+        if (count == 0)
+            return BoundingBoxBase<T>();
+
+        // The points are reduced as a flat stream of components, 4 points (12 components) per iteration.
+        // The independent per-lane minimums and maximums are vectorized by the compiler, lane j accumulates
+        // component j % 3 and the lanes are folded at the end.
+        const auto values = &points[0].x;
+        const auto blockCount = count / 4;
+
+        T minimum[12];
+        T maximum[12];
+        for (auto j = 0; j < 12; j++)
+            minimum[j] = maximum[j] = values[j % 3];
+
+        for (auto block = size_t(0); block < blockCount; block++)
+        {
+            const auto blockValues = values + block * 12;
+
+            for (auto j = 0; j < 12; j++)
+            {
+                minimum[j] = Math::Min(minimum[j], blockValues[j]);
+                maximum[j] = Math::Max(maximum[j], blockValues[j]);
+            }
+        }
+
+        for (auto i = blockCount * 4; i < count; i++)
+        {
+            for (auto j = 0; j < 3; j++)
+            {
+                minimum[j] = Math::Min(minimum[j], points[i][j]);
+                maximum[j] = Math::Max(maximum[j], points[i][j]);
+            }
+        }
+
+        for (auto j = 3; j < 12; j++)
+        {
+            minimum[j % 3] = Math::Min(minimum[j % 3], minimum[j]);
+            maximum[j % 3] = Math::Max(maximum[j % 3], maximum[j]);
+        }
+
+        return FromMinMax(Vector3Base<T>(minimum[0], minimum[1], minimum[2]), Vector3Base<T>(maximum[0], maximum[1], maximum[2]));
+    }
+
+    /// <summary>
+    /// Creates a BoundingBox from its minimum and maximum
+    /// </summary>
+    static BoundingBoxBase<T> FromMinMax(const Vector3Base<T>& minimum, const Vector3Base<T>& maximum)
+    {
+        return BoundingBoxBase<T>((minimum + maximum) * T(0.5), maximum - minimum);
+    }
+
+    /// <summary>
+    /// Creates the smallest BoundingBox containing both of the given boxes
+    /// </summary>
+    static BoundingBoxBase<T> Merge(const BoundingBoxBase<T>& a, const BoundingBoxBase<T>& b)
+    {
+        const auto amin = a.Minimum();
+        const auto bmin = b.Minimum();
+        const auto amax = a.Maximum();
+        const auto bmax = b.Maximum();
+
+        return FromMinMax(
+            Vector3Base<T>(Math::Min(amin.x, bmin.x), Math::Min(amin.y, bmin.y), Math::Min(amin.z, bmin.z)),
+            Vector3Base<T>(Math::Max(amax.x, bmax.x), Math::Max(amax.y, bmax.y), Math::Max(amax.z, bmax.z)));
+    }
+
     /// <summary>
     /// Check if two BoundingBoxes intersect each other
     /// </summary>
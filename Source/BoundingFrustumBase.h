@@ -2,11 +2,21 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "Config.h"
 #include "Vector3Base.h"
 #include "PlaneBase.h"
 #include "BoundingBoxBase.h"
 #include "BoundingSphereBase.h"
+#include "OrientedBoundingBoxBase.h"
+
+enum class ContainmentType
+{
+    Disjoint,
+    Contains,
+    Intersects
+};
 
 template<typename T>
 struct BoundingFrustumBase
@@ -71,6 +81,109 @@ public:
         }
     }
 
+    /// <summary>
+    ///     Returns one of the 6 planes related to this frustum.
+    /// </summary>
+    /// <param name="index">Plane index where 0 fro Left, 1 for Right, 2 for Top, 3 for Bottom, 4 for Near, 5 for Far</param>
+    /// <returns>The plane.</returns>
+    const PlaneBase<T>& GetPlane(const int index) const
+    {
+        return const_cast<BoundingFrustumBase<T>*>(this)->GetPlane(index);
+    }
+
+    /// <summary>
+    ///     Classifies the bounding box against the frustum.
+    /// </summary>
+    /// <param name="box">The bounding box.</param>
+    /// <returns>Disjoint when outside, Contains when fully inside, otherwise Intersects.</returns>
+    ContainmentType Classify(const BoundingBoxBase<T>& box) const
+    {
+        auto planeMask = 0x3Fu;
+        return Classify(box, &planeMask);
+    }
+
+    /// <summary>
+    ///     Classifies the bounding box against the planes selected by the mask (bit i for GetPlane(i)).
+    ///     The bits of the planes that fully contain the box are cleared, so hierarchical queries can pass
+    ///     the mask down and skip those planes for the children.
+    /// </summary>
+    /// <param name="box">The bounding box.</param>
+    /// <param name="planeMask">The plane mask, updated on return.</param>
+    /// <returns>Disjoint when outside, Contains when fully inside of all masked planes, otherwise Intersects.</returns>
+    ContainmentType Classify(const BoundingBoxBase<T>& box, uint32_t* planeMask) const
+    {
+        const auto extents = box.size * T(0.5);
+
+        for (auto i = 0; i < 6; i++)
+        {
+            const auto bit = 1u << i;
+            if ((*planeMask & bit) == 0)
+                continue;
+
+            const auto& plane = GetPlane(i);
+            const auto distance = Vector3Base<T>::Dot(plane.normal, box.center) + plane.distance;
+            const auto radius = Math::Abs(plane.normal.x) * extents.x
+                + Math::Abs(plane.normal.y) * extents.y
+                + Math::Abs(plane.normal.z) * extents.z;
+
+            if (distance < -radius)
+                return ContainmentType::Disjoint;
+
+            if (distance >= radius)
+                *planeMask &= ~bit;
+        }
+
+        return *planeMask == 0 ? ContainmentType::Contains : ContainmentType::Intersects;
+    }
+
+    /// <summary>
+    ///     Classifies the bounding sphere against the frustum.
+    /// </summary>
+    /// <param name="sphere">The bounding sphere.</param>
+    /// <returns>Disjoint when outside, Contains when fully inside, otherwise Intersects.</returns>
+    ContainmentType Classify(const BoundingSphereBase<T>& sphere) const
+    {
+        auto result = ContainmentType::Contains;
+
+        for (auto i = 0; i < 6; i++)
+        {
+            const auto distance = GetPlane(i).Dot(sphere.center);
+
+            if (distance < -sphere.radius)
+                return ContainmentType::Disjoint;
+
+            if (distance < sphere.radius)
+                result = ContainmentType::Intersects;
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    ///     Classifies the oriented bounding box against the frustum.
+    /// </summary>
+    /// <param name="box">The oriented bounding box.</param>
+    /// <returns>Disjoint when outside, Contains when fully inside, otherwise Intersects.</returns>
+    ContainmentType Classify(const OrientedBoundingBoxBase<T>& box) const
+    {
+        auto result = ContainmentType::Contains;
+
+        for (auto i = 0; i < 6; i++)
+        {
+            const auto& plane = GetPlane(i);
+            const auto distance = plane.Dot(box.center);
+            const auto radius = box.GetProjectedRadius(plane.normal);
+
+            if (distance < -radius)
+                return ContainmentType::Disjoint;
+
+            if (distance < radius)
+                result = ContainmentType::Intersects;
+        }
+
+        return result;
+    }
+
     /// <summary>
     ///     Checks if the bounding frustum contains the bounding box.
     /// </summary>
@@ -123,6 +236,86 @@ public:
         return false;
     }
 
+    /// <summary>
+    ///     Culls an array of bounding boxes against the frustum.
+    /// </summary>
+    /// <param name="boxes">The bounding boxes.</param>
+    /// <param name="count">The bounding box count.</param>
+    /// <param name="visibleIndices">The output indices of the visible boxes, has to have room for count indices.</param>
+    /// <param name="firstIndex">The value added to the reported indices, used when culling a sub-range.</param>
+    /// <returns>The visible box count.</returns>
+    size_t Cull(const BoundingBoxBase<T>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0) const
+    {
+        auto visibleCount = size_t(0);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i);
+            visibleCount += Classify(boxes[i]) != ContainmentType::Disjoint ? 1 : 0;
+        }
+
+        return visibleCount;
+    }
+
+    /// <summary>
+    ///     Culls an array of bounding spheres against the frustum.
+    /// </summary>
+    /// <param name="spheres">The bounding spheres.</param>
+    /// <param name="count">The bounding sphere count.</param>
+    /// <param name="visibleIndices">The output indices of the visible spheres, has to have room for count indices.</param>
+    /// <param name="firstIndex">The value added to the reported indices, used when culling a sub-range.</param>
+    /// <returns>The visible sphere count.</returns>
+    size_t Cull(const BoundingSphereBase<T>* spheres, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0) const
+    {
+        auto visibleCount = size_t(0);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto& sphere = spheres[i];
+
+            auto visible = true;
+            for (auto p = 0; p < 6; p++)
+                visible &= GetPlane(p).Dot(sphere.center) >= -sphere.radius;
+
+            visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i);
+            visibleCount += visible ? 1 : 0;
+        }
+
+        return visibleCount;
+    }
+
+    /// <summary>
+    ///     Culls an array of oriented bounding boxes against the frustum.
+    /// </summary>
+    /// <param name="boxes">The oriented bounding boxes.</param>
+    /// <param name="count">The oriented bounding box count.</param>
+    /// <param name="visibleIndices">The output indices of the visible boxes, has to have room for count indices.</param>
+    /// <param name="firstIndex">The value added to the reported indices, used when culling a sub-range.</param>
+    /// <returns>The visible box count.</returns>
+    size_t Cull(const OrientedBoundingBoxBase<T>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0) const
+    {
+        // All planes are tested without early-outs, which keeps the loop free of branches
+        PlaneBase<T> planes[6];
+        for (auto p = 0; p < 6; p++)
+            planes[p] = GetPlane(p);
+
+        auto visibleCount = size_t(0);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto& box = boxes[i];
+
+            auto visible = true;
+            for (const auto& plane : planes)
+                visible &= plane.Dot(box.center) >= -box.GetProjectedRadius(plane.normal);
+
+            visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i);
+            visibleCount += visible ? 1 : 0;
+        }
+
+        return visibleCount;
+    }
+
     void SetPlanes(const MatrixBase<T, 4, 4>& matrix)
     {
         // Left plane
@@ -160,6 +353,10 @@ public:
         planeFar.normal.y = matrix.m24 - matrix.m23;
         planeFar.normal.z = matrix.m34 - matrix.m33;
         planeFar.distance = matrix.m44 - matrix.m43;
+
+        // Unit normals make the plane distances metric, which the sphere tests rely on
+        for (auto i = 0; i < 6; i++)
+            GetPlane(i).Normalize();
     }
 
     std::array<Vector3Base<T>, 8> GetCorners() const
@@ -2,6 +2,16 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+
 template<typename T>
 struct BoundingSphereBase
 {
@@ -28,16 +38,134 @@ public:
     }
 
 public:
+    /// <summary>
+    /// Creates a bounding sphere of the given points using Ritter's algorithm.
+    /// The initial sphere spans the most distant pair of the axis-extreme points and is grown to include
+    /// the points outside of it in a second pass. Fast, but usually 5-20% larger than the minimal sphere.
+    /// </summary>
+    static BoundingSphereBase<T> FromPointsRitter(const Vector3Base<T>* points, const size_t count)
+    {
+        if (count == 0)
+            return BoundingSphereBase<T>();
+
+        size_t minimum[3] = { 0, 0, 0 };
+        size_t maximum[3] = { 0, 0, 0 };
+        GetExtremePoints(points, count, minimum, maximum);
+
+        auto widest = 0;
+        auto widestDistance = T(-1);
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            const auto distance = Vector3Base<T>::DistanceSquared(points[minimum[axis]], points[maximum[axis]]);
+            if (distance > widestDistance)
+            {
+                widest = axis;
+                widestDistance = distance;
+            }
+        }
+
+        auto sphere = FromDiameter(points[minimum[widest]], points[maximum[widest]]);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto distanceSquared = Vector3Base<T>::DistanceSquared(sphere.center, points[i]);
+            if (distanceSquared <= sphere.radius * sphere.radius)
+                continue;
+
+            // Move the center towards the point, so the new sphere touches both it and the far side of the old one
+            const auto distance = Math::Sqrt(distanceSquared);
+            const auto radius = (sphere.radius + distance) * T(0.5);
+
+            sphere.center += (points[i] - sphere.center) * ((radius - sphere.radius) / distance);
+            sphere.radius = radius;
+        }
+
+        return sphere;
+    }
+
+    /// <summary>
+    /// Creates the minimal bounding sphere of the given points using Welzl's algorithm
+    /// (the iterative randomized incremental form, expected O(n) time).
+    /// Welzl's algorithm is run on a small support set, starting with the axis-extreme points, which is extended
+    /// with the points left outside of its sphere until there are none. This keeps the shuffling and the random
+    /// access off the full point set, which is only streamed through once per round (usually 2-3 rounds).
+    /// The result is deterministic for a given seed.
+    /// </summary>
+    /// <param name="points">The points.</param>
+    /// <param name="count">The point count.</param>
+    /// <param name="seed">The seed of the shuffle.</param>
+    static BoundingSphereBase<T> FromPointsWelzl(const Vector3Base<T>* points, const size_t count, const uint32_t seed = 0)
+    {
+        if (count == 0)
+            return BoundingSphereBase<T>();
+
+        std::mt19937 random(seed);
+        std::vector<Vector3Base<T>> support;
+
+        size_t minimum[3] = { 0, 0, 0 };
+        size_t maximum[3] = { 0, 0, 0 };
+        GetExtremePoints(points, count, minimum, maximum);
+
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            support.push_back(points[minimum[axis]]);
+            support.push_back(points[maximum[axis]]);
+        }
+
+        // The minimal sphere of a subset that contains all of the points is the minimal sphere of all points.
+        // Numerical noise could keep re-adding the same points, so after a few rounds everything is added at once.
+        const auto maxRounds = 16;
+        for (auto round = 0;; round++)
+        {
+            std::shuffle(support.begin(), support.end(), random);
+            const auto sphere = FromPointsWelzlInternal(support.data(), support.size());
+
+            const auto supportSize = support.size();
+            for (auto i = size_t(0); i < count; i++)
+            {
+                if (!ContainsApproximately(sphere, points[i]))
+                    support.push_back(points[i]);
+            }
+
+            if (support.size() == supportSize)
+                return sphere;
+
+            if (round == maxRounds)
+            {
+                support.assign(points, points + count);
+                std::shuffle(support.begin(), support.end(), random);
+                return FromPointsWelzlInternal(support.data(), support.size());
+            }
+        }
+    }
+
+    /// <summary>
+    /// Creates the smallest BoundingSphere containing both of the given spheres
+    /// </summary>
+    static BoundingSphereBase<T> Merge(const BoundingSphereBase<T>& a, const BoundingSphereBase<T>& b)
+    {
+        const auto offset = b.center - a.center;
+        const auto distance = offset.Length();
+
+        if (distance + b.radius <= a.radius)
+            return a;
+
+        if (distance + a.radius <= b.radius)
+            return b;
+
+        const auto radius = (distance + a.radius + b.radius) * T(0.5);
+        return BoundingSphereBase<T>(a.center + offset * ((radius - a.radius) / distance), radius);
+    }
+
     /// <summary>
     /// Check if two BoundingSphereBase intersect each other
     /// </summary>
     static bool Intersects(const BoundingSphereBase<T>& a, const BoundingSphereBase<T>& b)
     {
         const auto distance = Vector3Base<T>::DistanceSquared(a.center, b.center);
-        const auto r1Squared = a.radius * a.radius;
-        const auto r2Squared = b.radius * b.radius;
+        const auto radius = a.radius + b.radius;
 
-        return distance <= r1Squared + r2Squared;
+        return distance <= radius * radius;
     }
 
     /// <summary>
@@ -48,7 +176,120 @@ public:
         const auto distance = Vector3Base<T>::DistanceSquared(sphere.center, point);
         const auto rSquared = sphere.radius * sphere.radius;
 
-        return rSquared <= distance;
+        return distance <= rSquared;
+    }
+
+private:
+    static void GetExtremePoints(const Vector3Base<T>* points, const size_t count, size_t minimum[3], size_t maximum[3])
+    {
+        for (auto i = size_t(1); i < count; i++)
+        {
+            for (auto axis = 0; axis < 3; axis++)
+            {
+                if (points[i][axis] < points[minimum[axis]][axis])
+                    minimum[axis] = i;
+                if (points[i][axis] > points[maximum[axis]][axis])
+                    maximum[axis] = i;
+            }
+        }
+    }
+
+    static BoundingSphereBase<T> FromPointsWelzlInternal(const Vector3Base<T>* p, const size_t count)
+    {
+        // Every time a point is outside of the current sphere, the minimal sphere of the points before it
+        // is recomputed with that point on the boundary, recursing over up to 4 boundary points
+        auto sphere = BoundingSphereBase<T>(p[0], T(0));
+
+        for (auto i = size_t(1); i < count; i++)
+        {
+            if (ContainsApproximately(sphere, p[i]))
+                continue;
+
+            sphere = BoundingSphereBase<T>(p[i], T(0));
+            for (auto j = size_t(0); j < i; j++)
+            {
+                if (ContainsApproximately(sphere, p[j]))
+                    continue;
+
+                sphere = FromDiameter(p[i], p[j]);
+                for (auto k = size_t(0); k < j; k++)
+                {
+                    if (ContainsApproximately(sphere, p[k]))
+                        continue;
+
+                    sphere = FromBoundary(p[i], p[j], p[k]);
+                    for (auto l = size_t(0); l < k; l++)
+                    {
+                        if (!ContainsApproximately(sphere, p[l]))
+                            sphere = FromBoundary(p[i], p[j], p[k], p[l]);
+                    }
+                }
+            }
+        }
+
+        return sphere;
+    }
+
+    static bool ContainsApproximately(const BoundingSphereBase<T>& sphere, const Vector3Base<T>& point)
+    {
+        // The boundary points are recomputed in floating point, so points on the sphere can land just outside of it
+        const auto radius = sphere.radius * (T(1) + T(16) * std::numeric_limits<T>::epsilon()) + std::numeric_limits<T>::min();
+        return Vector3Base<T>::DistanceSquared(sphere.center, point) <= radius * radius;
+    }
+
+    static BoundingSphereBase<T> FromDiameter(const Vector3Base<T>& a, const Vector3Base<T>& b)
+    {
+        return BoundingSphereBase<T>((a + b) * T(0.5), Vector3Base<T>::Distance(a, b) * T(0.5));
+    }
+
+    static BoundingSphereBase<T> FromBoundary(const Vector3Base<T>& a, const Vector3Base<T>& b, const Vector3Base<T>& c)
+    {
+        // Circumscribed circle of the triangle, computed relative to a
+        const auto u = b - a;
+        const auto v = c - a;
+        const auto normal = Vector3Base<T>::Cross(u, v);
+        const auto denominator = T(2) * normal.LengthSquared();
+
+        if (denominator <= std::numeric_limits<T>::epsilon() * u.LengthSquared() * v.LengthSquared())
+        {
+            // Collinear, the two most distant points span the sphere
+            const auto ab = FromDiameter(a, b);
+            const auto ac = FromDiameter(a, c);
+            const auto bc = FromDiameter(b, c);
+            return ab.radius >= ac.radius ? (ab.radius >= bc.radius ? ab : bc) : (ac.radius >= bc.radius ? ac : bc);
+        }
+
+        const auto offset = Vector3Base<T>::Cross(v * u.LengthSquared() - u * v.LengthSquared(), normal) / denominator;
+        return BoundingSphereBase<T>(a + offset, offset.Length());
+    }
+
+    static BoundingSphereBase<T> FromBoundary(const Vector3Base<T>& a, const Vector3Base<T>& b, const Vector3Base<T>& c, const Vector3Base<T>& d)
+    {
+        // Circumscribed sphere of the tetrahedron, computed relative to a
+        const auto u = b - a;
+        const auto v = c - a;
+        const auto w = d - a;
+        const auto vw = Vector3Base<T>::Cross(v, w);
+        const auto denominator = T(2) * Vector3Base<T>::Dot(u, vw);
+
+        if (Math::Abs(denominator) <= std::numeric_limits<T>::epsilon() * u.Length() * v.Length() * w.Length())
+        {
+            // Coplanar, the smallest of the triangle spheres that contains the remaining point
+            const BoundingSphereBase<T> candidates[] = { FromBoundary(a, b, c), FromBoundary(a, b, d), FromBoundary(a, c, d), FromBoundary(b, c, d) };
+            const Vector3Base<T> remaining[] = { d, c, b, a };
+
+            auto best = BoundingSphereBase<T>(a, std::numeric_limits<T>::max());
+            for (auto i = 0; i < 4; i++)
+            {
+                if (candidates[i].radius < best.radius && ContainsApproximately(candidates[i], remaining[i]))
+                    best = candidates[i];
+            }
+
+            return best.radius != std::numeric_limits<T>::max() ? best : Merge(candidates[0], BoundingSphereBase<T>(d, T(0)));
+        }
+
+        const auto offset = (vw * u.LengthSquared() + Vector3Base<T>::Cross(w, u) * v.LengthSquared() + Vector3Base<T>::Cross(u, v) * w.LengthSquared()) / denominator;
+        return BoundingSphereBase<T>(a + offset, offset.Length());
     }
 
 public:
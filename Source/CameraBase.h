@@ -0,0 +1,370 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "Quaternion.h"
+#include "Matrix4x4Base.h"
+#include "BoundingFrustumBase.h"
+
+/// <summary>
+///     Camera with cached view, projection and frustum.
+///     Every derived value has its own dirty flag, the setters only invalidate the values depending on what changed
+///     (and nothing at all when the value is the same) and the getters recompute them on first use.
+///     The view inverse is built from the position and orientation, only the projection goes through a general inversion.
+/// </summary>
+template<typename T>
+class CameraBase
+{
+private:
+    enum DirtyFlags : uint32_t
+    {
+        DirtyView = 1 << 0,
+        DirtyInverseView = 1 << 1,
+        DirtyProjection = 1 << 2,
+        DirtyInverseProjection = 1 << 3,
+        DirtyViewProjection = 1 << 4,
+        DirtyInverseViewProjection = 1 << 5,
+        DirtyFrustum = 1 << 6,
+
+        DirtyTransform = DirtyView | DirtyInverseView | DirtyViewProjection | DirtyInverseViewProjection | DirtyFrustum,
+        DirtyLens = DirtyProjection | DirtyInverseProjection | DirtyViewProjection | DirtyInverseViewProjection | DirtyFrustum,
+        DirtyAll = DirtyTransform | DirtyLens
+    };
+
+public:
+    /// <summary>
+    ///     Constructs a perspective camera at the origin, looking forward.
+    /// </summary>
+    CameraBase() = default;
+
+    /// <summary>
+    ///     Constructs a perspective camera.
+    /// </summary>
+    /// <param name="position">The camera position.</param>
+    /// <param name="orientation">The camera orientation.</param>
+    /// <param name="fieldOfView">The vertical field of view in radians.</param>
+    /// <param name="aspectRatio">The width to height ratio.</param>
+    /// <param name="nearPlane">The near plane distance.</param>
+    /// <param name="farPlane">The far plane distance.</param>
+    CameraBase(const Vector3Base<T>& position, const Quaternion& orientation, const T fieldOfView, const T aspectRatio, const T nearPlane, const T farPlane)
+    {
+        m_position = position;
+        m_orientation = orientation;
+        SetPerspective(fieldOfView, aspectRatio, nearPlane, farPlane);
+    }
+
+public:
+    /// <summary>
+    ///     Sets the camera position.
+    /// </summary>
+    void SetPosition(const Vector3Base<T>& position)
+    {
+        if (position == m_position)
+            return;
+
+        m_position = position;
+        m_dirtyFlags |= DirtyTransform;
+    }
+
+    /// <summary>
+    ///     Sets the camera orientation, it has to be normalized.
+    /// </summary>
+    void SetOrientation(const Quaternion& orientation)
+    {
+        if (orientation.x == m_orientation.x && orientation.y == m_orientation.y && orientation.z == m_orientation.z && orientation.w == m_orientation.w)
+            return;
+
+        m_orientation = orientation;
+        m_dirtyFlags |= DirtyTransform;
+    }
+
+    /// <summary>
+    ///     Sets the camera position and orientation.
+    /// </summary>
+    void SetTransform(const Vector3Base<T>& position, const Quaternion& orientation)
+    {
+        SetPosition(position);
+        SetOrientation(orientation);
+    }
+
+    /// <summary>
+    ///     Switches to a perspective projection.
+    /// </summary>
+    /// <param name="fieldOfView">The vertical field of view in radians.</param>
+    /// <param name="aspectRatio">The width to height ratio.</param>
+    /// <param name="nearPlane">The near plane distance.</param>
+    /// <param name="farPlane">The far plane distance.</param>
+    void SetPerspective(const T fieldOfView, const T aspectRatio, const T nearPlane, const T farPlane)
+    {
+        if (!m_isOrthographic && fieldOfView == m_fieldOfView && aspectRatio == m_aspectRatio && nearPlane == m_nearPlane && farPlane == m_farPlane)
+            return;
+
+        m_isOrthographic = false;
+        m_fieldOfView = fieldOfView;
+        m_aspectRatio = aspectRatio;
+        m_nearPlane = nearPlane;
+        m_farPlane = farPlane;
+        m_dirtyFlags |= DirtyLens;
+    }
+
+    /// <summary>
+    ///     Switches to a centered orthographic projection.
+    /// </summary>
+    /// <param name="width">The width of the view volume.</param>
+    /// <param name="height">The height of the view volume.</param>
+    /// <param name="nearPlane">The near plane distance.</param>
+    /// <param name="farPlane">The far plane distance.</param>
+    void SetOrthographic(const T width, const T height, const T nearPlane, const T farPlane)
+    {
+        if (m_isOrthographic && width == m_orthographicWidth && height == m_orthographicHeight && nearPlane == m_nearPlane && farPlane == m_farPlane)
+            return;
+
+        m_isOrthographic = true;
+        m_orthographicWidth = width;
+        m_orthographicHeight = height;
+        m_nearPlane = nearPlane;
+        m_farPlane = farPlane;
+        m_dirtyFlags |= DirtyLens;
+    }
+
+    /// <summary>
+    ///     Sets the aspect ratio of the perspective projection, e.g. when the viewport is resized.
+    /// </summary>
+    void SetAspectRatio(const T aspectRatio)
+    {
+        if (aspectRatio == m_aspectRatio)
+            return;
+
+        m_aspectRatio = aspectRatio;
+        if (!m_isOrthographic)
+            m_dirtyFlags |= DirtyLens;
+    }
+
+    /// <summary>
+    ///     Sets the near and far plane distances.
+    /// </summary>
+    void SetClipPlanes(const T nearPlane, const T farPlane)
+    {
+        if (nearPlane == m_nearPlane && farPlane == m_farPlane)
+            return;
+
+        m_nearPlane = nearPlane;
+        m_farPlane = farPlane;
+        m_dirtyFlags |= DirtyLens;
+    }
+
+public:
+    const Vector3Base<T>& GetPosition() const
+    {
+        return m_position;
+    }
+
+    const Quaternion& GetOrientation() const
+    {
+        return m_orientation;
+    }
+
+    bool IsOrthographic() const
+    {
+        return m_isOrthographic;
+    }
+
+    T GetFieldOfView() const
+    {
+        return m_fieldOfView;
+    }
+
+    T GetAspectRatio() const
+    {
+        return m_aspectRatio;
+    }
+
+    T GetOrthographicWidth() const
+    {
+        return m_orthographicWidth;
+    }
+
+    T GetOrthographicHeight() const
+    {
+        return m_orthographicHeight;
+    }
+
+    T GetNearPlane() const
+    {
+        return m_nearPlane;
+    }
+
+    T GetFarPlane() const
+    {
+        return m_farPlane;
+    }
+
+    /// <summary>
+    ///     Returns the world to view matrix.
+    /// </summary>
+    const Matrix4x4Base<T>& GetView() const
+    {
+        if (m_dirtyFlags & DirtyView)
+        {
+            // The inverse of a rigid transform is the transposed rotation followed by the negated translation
+            const auto rotation = Matrix4x4Base<T>::CreateRotation(m_orientation);
+            const Vector3Base<T> right(rotation.m11, rotation.m12, rotation.m13);
+            const Vector3Base<T> up(rotation.m21, rotation.m22, rotation.m23);
+            const Vector3Base<T> forward(rotation.m31, rotation.m32, rotation.m33);
+
+            m_view = Matrix4x4Base<T>::Transpose(rotation);
+            m_view.m41 = -Vector3Base<T>::Dot(right, m_position);
+            m_view.m42 = -Vector3Base<T>::Dot(up, m_position);
+            m_view.m43 = -Vector3Base<T>::Dot(forward, m_position);
+
+            m_dirtyFlags &= ~DirtyView;
+        }
+
+        return m_view;
+    }
+
+    /// <summary>
+    ///     Returns the view to world matrix.
+    /// </summary>
+    const Matrix4x4Base<T>& GetInverseView() const
+    {
+        if (m_dirtyFlags & DirtyInverseView)
+        {
+            m_inverseView = Matrix4x4Base<T>::CreateRotation(m_orientation);
+            m_inverseView.m41 = m_position.x;
+            m_inverseView.m42 = m_position.y;
+            m_inverseView.m43 = m_position.z;
+
+            m_dirtyFlags &= ~DirtyInverseView;
+        }
+
+        return m_inverseView;
+    }
+
+    /// <summary>
+    ///     Returns the projection matrix.
+    /// </summary>
+    const Matrix4x4Base<T>& GetProjection() const
+    {
+        if (m_dirtyFlags & DirtyProjection)
+        {
+            m_projection = m_isOrthographic
+                ? Matrix4x4Base<T>::CreateOrtho(m_orthographicWidth, m_orthographicHeight, m_nearPlane, m_farPlane)
+                : Matrix4x4Base<T>::CreatePerspective(m_fieldOfView, m_aspectRatio, m_nearPlane, m_farPlane);
+
+            m_dirtyFlags &= ~DirtyProjection;
+        }
+
+        return m_projection;
+    }
+
+    /// <summary>
+    ///     Returns the inverse of the projection matrix.
+    /// </summary>
+    const Matrix4x4Base<T>& GetInverseProjection() const
+    {
+        if (m_dirtyFlags & DirtyInverseProjection)
+        {
+            m_inverseProjection = Matrix4x4Base<T>::Invert(GetProjection());
+            m_dirtyFlags &= ~DirtyInverseProjection;
+        }
+
+        return m_inverseProjection;
+    }
+
+    /// <summary>
+    ///     Returns view * projection.
+    /// </summary>
+    const Matrix4x4Base<T>& GetViewProjection() const
+    {
+        if (m_dirtyFlags & DirtyViewProjection)
+        {
+            m_viewProjection = GetView() * GetProjection();
+            m_dirtyFlags &= ~DirtyViewProjection;
+        }
+
+        return m_viewProjection;
+    }
+
+    /// <summary>
+    ///     Returns the inverse of the view-projection matrix, assembled from the cached inverses.
+    /// </summary>
+    const Matrix4x4Base<T>& GetInverseViewProjection() const
+    {
+        if (m_dirtyFlags & DirtyInverseViewProjection)
+        {
+            m_inverseViewProjection = GetInverseProjection() * GetInverseView();
+            m_dirtyFlags &= ~DirtyInverseViewProjection;
+        }
+
+        return m_inverseViewProjection;
+    }
+
+    /// <summary>
+    ///     Returns the world space frustum of the camera.
+    /// </summary>
+    const BoundingFrustumBase<T>& GetFrustum() const
+    {
+        if (m_dirtyFlags & DirtyFrustum)
+        {
+            m_frustum.SetPlanes(GetViewProjection());
+            m_dirtyFlags &= ~DirtyFrustum;
+        }
+
+        return m_frustum;
+    }
+
+    /// <summary>
+    ///     Returns the world space direction the camera is looking in.
+    /// </summary>
+    Vector3Base<T> GetForward() const
+    {
+        const auto& inverseView = GetInverseView();
+        return Vector3Base<T>(inverseView.m31, inverseView.m32, inverseView.m33);
+    }
+
+    /// <summary>
+    ///     Returns the world space up direction of the camera.
+    /// </summary>
+    Vector3Base<T> GetUp() const
+    {
+        const auto& inverseView = GetInverseView();
+        return Vector3Base<T>(inverseView.m21, inverseView.m22, inverseView.m23);
+    }
+
+    /// <summary>
+    ///     Returns the world space right direction of the camera.
+    /// </summary>
+    Vector3Base<T> GetRight() const
+    {
+        const auto& inverseView = GetInverseView();
+        return Vector3Base<T>(inverseView.m11, inverseView.m12, inverseView.m13);
+    }
+
+private:
+    Vector3Base<T> m_position = Vector3Base<T>(T(0), T(0), T(0));
+    Quaternion m_orientation = Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+
+    bool m_isOrthographic = false;
+    T m_fieldOfView = T(Math::Pi / 3.0);
+    T m_aspectRatio = T(16.0 / 9.0);
+    T m_orthographicWidth = T(1);
+    T m_orthographicHeight = T(1);
+    T m_nearPlane = T(0.1);
+    T m_farPlane = T(1000);
+
+    // The getters are logically const, the cached values are filled on demand
+    mutable uint32_t m_dirtyFlags = DirtyAll;
+    mutable Matrix4x4Base<T> m_view;
+    mutable Matrix4x4Base<T> m_inverseView;
+    mutable Matrix4x4Base<T> m_projection;
+    mutable Matrix4x4Base<T> m_inverseProjection;
+    mutable Matrix4x4Base<T> m_viewProjection;
+    mutable Matrix4x4Base<T> m_inverseViewProjection;
+    mutable BoundingFrustumBase<T> m_frustum;
+};
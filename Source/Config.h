@@ -13,3 +13,7 @@
 #ifndef USE_UPPERCASE_COMPONENTS
 #define USE_UPPERCASE_COMPONENTS        DISABLE
 #endif
+
+#ifndef USE_EXECUTION_POLICIES
+#define USE_EXECUTION_POLICIES          ENABLE
+#endif
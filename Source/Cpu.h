@@ -0,0 +1,182 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "Config.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86                        ENABLE
+#else
+#define SIMD_X86                        DISABLE
+#endif
+
+#if SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+/// <summary>
+///     The instruction set levels used by the runtime-dispatched kernels, every level implies the previous ones.
+/// </summary>
+enum class SimdLevel
+{
+    None,
+    SSE2,
+    AVX2,   // AVX2 + FMA
+    AVX512  // AVX-512F
+};
+
+/// <summary>
+///     Runtime CPU feature detection.
+/// </summary>
+class Cpu
+{
+public:
+    /// <summary>
+    ///     Returns the SIMD level used by the dispatched kernels.
+    ///     It is detected once, the VECTORMATH_SIMD_LEVEL environment variable (none, sse2, avx2 or avx512)
+    ///     can be used to force a lower level for testing and benchmarking.
+    /// </summary>
+    static SimdLevel GetSimdLevel()
+    {
+        static const auto level = SelectSimdLevel();
+        return level;
+    }
+
+    /// <summary>
+    ///     Detects the highest SIMD level supported by both the CPU and the operating system.
+    /// </summary>
+    static SimdLevel DetectSimdLevel()
+    {
+#if SIMD_X86
+        uint32_t registers[4];
+
+        CpuId(0, 0, registers);
+        const auto maxLeaf = registers[0];
+
+        CpuId(1, 0, registers);
+        const auto hasSse2 = (registers[3] & (1u << 26)) != 0;
+        const auto hasFma = (registers[2] & (1u << 12)) != 0;
+        const auto hasOsXsave = (registers[2] & (1u << 27)) != 0;
+        const auto hasAvx = (registers[2] & (1u << 28)) != 0;
+
+        if (!hasSse2)
+            return SimdLevel::None;
+
+        if (!hasOsXsave || !hasAvx || !hasFma || maxLeaf < 7)
+            return SimdLevel::SSE2;
+
+        // The OS has to save the YMM (and ZMM/opmask) state on context switches
+        const auto xcr0 = GetXcr0();
+        if ((xcr0 & 0x6u) != 0x6u)
+            return SimdLevel::SSE2;
+
+        CpuId(7, 0, registers);
+        const auto hasAvx2 = (registers[1] & (1u << 5)) != 0;
+        const auto hasAvx512F = (registers[1] & (1u << 16)) != 0;
+
+        if (!hasAvx2)
+            return SimdLevel::SSE2;
+
+        if (!hasAvx512F || (xcr0 & 0xE6u) != 0xE6u)
+            return SimdLevel::AVX2;
+
+        return SimdLevel::AVX512;
+#else
+        return SimdLevel::None;
+#endif
+    }
+
+    /// <summary>
+    ///     Returns the name of a SIMD level, as accepted by VECTORMATH_SIMD_LEVEL.
+    /// </summary>
+    static const char* GetSimdLevelName(const SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::SSE2:
+            return "sse2";
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::AVX512:
+            return "avx512";
+        default:
+            return "none";
+        }
+    }
+
+    /// <summary>
+    ///     Parses a SIMD level name (case insensitive).
+    /// </summary>
+    /// <param name="name">The name.</param>
+    /// <param name="level">The output level.</param>
+    /// <returns>False when the name is not a known level.</returns>
+    static bool ParseSimdLevel(const char* name, SimdLevel* level)
+    {
+        const SimdLevel levels[] = { SimdLevel::None, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 };
+
+        for (const auto candidate : levels)
+        {
+            const auto candidateName = GetSimdLevelName(candidate);
+
+            auto i = size_t(0);
+            while (name[i] != 0 && candidateName[i] != 0 && (name[i] | 0x20) == candidateName[i])
+                i++;
+
+            if (name[i] == 0 && candidateName[i] == 0)
+            {
+                *level = candidate;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    static SimdLevel SelectSimdLevel()
+    {
+        const auto detected = DetectSimdLevel();
+
+        auto requested = detected;
+        const auto name = std::getenv("VECTORMATH_SIMD_LEVEL");
+
+        // A level above the detected one would crash with an illegal instruction, so it is ignored
+        if (name != nullptr && ParseSimdLevel(name, &requested) && requested < detected)
+            return requested;
+
+        return detected;
+    }
+
+#if SIMD_X86
+    static void CpuId(const uint32_t leaf, const uint32_t subleaf, uint32_t registers[4])
+    {
+#if defined(_MSC_VER)
+        int values[4];
+        __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+        memcpy(registers, values, sizeof(values));
+#else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    }
+
+    static uint64_t GetXcr0()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax;
+        uint32_t edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+#endif
+};
@@ -0,0 +1,285 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+
+/// <summary>
+///     Small work-stealing job system used by the Parallel kernels.
+///     Every worker owns a job queue, it pops its own jobs from the back and steals
+///     from the front of the other queues when it runs out of work.
+///     The thread that waits for a parallel loop helps executing jobs instead of blocking.
+///     An exception thrown by a job is rethrown by For on the calling thread, once all of the loop's jobs are done.
+/// </summary>
+class JobSystem
+{
+public:
+    typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+private:
+    static const size_t InvalidWorker = ~size_t(0);
+
+    struct Loop
+    {
+        const RangeFunction* function;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed;
+        std::mutex mutex;
+        std::exception_ptr exception;   // The first exception thrown by any of the jobs
+    };
+
+    struct Job
+    {
+        Loop* loop;
+        size_t begin;
+        size_t end;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+public:
+    /// <summary>
+    ///     Creates the job system.
+    /// </summary>
+    /// <param name="threadCount">
+    ///     The number of threads executing jobs, including the calling thread.
+    ///     0 uses all hardware threads, 1 runs all jobs on the calling thread.
+    /// </param>
+    explicit JobSystem(size_t threadCount = 0)
+    {
+        if (threadCount == 0)
+            threadCount = Math::Max(size_t(std::thread::hardware_concurrency()), size_t(1));
+
+        m_threadCount = threadCount;
+
+        const auto workerCount = threadCount - 1;
+        for (auto i = size_t(0); i < workerCount; i++)
+            m_queues.emplace_back(new Queue());
+
+        for (auto i = size_t(0); i < workerCount; i++)
+            m_workers.emplace_back(&JobSystem::WorkerMain, this, i);
+    }
+
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+        }
+
+        m_wake.notify_all();
+
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+public:
+    /// <summary>
+    ///     Splits the range [0, count) into chunks and executes them in parallel.
+    ///     Returns once all of the chunks have been executed.
+    /// </summary>
+    /// <param name="count">The element count.</param>
+    /// <param name="chunkSize">The maximum number of elements per job.</param>
+    /// <param name="function">
+    ///     The function, called as function(begin, end) for every chunk.
+    ///     When it throws, the chunks which have not started yet are skipped and the first exception is rethrown.
+    /// </param>
+    void For(const size_t count, size_t chunkSize, const RangeFunction& function)
+    {
+        if (count == 0)
+            return;
+
+        chunkSize = Math::Max(chunkSize, size_t(1));
+
+        if (m_queues.empty() || count <= chunkSize)
+        {
+            function(0, count);
+            return;
+        }
+
+        const auto chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        Loop loop;
+        loop.function = &function;
+        loop.remaining.store(chunkCount, std::memory_order_relaxed);
+        loop.failed.store(false, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_pendingJobs += chunkCount;
+        }
+
+        // Nested loops started from a worker go into its own queue, external threads spread the jobs
+        // over all of the queues so the workers can start without stealing
+        const auto worker = GetCurrentWorker();
+        for (auto chunk = size_t(0); chunk < chunkCount; chunk++)
+        {
+            const auto begin = chunk * chunkSize;
+            const auto end = Math::Min(begin + chunkSize, count);
+            const auto queue = worker != InvalidWorker ? worker : chunk % m_queues.size();
+
+            std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+            m_queues[queue]->jobs.push_back(Job{ &loop, begin, end });
+        }
+
+        m_wake.notify_all();
+
+        while (loop.remaining.load(std::memory_order_acquire) > 0)
+        {
+            if (!RunJob(worker))
+                std::this_thread::yield();
+        }
+
+        if (loop.exception)
+            std::rethrow_exception(loop.exception);
+    }
+
+    /// <summary>
+    ///     Returns the number of threads executing jobs, including the calling thread.
+    /// </summary>
+    size_t GetThreadCount() const
+    {
+        return m_threadCount;
+    }
+
+    /// <summary>
+    ///     Returns the default job system, using all hardware threads.
+    /// </summary>
+    static JobSystem& GetDefault()
+    {
+        static JobSystem jobSystem;
+        return jobSystem;
+    }
+
+private:
+    struct WorkerContext
+    {
+        const JobSystem* owner;
+        size_t index;
+    };
+
+    static WorkerContext& GetWorkerContext()
+    {
+        static thread_local WorkerContext context = { nullptr, InvalidWorker };
+        return context;
+    }
+
+    size_t GetCurrentWorker() const
+    {
+        const auto& context = GetWorkerContext();
+        return context.owner == this ? context.index : InvalidWorker;
+    }
+
+    bool PopJob(const size_t worker, Job* job)
+    {
+        if (worker != InvalidWorker)
+        {
+            auto& queue = *m_queues[worker];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                *job = queue.jobs.back();
+                queue.jobs.pop_back();
+                return true;
+            }
+        }
+
+        const auto queueCount = m_queues.size();
+        const auto start = worker != InvalidWorker ? worker + 1 : 0;
+
+        for (auto i = size_t(0); i < queueCount; i++)
+        {
+            auto& queue = *m_queues[(start + i) % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                *job = queue.jobs.front();
+                queue.jobs.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool RunJob(const size_t worker)
+    {
+        Job job;
+        if (!PopJob(worker, &job))
+            return false;
+
+        m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+        // The loop has to be completed even when the job throws, otherwise its caller would wait forever
+        auto& loop = *job.loop;
+        if (!loop.failed.load(std::memory_order_relaxed))
+        {
+            try
+            {
+                (*loop.function)(job.begin, job.end);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(loop.mutex);
+                if (!loop.exception)
+                    loop.exception = std::current_exception();
+
+                loop.failed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        loop.remaining.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void WorkerMain(const size_t index)
+    {
+        GetWorkerContext() = WorkerContext{ this, index };
+
+        for (;;)
+        {
+            if (RunJob(index))
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wake.wait(lock, [this]
+            {
+                return m_stop || m_pendingJobs.load(std::memory_order_relaxed) > 0;
+            });
+
+            if (m_stop)
+                return;
+        }
+    }
+
+private:
+    size_t m_threadCount = 1;
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<size_t> m_pendingJobs = { 0 };
+    bool m_stop = false;
+};
@@ -0,0 +1,505 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "BoundingBoxBase.h"
+#include "BoundingSphereBase.h"
+#include "BoundingFrustumBase.h"
+
+/// <summary>
+///     Loose octree (looseness factor of 2) for dynamic scenes.
+///     The depth of an object is selected in O(1) from its size, nodes are allocated lazily
+///     in blocks of 8 children from a single contiguous node pool and every node stores its boxes
+///     in a contiguous range of a single item pool. The ranges grow by doubling and released ranges
+///     are recycled through per-size free lists, so there are no per-node allocations.
+/// </summary>
+template<typename T>
+class LooseOctreeBase
+{
+public:
+    /// <summary>
+    ///     The largest supported depth, deeper cells are smaller than the float precision of a typical world.
+    /// </summary>
+    static const uint32_t MaxDepth = 24;
+
+private:
+    static const uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+    // A depth-first walk pops one node and pushes at most 8 children per level
+    static const uint32_t MaxStackSize = MaxDepth * 7 + 1;
+
+    struct Item
+    {
+        BoundingBoxBase<T> box;
+        uint32_t handle;
+    };
+
+    struct Node
+    {
+        Vector3Base<T> center;
+        T halfSize;
+        uint32_t parent;
+        uint32_t firstChild;
+        uint32_t count; // Object count of the whole subtree
+        uint32_t firstItem;
+        uint32_t itemCount;
+        uint32_t itemCapacity;
+    };
+
+    struct Location
+    {
+        uint32_t node;
+        uint32_t slot;
+    };
+
+public:
+    /// <summary>
+    ///     Constructs an empty octree.
+    /// </summary>
+    /// <param name="center">The center of the root node.</param>
+    /// <param name="halfSize">The half size of the root node. Objects centered outside of the root are still accepted.</param>
+    /// <param name="maxDepth">The maximum depth of the tree, clamped to MaxDepth.</param>
+    explicit LooseOctreeBase(const Vector3Base<T>& center, const T halfSize, const uint32_t maxDepth = 8)
+    {
+        m_maxDepth = Math::Min(maxDepth, MaxDepth);
+        m_nodes.push_back(Node{ center, halfSize, InvalidIndex, InvalidIndex, 0u, 0u, 0u, 0u });
+    }
+
+public:
+    /// <summary>
+    ///     Inserts a new object.
+    /// </summary>
+    /// <param name="box">The bounds of the object.</param>
+    /// <returns>The handle of the object.</returns>
+    uint32_t Insert(const BoundingBoxBase<T>& box)
+    {
+        uint32_t handle;
+        if (!m_freeHandles.empty())
+        {
+            handle = m_freeHandles.back();
+            m_freeHandles.pop_back();
+        }
+        else
+        {
+            handle = static_cast<uint32_t>(m_locations.size());
+            m_locations.push_back(Location{ InvalidIndex, InvalidIndex });
+        }
+
+        InsertItem(FindNode(box, true), Item{ box, handle });
+        return handle;
+    }
+
+    /// <summary>
+    ///     Removes an object.
+    /// </summary>
+    /// <param name="handle">The handle of the object.</param>
+    void Remove(const uint32_t handle)
+    {
+        if (!IsValid(handle))
+            return;
+
+        RemoveItem(handle);
+        m_freeHandles.push_back(handle);
+    }
+
+    /// <summary>
+    ///     Updates the bounds of an object.
+    ///     The object is updated in place when it stays in the same node.
+    /// </summary>
+    /// <param name="handle">The handle of the object, removed or unknown handles are ignored.</param>
+    /// <param name="box">The new bounds of the object.</param>
+    void Move(const uint32_t handle, const BoundingBoxBase<T>& box)
+    {
+        if (!IsValid(handle))
+            return;
+
+        const auto location = m_locations[handle];
+        const auto node = FindNode(box, true);
+
+        if (node == location.node)
+        {
+            m_items[m_nodes[node].firstItem + location.slot].box = box;
+            return;
+        }
+
+        RemoveItem(handle);
+        InsertItem(node, Item{ box, handle });
+    }
+
+    /// <summary>
+    ///     Returns the bounds of an object, an empty box for removed or unknown handles.
+    /// </summary>
+    BoundingBoxBase<T> GetBounds(const uint32_t handle) const
+    {
+        if (!IsValid(handle))
+            return BoundingBoxBase<T>();
+
+        const auto location = m_locations[handle];
+        return m_items[m_nodes[location.node].firstItem + location.slot].box;
+    }
+
+    /// <summary>
+    ///     Calls the callback with the handle of every object intersecting the frustum.
+    ///     Nodes fully inside of the frustum report their whole subtree without any further plane tests.
+    /// </summary>
+    /// <param name="frustum">The frustum.</param>
+    /// <param name="callback">The callback, called as callback(uint32_t handle).</param>
+    template<typename TCallback>
+    void ForEach(const BoundingFrustumBase<T>& frustum, TCallback callback) const
+    {
+        struct Entry
+        {
+            uint32_t node;
+            uint32_t planeMask;
+        };
+
+        Entry stack[MaxStackSize];
+        auto stackSize = 0u;
+        stack[stackSize++] = Entry{ 0u, 0x3Fu };
+
+        while (stackSize > 0)
+        {
+            const auto entry = stack[--stackSize];
+
+            const auto& node = m_nodes[entry.node];
+            if (node.count == 0)
+                continue;
+
+            auto planeMask = entry.planeMask;
+            const auto containment = frustum.Classify(GetLooseBounds(node), &planeMask);
+
+            // The root can hold objects centered outside of its bounds, these are always tested
+            if (containment == ContainmentType::Disjoint && entry.node != 0)
+                continue;
+
+            // Not for the root, for the same reason
+            if (containment == ContainmentType::Contains && entry.node != 0)
+            {
+                ForEachInSubtree(entry.node, callback);
+                continue;
+            }
+
+            for (auto i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+            {
+                const auto& item = m_items[i];
+                auto itemMask = entry.node != 0 ? planeMask : 0x3Fu;
+                if (frustum.Classify(item.box, &itemMask) != ContainmentType::Disjoint)
+                    callback(item.handle);
+            }
+
+            if (node.firstChild == InvalidIndex || containment == ContainmentType::Disjoint)
+                continue;
+
+            for (auto i = node.firstChild; i < node.firstChild + 8u; i++)
+            {
+                if (m_nodes[i].count > 0)
+                    stack[stackSize++] = Entry{ i, planeMask };
+            }
+        }
+    }
+
+    /// <summary>
+    ///     Calls the callback with the handle of every object intersecting the sphere.
+    /// </summary>
+    /// <param name="sphere">The sphere.</param>
+    /// <param name="callback">The callback, called as callback(uint32_t handle).</param>
+    template<typename TCallback>
+    void ForEach(const BoundingSphereBase<T>& sphere, TCallback callback) const
+    {
+        uint32_t stack[MaxStackSize];
+        auto stackSize = 0u;
+        stack[stackSize++] = 0u;
+
+        while (stackSize > 0)
+        {
+            const auto index = stack[--stackSize];
+
+            const auto& node = m_nodes[index];
+            if (node.count == 0)
+                continue;
+
+            const auto overlaps = IntersectsSphere(GetLooseBounds(node), sphere);
+            if (!overlaps && index != 0)
+                continue;
+
+            for (auto i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+            {
+                if (IntersectsSphere(m_items[i].box, sphere))
+                    callback(m_items[i].handle);
+            }
+
+            if (node.firstChild == InvalidIndex || !overlaps)
+                continue;
+
+            for (auto i = node.firstChild; i < node.firstChild + 8u; i++)
+            {
+                if (m_nodes[i].count > 0)
+                    stack[stackSize++] = i;
+            }
+        }
+    }
+
+    /// <summary>
+    ///     Finds all objects intersecting the frustum.
+    /// </summary>
+    /// <param name="frustum">The frustum.</param>
+    /// <param name="result">The output list of handles, it is cleared first.</param>
+    void Query(const BoundingFrustumBase<T>& frustum, std::vector<uint32_t>& result) const
+    {
+        result.clear();
+        ForEach(frustum, [&result](const uint32_t handle)
+        {
+            result.push_back(handle);
+        });
+    }
+
+    /// <summary>
+    ///     Finds all objects intersecting the sphere.
+    /// </summary>
+    /// <param name="sphere">The sphere.</param>
+    /// <param name="result">The output list of handles, it is cleared first.</param>
+    void Query(const BoundingSphereBase<T>& sphere, std::vector<uint32_t>& result) const
+    {
+        result.clear();
+        ForEach(sphere, [&result](const uint32_t handle)
+        {
+            result.push_back(handle);
+        });
+    }
+
+    /// <summary>
+    ///     Returns the object count.
+    /// </summary>
+    size_t GetCount() const
+    {
+        return m_nodes[0].count;
+    }
+
+    /// <summary>
+    ///     Returns the allocated node count.
+    /// </summary>
+    size_t GetNodeCount() const
+    {
+        return m_nodes.size();
+    }
+
+private:
+    static const uint32_t MinBlockSize = 4;
+
+    bool IsValid(const uint32_t handle) const
+    {
+        return handle < m_locations.size() && m_locations[handle].node != InvalidIndex;
+    }
+
+    static bool IntersectsSphere(const BoundingBoxBase<T>& box, const BoundingSphereBase<T>& sphere)
+    {
+        const auto minimum = box.Minimum();
+        const auto maximum = box.Maximum();
+
+        const auto closest = Vector3Base<T>(
+            Math::Clamp(sphere.center.x, minimum.x, maximum.x),
+            Math::Clamp(sphere.center.y, minimum.y, maximum.y),
+            Math::Clamp(sphere.center.z, minimum.z, maximum.z));
+
+        return Vector3Base<T>::DistanceSquared(closest, sphere.center) <= sphere.radius * sphere.radius;
+    }
+
+    static BoundingBoxBase<T> GetLooseBounds(const Node& node)
+    {
+        // Loose bounds are twice the size of the node's cell
+        return BoundingBoxBase<T>(node.center, Vector3Base<T>(node.halfSize * T(4)));
+    }
+
+    uint32_t GetDepth(const BoundingBoxBase<T>& box) const
+    {
+        // With looseness of 2, an object centered in a cell fits into its loose bounds when the
+        // half-extent of the object is not larger than the half size of the cell:
+        // depth = floor(log2(rootHalfSize / halfExtent))
+        const auto halfExtent = Math::Max(box.size.x, box.size.y, box.size.z) * T(0.5);
+        if (!(halfExtent > T(0)))
+            return m_maxDepth;
+
+        const auto ratio = m_nodes[0].halfSize / halfExtent;
+        if (ratio < T(1))
+            return 0u;
+
+        auto exponent = 0;
+        std::frexp(ratio, &exponent);
+
+        return Math::Min(static_cast<uint32_t>(exponent - 1), m_maxDepth);
+    }
+
+    uint32_t FindNode(const BoundingBoxBase<T>& box, const bool create)
+    {
+        const auto& root = m_nodes[0];
+        const auto offset = box.center - root.center;
+
+        if (Math::Abs(offset.x) > root.halfSize || Math::Abs(offset.y) > root.halfSize || Math::Abs(offset.z) > root.halfSize)
+            return 0u;
+
+        const auto depth = GetDepth(box);
+
+        auto index = 0u;
+        for (auto level = 0u; level < depth; level++)
+        {
+            if (m_nodes[index].firstChild == InvalidIndex)
+            {
+                if (!create)
+                    break;
+
+                Split(index);
+            }
+
+            const auto& node = m_nodes[index];
+            const auto octant = (box.center.x >= node.center.x ? 1u : 0u)
+                | (box.center.y >= node.center.y ? 2u : 0u)
+                | (box.center.z >= node.center.z ? 4u : 0u);
+
+            index = node.firstChild + octant;
+        }
+
+        return index;
+    }
+
+    void Split(const uint32_t index)
+    {
+        const auto firstChild = static_cast<uint32_t>(m_nodes.size());
+        const auto center = m_nodes[index].center;
+        const auto halfSize = m_nodes[index].halfSize * T(0.5);
+
+        for (auto octant = 0u; octant < 8u; octant++)
+        {
+            const auto childCenter = Vector3Base<T>(
+                center.x + ((octant & 1u) ? halfSize : -halfSize),
+                center.y + ((octant & 2u) ? halfSize : -halfSize),
+                center.z + ((octant & 4u) ? halfSize : -halfSize));
+
+            m_nodes.push_back(Node{ childCenter, halfSize, index, InvalidIndex, 0u, 0u, 0u, 0u });
+        }
+
+        m_nodes[index].firstChild = firstChild;
+    }
+
+    void InsertItem(const uint32_t node, const Item& item)
+    {
+        if (m_nodes[node].itemCount == m_nodes[node].itemCapacity)
+            GrowBlock(node);
+
+        auto& target = m_nodes[node];
+        m_locations[item.handle] = Location{ node, target.itemCount };
+        m_items[target.firstItem + target.itemCount] = item;
+        target.itemCount++;
+
+        for (auto index = node; index != InvalidIndex; index = m_nodes[index].parent)
+            m_nodes[index].count++;
+    }
+
+    void RemoveItem(const uint32_t handle)
+    {
+        const auto location = m_locations[handle];
+        auto& source = m_nodes[location.node];
+
+        // Swap-remove, keeps the range contiguous
+        source.itemCount--;
+        m_items[source.firstItem + location.slot] = m_items[source.firstItem + source.itemCount];
+        m_locations[m_items[source.firstItem + location.slot].handle].slot = location.slot;
+
+        if (source.itemCount == 0)
+        {
+            FreeBlock(source.firstItem, source.itemCapacity);
+            source.firstItem = source.itemCapacity = 0u;
+        }
+
+        m_locations[handle] = Location{ InvalidIndex, InvalidIndex };
+
+        for (auto index = location.node; index != InvalidIndex; index = m_nodes[index].parent)
+            m_nodes[index].count--;
+    }
+
+    static uint32_t GetSizeClass(const uint32_t capacity)
+    {
+        auto sizeClass = 0u;
+        while ((MinBlockSize << sizeClass) < capacity)
+            sizeClass++;
+
+        return sizeClass;
+    }
+
+    void GrowBlock(const uint32_t node)
+    {
+        const auto capacity = Math::Max(m_nodes[node].itemCapacity * 2u, MinBlockSize);
+        auto& freeBlocks = m_freeBlocks[GetSizeClass(capacity)];
+
+        uint32_t block;
+        if (!freeBlocks.empty())
+        {
+            block = freeBlocks.back();
+            freeBlocks.pop_back();
+        }
+        else
+        {
+            block = static_cast<uint32_t>(m_items.size());
+            m_items.resize(m_items.size() + capacity);
+        }
+
+        // The slots are relative to the block, so the locations stay valid
+        auto& target = m_nodes[node];
+        std::copy(m_items.begin() + target.firstItem, m_items.begin() + target.firstItem + target.itemCount, m_items.begin() + block);
+
+        if (target.itemCapacity > 0)
+            FreeBlock(target.firstItem, target.itemCapacity);
+
+        target.firstItem = block;
+        target.itemCapacity = capacity;
+    }
+
+    void FreeBlock(const uint32_t block, const uint32_t capacity)
+    {
+        m_freeBlocks[GetSizeClass(capacity)].push_back(block);
+    }
+
+    template<typename TCallback>
+    void ForEachInSubtree(const uint32_t root, TCallback& callback) const
+    {
+        uint32_t stack[MaxStackSize];
+        auto stackSize = 0u;
+        stack[stackSize++] = root;
+
+        while (stackSize > 0)
+        {
+            const auto& node = m_nodes[stack[--stackSize]];
+
+            if (node.count == 0)
+                continue;
+
+            for (auto i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+                callback(m_items[i].handle);
+
+            if (node.firstChild == InvalidIndex)
+                continue;
+
+            for (auto i = node.firstChild; i < node.firstChild + 8u; i++)
+            {
+                if (m_nodes[i].count > 0)
+                    stack[stackSize++] = i;
+            }
+        }
+    }
+
+private:
+    uint32_t m_maxDepth = 8;
+
+    std::vector<Node> m_nodes;
+    std::vector<Item> m_items;
+    std::vector<uint32_t> m_freeBlocks[32];
+    std::vector<Location> m_locations;
+    std::vector<uint32_t> m_freeHandles;
+};
@@ -0,0 +1,220 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Config.h"
+
+/// <summary>
+///     Read-only memory mapping of a whole file.
+///     WillNeed and DontNeed pass access hints to the OS for the pages of a byte range, so a file much larger
+///     than the available memory can be streamed through without its pages piling up in the page cache.
+/// </summary>
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+    /// <summary>
+    ///     Maps a file into memory.
+    /// </summary>
+    /// <param name="path">The file path.</param>
+    /// <param name="sequential">Hints the OS that the file will be read front to back (more aggressive read-ahead).</param>
+    /// <returns>False when the file does not exist, is empty or cannot be mapped.</returns>
+    bool Open(const char* path, const bool sequential = false)
+    {
+        Close();
+
+#if defined(_WIN32)
+        const auto flags = sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+        m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            Close();
+            return false;
+        }
+
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const auto view = m_mapping != nullptr ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (view == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        m_data = static_cast<const uint8_t*>(view);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const auto file = open(path, O_RDONLY);
+        if (file < 0)
+            return false;
+
+        struct stat status;
+        if (fstat(file, &status) != 0 || status.st_size <= 0)
+        {
+            close(file);
+            return false;
+        }
+
+        // The mapping keeps the file alive, the descriptor is not needed anymore
+        const auto size = static_cast<size_t>(status.st_size);
+        const auto view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+
+        if (view == MAP_FAILED)
+            return false;
+
+        m_data = static_cast<const uint8_t*>(view);
+        m_size = size;
+
+        if (sequential)
+            madvise(view, size, MADV_SEQUENTIAL);
+#endif
+
+        return true;
+    }
+
+    void Close()
+    {
+#if defined(_WIN32)
+        if (m_data != nullptr)
+            UnmapViewOfFile(m_data);
+        if (m_mapping != nullptr)
+            CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(m_file);
+
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data != nullptr)
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    /// <summary>
+    ///     Starts reading the pages of a byte range in the background.
+    /// </summary>
+    void WillNeed(const size_t offset, const size_t size) const
+    {
+        size_t begin, end;
+        if (!GetPageRange(offset, size, true, begin, end))
+            return;
+
+#if defined(_WIN32)
+#if _WIN32_WINNT >= 0x0602
+        WIN32_MEMORY_RANGE_ENTRY range = { const_cast<uint8_t*>(m_data) + begin, end - begin };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#else
+        madvise(const_cast<uint8_t*>(m_data) + begin, end - begin, MADV_WILLNEED);
+#endif
+    }
+
+    /// <summary>
+    ///     Releases the pages fully inside a byte range, they are read again from the file when accessed.
+    /// </summary>
+    void DontNeed(const size_t offset, const size_t size) const
+    {
+        size_t begin, end;
+        if (!GetPageRange(offset, size, false, begin, end))
+            return;
+
+#if defined(_WIN32)
+        // Unlocking pages which are not locked removes them from the working set
+        VirtualUnlock(const_cast<uint8_t*>(m_data) + begin, end - begin);
+#else
+        madvise(const_cast<uint8_t*>(m_data) + begin, end - begin, MADV_DONTNEED);
+#endif
+    }
+
+public:
+    bool IsOpen() const
+    {
+        return m_data != nullptr;
+    }
+
+    const uint8_t* GetData() const
+    {
+        return m_data;
+    }
+
+    size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    static size_t GetPageSize()
+    {
+#if defined(_WIN32)
+        static const auto pageSize = []
+        {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return static_cast<size_t>(info.dwPageSize);
+        }();
+#else
+        static const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        return pageSize;
+    }
+
+private:
+    /// <summary>
+    ///     Clamps a byte range to the file and rounds it out (or in) to whole pages.
+    /// </summary>
+    bool GetPageRange(const size_t offset, const size_t size, const bool roundOut, size_t& begin, size_t& end) const
+    {
+        if (m_data == nullptr || offset >= m_size)
+            return false;
+
+        const auto pageSize = GetPageSize();
+        const auto last = size < m_size - offset ? offset + size : m_size;
+
+        begin = roundOut ? offset / pageSize * pageSize : (offset + pageSize - 1) / pageSize * pageSize;
+        end = roundOut || last == m_size ? last : last / pageSize * pageSize;
+        return begin < end;
+    }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#if defined(_WIN32)
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
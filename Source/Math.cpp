@@ -22,3 +22,8 @@ const float Math::RadianToDegree = 180.0f / Pi;
 const Quaternion Quaternion::Identity(0.0f, 0.0f, 0.0f, 1.0f);
 const Quaternion Quaternion::Zero(0.0f, 0.0f, 0.0f, 0.0f);
 const Quaternion Quaternion::One(1.0f, 1.0f, 1.0f, 1.0f);
+
+/* Vector4 */
+// Compiled here, so the quaternion transform is checked even when no header calls it
+template Vector4Base<float> Vector4Base<float>::Transform(const Vector4Base<float>& a, const Quaternion& rotation);
+template Vector4Base<double> Vector4Base<double>::Transform(const Vector4Base<double>& a, const Quaternion& rotation);
@@ -44,6 +44,18 @@ public:
         return value >= 0 ? value : -value;
     }
 
+    // The floating point overloads clear the sign bit, the comparison above compiles to a branch
+    // (it has to keep -0 negative) which mispredicts on mixed signs
+    static float Abs(const float value)
+    {
+        return std::fabs(value);
+    }
+
+    static double Abs(const double value)
+    {
+        return std::fabs(value);
+    }
+
     template<typename TBase, typename TExponent>
     static TBase Pow(TBase base, TExponent exponent)
     {
@@ -134,22 +146,27 @@ public:
 
     static int FloorToInt(const float value)
     {
-        return static_cast<int>(floorf(value));
+        // Truncate and adjust, avoids the floorf call in hot loops
+        const auto truncated = static_cast<int>(value);
+        return truncated - (value < static_cast<float>(truncated) ? 1 : 0);
     }
 
     static int FloorToInt(const double value)
     {
-        return static_cast<int>(floorf(static_cast<float>(value)));
+        const auto truncated = static_cast<int>(value);
+        return truncated - (value < static_cast<double>(truncated) ? 1 : 0);
     }
 
     static int CeilToInt(const float value)
     {
-        return static_cast<int>(ceilf(value));
+        const auto truncated = static_cast<int>(value);
+        return truncated + (value > static_cast<float>(truncated) ? 1 : 0);
     }
 
     static int CeilToInt(const double value)
     {
-        return static_cast<int>(ceilf(static_cast<float>(value)));
+        const auto truncated = static_cast<int>(value);
+        return truncated + (value > static_cast<double>(truncated) ? 1 : 0);
     }
 
     static bool IsZero(const int a)
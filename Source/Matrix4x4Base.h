@@ -141,7 +141,7 @@ public:
     void Negate();
     float Determinant();
 
-    bool IsIdentity();
+    bool IsIdentity() const;
 
     Vector3Base<T> Translation();
     Vector3Base<T> Scale();
@@ -305,7 +305,7 @@ float Matrix4x4Base<T>::Determinant()
 }
 
 template <typename T>
-bool Matrix4x4Base<T>::IsIdentity()
+bool Matrix4x4Base<T>::IsIdentity() const
 {
     for(auto i = 0u; i < 4*4; i ++)
     {
@@ -337,18 +337,38 @@ void Matrix4x4Base<T>::DecomposeTransform(Vector3Base<T>& translation, Quaternio
 {
     translation = Translation();
     scale = Scale();
-    rotation = Quaternion::Rotation(*this);
+
+    // A mirrored transform has a negative determinant, the reflection is put into the x scale
+    const auto determinant = m11 * (m22 * m33 - m23 * m32) - m12 * (m21 * m33 - m23 * m31) + m13 * (m21 * m32 - m22 * m31);
+    if (determinant < T(0))
+        scale.x = -scale.x;
+
+    // The rotation is extracted from the unscaled rows, a zero scale leaves its row at zero
+    const auto inverseX = Math::IsZero(scale.x) ? T(0) : T(1) / scale.x;
+    const auto inverseY = Math::IsZero(scale.y) ? T(0) : T(1) / scale.y;
+    const auto inverseZ = Math::IsZero(scale.z) ? T(0) : T(1) / scale.z;
+
+    auto rotationMatrix = Matrix4x4Base<float>::Identity;
+    rotationMatrix.m11 = float(m11 * inverseX);
+    rotationMatrix.m12 = float(m12 * inverseX);
+    rotationMatrix.m13 = float(m13 * inverseX);
+    rotationMatrix.m21 = float(m21 * inverseY);
+    rotationMatrix.m22 = float(m22 * inverseY);
+    rotationMatrix.m23 = float(m23 * inverseY);
+    rotationMatrix.m31 = float(m31 * inverseZ);
+    rotationMatrix.m32 = float(m32 * inverseZ);
+    rotationMatrix.m33 = float(m33 * inverseZ);
+
+    // Rounding and slightly skewed rows leave the quaternion a bit off unit length
+    rotation = Quaternion::Rotation(rotationMatrix);
+    rotation.Normalize();
 }
 
 template <typename T>
 void Matrix4x4Base<T>::ComposeTransform(const VectorBase<T, 3>& translation, const Quaternion& rotation,
     const VectorBase<T, 3>& scale)
 {
-    auto matrix = Matrix4x4Base<T>::Scale(scale);
-    matrix *= Matrix4x4Base<T>::CreateRotation(rotation);
-    matrix *= Matrix4x4Base<T>::Translation(translation);
-
-    *this = matrix;
+    *this = CreateTransform(translation, rotation, scale);
 }
 
 template <typename T>
@@ -634,15 +654,15 @@ Matrix4x4Base<T> Matrix4x4Base<T>::CreateRotation(const VectorBase<T, 3>& axis,
 template <typename T>
 Matrix4x4Base<T> Matrix4x4Base<T>::CreateRotation(const Quaternion& rotation)
 {
-    const auto xx = T(rotation.X * rotation.X);
-    const auto yy = T(rotation.Y * rotation.Y);
-    const auto zz = T(rotation.Z * rotation.Z);
-    const auto xy = T(rotation.X * rotation.Y);
-    const auto zw = T(rotation.Z * rotation.W);
-    const auto zx = T(rotation.Z * rotation.X);
-    const auto yw = T(rotation.Y * rotation.W);
-    const auto yz = T(rotation.Y * rotation.Z);
-    const auto xw = T(rotation.X * rotation.W);
+    const auto xx = T(rotation.x * rotation.x);
+    const auto yy = T(rotation.y * rotation.y);
+    const auto zz = T(rotation.z * rotation.z);
+    const auto xy = T(rotation.x * rotation.y);
+    const auto zw = T(rotation.z * rotation.w);
+    const auto zx = T(rotation.z * rotation.x);
+    const auto yw = T(rotation.y * rotation.w);
+    const auto yz = T(rotation.y * rotation.z);
+    const auto xw = T(rotation.x * rotation.w);
 
     auto result = Identity;
     result.m11 = T(1.0) - (T(2.0) * (yy + zz));
@@ -667,7 +687,35 @@ template <typename T>
 Matrix4x4Base<T> Matrix4x4Base<T>::CreateTransform(const VectorBase<T, 3>& translation, const Quaternion& rotation,
     const VectorBase<T, 3>& scaling)
 {
-    return Matrix4x4Base<T>::CreateScaling(scaling) * Matrix4x4Base<T>::CreateRotation(rotation) * Matrix4x4Base<T>::CreateTranslation(translation);
+    // Same as CreateScaling(scaling) * CreateRotation(rotation) * CreateTranslation(translation),
+    // the scale only multiplies the rotation rows and the translation is the last row
+    const auto x2 = T(rotation.x + rotation.x);
+    const auto y2 = T(rotation.y + rotation.y);
+    const auto z2 = T(rotation.z + rotation.z);
+    const auto xx = T(rotation.x) * x2;
+    const auto yy = T(rotation.y) * y2;
+    const auto zz = T(rotation.z) * z2;
+    const auto xy = T(rotation.x) * y2;
+    const auto zw = T(rotation.w) * z2;
+    const auto zx = T(rotation.z) * x2;
+    const auto yw = T(rotation.w) * y2;
+    const auto yz = T(rotation.y) * z2;
+    const auto xw = T(rotation.w) * x2;
+
+    auto result = Identity;
+    result.m11 = scaling.x * (T(1) - (yy + zz));
+    result.m12 = scaling.x * (xy + zw);
+    result.m13 = scaling.x * (zx - yw);
+    result.m21 = scaling.y * (xy - zw);
+    result.m22 = scaling.y * (T(1) - (zz + xx));
+    result.m23 = scaling.y * (yz + xw);
+    result.m31 = scaling.z * (zx + yw);
+    result.m32 = scaling.z * (yz - xw);
+    result.m33 = scaling.z * (T(1) - (yy + xx));
+    result.m41 = translation.x;
+    result.m42 = translation.y;
+    result.m43 = translation.z;
+    return result;
 }
 
 template <typename T>
@@ -0,0 +1,265 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "SimdKernels.h"
+#include "Vector2Base.h"
+#include "Vector3Base.h"
+#include "Vector4Base.h"
+
+/// <summary>
+///     How the triangles around a vertex contribute to its normal or tangent.
+/// </summary>
+enum class NormalWeighting
+{
+    /// <summary>
+    ///     Proportionally to the triangle area, cheapest, but long thin triangles dominate.
+    /// </summary>
+    Area,
+
+    /// <summary>
+    ///     Proportionally to the triangle angle at the vertex, independent of the tessellation.
+    /// </summary>
+    Angle
+};
+
+/// <summary>
+///     Smooth normal and tangent generation for indexed triangle lists (three indices per triangle).
+///     The triangle normal is Cross(p1 - p0, p2 - p0). The Parallel overloads split the triangles between the threads
+///     and use the Accumulate and Finish functions below on partial buffers.
+/// </summary>
+class Mesh
+{
+public:
+    /// <summary>
+    ///     The number of triangles processed per SimdKernels::TriangleNormals call.
+    /// </summary>
+    static const size_t TriangleBlockSize = 256;
+
+public:
+    /// <summary>
+    ///     Computes smooth per-vertex normals, vertices which are not referenced by any triangle get a zero normal.
+    /// </summary>
+    /// <param name="positions">The vertex positions.</param>
+    /// <param name="vertexCount">The vertex count.</param>
+    /// <param name="indices">The triangle indices.</param>
+    /// <param name="indexCount">The index count, a multiple of three.</param>
+    /// <param name="normals">The output normals, one per vertex.</param>
+    /// <param name="weighting">The weighting of the triangles around a vertex.</param>
+    template<typename T, typename TIndex>
+    static void ComputeNormals(const Vector3Base<T>* positions, const size_t vertexCount, const TIndex* indices, const size_t indexCount,
+        Vector3Base<T>* normals, const NormalWeighting weighting = NormalWeighting::Angle)
+    {
+        std::fill(normals, normals + vertexCount, Vector3Base<T>(T(0)));
+        AccumulateNormals(positions, indices, 0, indexCount / 3, weighting, normals, 0);
+        FinishNormals(normals, vertexCount);
+    }
+
+    /// <summary>
+    ///     Computes per-vertex tangents from texture coordinates, orthogonalized against the normals.
+    ///     The w component is the handedness, bitangent = w * Cross(normal, tangent).
+    /// </summary>
+    /// <param name="positions">The vertex positions.</param>
+    /// <param name="normals">The vertex normals.</param>
+    /// <param name="uvs">The vertex texture coordinates.</param>
+    /// <param name="vertexCount">The vertex count.</param>
+    /// <param name="indices">The triangle indices.</param>
+    /// <param name="indexCount">The index count, a multiple of three.</param>
+    /// <param name="tangents">The output tangents, one per vertex.</param>
+    /// <param name="weighting">The weighting of the triangles around a vertex.</param>
+    template<typename T, typename TIndex>
+    static void ComputeTangents(const Vector3Base<T>* positions, const Vector3Base<T>* normals, const Vector2Base<T>* uvs, const size_t vertexCount,
+        const TIndex* indices, const size_t indexCount, Vector4Base<T>* tangents, const NormalWeighting weighting = NormalWeighting::Angle)
+    {
+        std::vector<Vector3Base<T>> sums(vertexCount * 2, Vector3Base<T>(T(0)));
+        AccumulateTangents(positions, uvs, indices, 0, indexCount / 3, weighting, sums.data(), 0);
+        FinishTangents(normals, sums.data(), vertexCount, tangents);
+    }
+
+public:
+    /// <summary>
+    ///     Adds the weighted normals of the triangles [triangleBegin, triangleEnd) to sums[index - firstVertex].
+    /// </summary>
+    template<typename T, typename TIndex>
+    static void AccumulateNormals(const Vector3Base<T>* positions, const TIndex* indices, const size_t triangleBegin, const size_t triangleEnd,
+        const NormalWeighting weighting, Vector3Base<T>* sums, const size_t firstVertex)
+    {
+        for (auto i = triangleBegin; i < triangleEnd; i++)
+        {
+            const auto i0 = static_cast<size_t>(indices[i * 3 + 0]);
+            const auto i1 = static_cast<size_t>(indices[i * 3 + 1]);
+            const auto i2 = static_cast<size_t>(indices[i * 3 + 2]);
+
+            T weights[3];
+            const auto normal = GetTriangleNormal(positions[i0], positions[i1], positions[i2], weighting, weights);
+
+            sums[i0 - firstVertex] += normal * weights[0];
+            sums[i1 - firstVertex] += normal * weights[1];
+            sums[i2 - firstVertex] += normal * weights[2];
+        }
+    }
+
+    /// <summary>
+    ///     AccumulateNormals for single-precision positions and 32-bit indices,
+    ///     the triangle normals and weights are computed in blocks by SimdKernels::TriangleNormals.
+    /// </summary>
+    static void AccumulateNormals(const Vector3Base<float>* positions, const uint32_t* indices, const size_t triangleBegin, const size_t triangleEnd,
+        const NormalWeighting weighting, Vector3Base<float>* sums, const size_t firstVertex)
+    {
+        float x[TriangleBlockSize];
+        float y[TriangleBlockSize];
+        float z[TriangleBlockSize];
+        float weights[3][TriangleBlockSize];
+
+        const auto angleWeighted = weighting == NormalWeighting::Angle;
+
+        for (auto blockBegin = triangleBegin; blockBegin < triangleEnd; blockBegin += TriangleBlockSize)
+        {
+            const auto blockCount = Math::Min(TriangleBlockSize, triangleEnd - blockBegin);
+            const auto blockIndices = indices + blockBegin * 3;
+
+            SimdKernels::TriangleNormals(positions, blockIndices, x, y, z,
+                angleWeighted ? weights[0] : nullptr, angleWeighted ? weights[1] : nullptr, angleWeighted ? weights[2] : nullptr, blockCount);
+
+            for (auto i = size_t(0); i < blockCount; i++)
+            {
+                const auto normal = Vector3Base<float>(x[i], y[i], z[i]);
+
+                for (auto k = 0; k < 3; k++)
+                {
+                    auto& sum = sums[blockIndices[i * 3 + k] - firstVertex];
+                    sum += angleWeighted ? normal * weights[k][i] : normal;
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    ///     Normalizes accumulated normals, zero sums stay zero.
+    /// </summary>
+    template<typename T>
+    static void FinishNormals(Vector3Base<T>* normals, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            // Not Normalize, its zero tolerance would skip the tiny sums of area-weighted small triangles
+            const auto lengthSquared = normals[i].LengthSquared();
+            if (lengthSquared > T(0))
+                normals[i] *= T(1) / Math::Sqrt(lengthSquared);
+        }
+    }
+
+    /// <summary>
+    ///     Adds the weighted unit tangents and bitangents of the triangles [triangleBegin, triangleEnd)
+    ///     to sums[(index - firstVertex) * 2] and sums[(index - firstVertex) * 2 + 1].
+    ///     Triangles with degenerate texture coordinates do not contribute.
+    /// </summary>
+    template<typename T, typename TIndex>
+    static void AccumulateTangents(const Vector3Base<T>* positions, const Vector2Base<T>* uvs, const TIndex* indices,
+        const size_t triangleBegin, const size_t triangleEnd, const NormalWeighting weighting, Vector3Base<T>* sums, const size_t firstVertex)
+    {
+        for (auto i = triangleBegin; i < triangleEnd; i++)
+        {
+            const size_t corners[3] = {
+                static_cast<size_t>(indices[i * 3 + 0]),
+                static_cast<size_t>(indices[i * 3 + 1]),
+                static_cast<size_t>(indices[i * 3 + 2])
+            };
+
+            const auto edge01 = positions[corners[1]] - positions[corners[0]];
+            const auto edge02 = positions[corners[2]] - positions[corners[0]];
+            const auto uv01 = uvs[corners[1]] - uvs[corners[0]];
+            const auto uv02 = uvs[corners[2]] - uvs[corners[0]];
+
+            const auto determinant = uv01.x * uv02.y - uv02.x * uv01.y;
+            if (determinant == T(0))
+                continue;
+
+            // Solve edge = du * tangent + dv * bitangent for both edges, the common 1 / determinant factor
+            // only flips the directions and is removed by the normalization
+            const auto sign = determinant < T(0) ? T(-1) : T(1);
+            auto tangent = (edge01 * uv02.y - edge02 * uv01.y) * sign;
+            auto bitangent = (edge02 * uv01.x - edge01 * uv02.x) * sign;
+            FinishNormals(&tangent, 1);
+            FinishNormals(&bitangent, 1);
+
+            // The normal weights scaled by the normal length give twice the area or the corner angles
+            T weights[3];
+            const auto normal = GetTriangleNormal(positions[corners[0]], positions[corners[1]], positions[corners[2]], weighting, weights);
+            const auto length = normal.Length();
+
+            for (auto k = 0; k < 3; k++)
+            {
+                const auto vertex = (corners[k] - firstVertex) * 2;
+                sums[vertex + 0] += tangent * (weights[k] * length);
+                sums[vertex + 1] += bitangent * (weights[k] * length);
+            }
+        }
+    }
+
+    /// <summary>
+    ///     Turns accumulated tangent and bitangent sums into tangents orthogonal to the normals, with the handedness in w.
+    ///     Vertices without a tangent get an arbitrary one perpendicular to the normal.
+    /// </summary>
+    template<typename T>
+    static void FinishTangents(const Vector3Base<T>* normals, const Vector3Base<T>* sums, const size_t count, Vector4Base<T>* tangents)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto& normal = normals[i];
+            const auto& bitangent = sums[i * 2 + 1];
+
+            // Gram-Schmidt
+            auto tangent = sums[i * 2] - normal * Vector3Base<T>::Dot(normal, sums[i * 2]);
+            const auto lengthSquared = tangent.LengthSquared();
+
+            if (lengthSquared > T(0))
+                tangent *= T(1) / Math::Sqrt(lengthSquared);
+            else
+            {
+                const auto axis = Math::Abs(normal.x) < T(0.9) ? Vector3Base<T>(T(1), T(0), T(0)) : Vector3Base<T>(T(0), T(1), T(0));
+                tangent = Vector3Base<T>::Cross(axis, normal);
+                FinishNormals(&tangent, 1);
+            }
+
+            const auto handedness = Vector3Base<T>::Dot(Vector3Base<T>::Cross(normal, tangent), bitangent) < T(0) ? T(-1) : T(1);
+            tangents[i] = Vector4Base<T>(tangent.x, tangent.y, tangent.z, handedness);
+        }
+    }
+
+private:
+    /// <summary>
+    ///     Returns Cross(p1 - p0, p2 - p0) and the corner weights it has to be multiplied by.
+    /// </summary>
+    template<typename T>
+    static Vector3Base<T> GetTriangleNormal(const Vector3Base<T>& p0, const Vector3Base<T>& p1, const Vector3Base<T>& p2,
+        const NormalWeighting weighting, T (&weights)[3])
+    {
+        const auto edge01 = p1 - p0;
+        const auto edge02 = p2 - p0;
+        const auto normal = Vector3Base<T>::Cross(edge01, edge02);
+
+        if (weighting == NormalWeighting::Area)
+        {
+            weights[0] = weights[1] = weights[2] = T(1);
+            return normal;
+        }
+
+        // Same as SimdKernels::TriangleNormals, the corner angles divided by the normal length
+        const auto edge12 = p2 - p1;
+        const auto length = normal.Length();
+        const auto scale = length > T(0) ? T(1) / length : T(0);
+
+        weights[0] = std::atan2(length, Vector3Base<T>::Dot(edge01, edge02)) * scale;
+        weights[1] = std::atan2(length, -Vector3Base<T>::Dot(edge01, edge12)) * scale;
+        weights[2] = std::atan2(length, Vector3Base<T>::Dot(edge02, edge12)) * scale;
+        return normal;
+    }
+};
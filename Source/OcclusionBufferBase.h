@@ -0,0 +1,675 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "Cpu.h"
+#include "SimdKernels.h"
+#include "Parallel.h"
+#include "Vector3Base.h"
+#include "Vector4Base.h"
+#include "Matrix4x4Base.h"
+#include "BoundingBoxBase.h"
+#include "BoundingSphereBase.h"
+
+/// <summary>
+///     Software occlusion culling buffer.
+///     Occluder triangles are transformed, clipped against the near plane and binned into screen tiles,
+///     the tiles are then rasterized in parallel into a low resolution depth buffer (4 pixels at a time),
+///     with the farthest depth of every 8x8 pixel block kept as a second, hierarchical level.
+///     Occludees are tested with the screen rectangle and the nearest depth of their bounds,
+///     most of them are resolved by the block level alone.
+///     Depth follows the projection convention of the library, 0 at the near and 1 at the far plane.
+/// </summary>
+/// <remarks>
+///     Usage: Clear, AddOccluder for every occluder mesh, Rasterize, then IsVisible/Cull.
+///     The depth is sampled at the pixel centers, so occluders thinner than a pixel may not occlude anything.
+/// </remarks>
+template<typename T>
+class OcclusionBufferBase
+{
+public:
+    static const uint32_t TileWidth = 32;
+    static const uint32_t TileHeight = 16;
+    static const uint32_t BlockSize = 8;
+
+private:
+    struct Triangle
+    {
+        // Edge functions a * x + b * y + c, positive inside, and the depth plane
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        float depthA;
+        float depthB;
+        float depthC;
+
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+    };
+
+public:
+    /// <summary>
+    ///     Creates the buffer, the resolution is rounded up to whole tiles.
+    /// </summary>
+    /// <param name="width">The horizontal resolution.</param>
+    /// <param name="height">The vertical resolution.</param>
+    explicit OcclusionBufferBase(const uint32_t width = 256, const uint32_t height = 128)
+    {
+        m_tilesX = Math::Max((width + TileWidth - 1) / TileWidth, 1u);
+        m_tilesY = Math::Max((height + TileHeight - 1) / TileHeight, 1u);
+        m_width = m_tilesX * TileWidth;
+        m_height = m_tilesY * TileHeight;
+
+        m_depth.resize(size_t(m_width) * m_height, 1.0f);
+        m_blockDepth.resize(size_t(m_width / BlockSize) * (m_height / BlockSize), 1.0f);
+        m_bins.resize(size_t(m_tilesX) * m_tilesY);
+
+#if SIMD_X86
+        m_useSSE2 = Cpu::GetSimdLevel() >= SimdLevel::SSE2;
+#endif
+    }
+
+public:
+    /// <summary>
+    ///     Starts a new frame, removes all occluders.
+    /// </summary>
+    /// <param name="viewProjection">The camera view-projection matrix.</param>
+    void Clear(const Matrix4x4Base<T>& viewProjection)
+    {
+        m_viewProjection = viewProjection;
+        m_triangles.clear();
+
+        for (auto& bin : m_bins)
+            bin.clear();
+    }
+
+    /// <summary>
+    ///     Transforms, clips and bins the triangles of an occluder mesh. Both sides of the triangles occlude.
+    /// </summary>
+    /// <param name="vertices">The vertices.</param>
+    /// <param name="vertexCount">The vertex count.</param>
+    /// <param name="indices">The triangle list indices.</param>
+    /// <param name="triangleCount">The triangle count.</param>
+    /// <param name="world">The world matrix of the mesh.</param>
+    void AddOccluder(const Vector3Base<T>* vertices, const size_t vertexCount, const uint32_t* indices, const size_t triangleCount, const Matrix4x4Base<T>& world)
+    {
+        const auto matrix = world * m_viewProjection;
+
+        m_clipVertices.resize(vertexCount);
+        for (auto i = size_t(0); i < vertexCount; i++)
+        {
+            const auto& vertex = vertices[i];
+            m_clipVertices[i] = Vector4Base<float>(
+                static_cast<float>(vertex.x * matrix.m11 + vertex.y * matrix.m21 + vertex.z * matrix.m31 + matrix.m41),
+                static_cast<float>(vertex.x * matrix.m12 + vertex.y * matrix.m22 + vertex.z * matrix.m32 + matrix.m42),
+                static_cast<float>(vertex.x * matrix.m13 + vertex.y * matrix.m23 + vertex.z * matrix.m33 + matrix.m43),
+                static_cast<float>(vertex.x * matrix.m14 + vertex.y * matrix.m24 + vertex.z * matrix.m34 + matrix.m44));
+        }
+
+        for (auto i = size_t(0); i < triangleCount; i++)
+        {
+            const auto& v0 = m_clipVertices[indices[i * 3 + 0]];
+            const auto& v1 = m_clipVertices[indices[i * 3 + 1]];
+            const auto& v2 = m_clipVertices[indices[i * 3 + 2]];
+
+            // Trivial rejection against the frustum sides
+            if ((v0.x > v0.w && v1.x > v1.w && v2.x > v2.w) || (v0.x < -v0.w && v1.x < -v1.w && v2.x < -v2.w) ||
+                (v0.y > v0.w && v1.y > v1.w && v2.y > v2.w) || (v0.y < -v0.w && v1.y < -v1.w && v2.y < -v2.w))
+                continue;
+
+            ClipAndAddTriangle(v0, v1, v2);
+        }
+    }
+
+    /// <summary>
+    ///     Rasterizes the binned occluders, the tiles are processed in parallel.
+    /// </summary>
+    void Rasterize()
+    {
+        Parallel::For(m_bins.size(), 1, [&](const size_t begin, const size_t end)
+        {
+            for (auto tile = begin; tile < end; tile++)
+                RasterizeTile(static_cast<uint32_t>(tile));
+        });
+    }
+
+    /// <summary>
+    ///     Checks if any part of the box may be visible. Boxes crossing the near plane are always visible,
+    ///     boxes outside of the screen are not.
+    /// </summary>
+    bool IsVisible(const BoundingBoxBase<T>& box) const
+    {
+        // The clip coordinates of the corners are the ones of the minimum corner plus the scaled matrix rows
+        const auto minimum = box.Minimum();
+        const auto& m = m_viewProjection;
+
+        const float origin[4] = {
+            static_cast<float>(minimum.x * m.m11 + minimum.y * m.m21 + minimum.z * m.m31 + m.m41),
+            static_cast<float>(minimum.x * m.m12 + minimum.y * m.m22 + minimum.z * m.m32 + m.m42),
+            static_cast<float>(minimum.x * m.m13 + minimum.y * m.m23 + minimum.z * m.m33 + m.m43),
+            static_cast<float>(minimum.x * m.m14 + minimum.y * m.m24 + minimum.z * m.m34 + m.m44)
+        };
+
+        float axes[3][4];
+        for (auto i = 0; i < 4; i++)
+        {
+            axes[0][i] = static_cast<float>(box.size.x * m[i]);
+            axes[1][i] = static_cast<float>(box.size.y * m[4 + i]);
+            axes[2][i] = static_cast<float>(box.size.z * m[8 + i]);
+        }
+
+        // Screen rectangle (minimum x, minimum y, maximum x, maximum y) and nearest depth of the corners
+        float bounds[5];
+
+#if SIMD_X86
+        const auto crossesNearPlane = m_useSSE2 ? ProjectBoxSSE2(origin, axes, bounds) : ProjectBoxScalar(origin, axes, bounds);
+#else
+        const auto crossesNearPlane = ProjectBoxScalar(origin, axes, bounds);
+#endif
+
+        if (crossesNearPlane)
+            return true;
+
+        const auto screenMinimumX = bounds[0];
+        const auto screenMinimumY = bounds[1];
+        const auto screenMaximumX = bounds[2];
+        const auto screenMaximumY = bounds[3];
+        const auto nearestDepth = bounds[4];
+
+        // The occluders are sampled at the pixel centers, they can cover up to half a pixel more than they should,
+        // the tested rectangle is grown by a pixel so the occludees visible through such gaps are not culled
+        const auto minX = FloorToPixel(screenMinimumX - 1.0f, m_width);
+        const auto minY = FloorToPixel(screenMinimumY - 1.0f, m_height);
+        const auto maxX = CeilToPixel(screenMaximumX + 1.0f, m_width);
+        const auto maxY = CeilToPixel(screenMaximumY + 1.0f, m_height);
+
+        if (minX >= maxX || minY >= maxY)
+            return false;
+
+        return IsRectangleVisible(minX, minY, maxX, maxY, nearestDepth);
+    }
+
+    /// <summary>
+    ///     Checks if any part of the sphere may be visible, the sphere is tested as its bounding box.
+    /// </summary>
+    bool IsVisible(const BoundingSphereBase<T>& sphere) const
+    {
+        return IsVisible(BoundingBoxBase<T>(sphere.center, Vector3Base<T>(sphere.radius * T(2))));
+    }
+
+    /// <summary>
+    ///     Culls an array of bounding boxes against the occluders.
+    /// </summary>
+    /// <param name="boxes">The bounding boxes.</param>
+    /// <param name="count">The bounding box count.</param>
+    /// <param name="visibleIndices">The output indices of the visible boxes, has to have room for count indices.</param>
+    /// <param name="firstIndex">The value added to the reported indices, used when culling a sub-range.</param>
+    /// <returns>The visible box count.</returns>
+    size_t Cull(const BoundingBoxBase<T>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0) const
+    {
+        auto visibleCount = size_t(0);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i);
+            visibleCount += IsVisible(boxes[i]) ? 1 : 0;
+        }
+
+        return visibleCount;
+    }
+
+    /// <summary>
+    ///     Culls an array of bounding spheres against the occluders.
+    /// </summary>
+    /// <param name="spheres">The bounding spheres.</param>
+    /// <param name="count">The bounding sphere count.</param>
+    /// <param name="visibleIndices">The output indices of the visible spheres, has to have room for count indices.</param>
+    /// <param name="firstIndex">The value added to the reported indices, used when culling a sub-range.</param>
+    /// <returns>The visible sphere count.</returns>
+    size_t Cull(const BoundingSphereBase<T>* spheres, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0) const
+    {
+        auto visibleCount = size_t(0);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i);
+            visibleCount += IsVisible(spheres[i]) ? 1 : 0;
+        }
+
+        return visibleCount;
+    }
+
+    /// <summary>
+    ///     Returns the horizontal resolution (a multiple of TileWidth).
+    /// </summary>
+    uint32_t GetWidth() const
+    {
+        return m_width;
+    }
+
+    /// <summary>
+    ///     Returns the vertical resolution (a multiple of TileHeight).
+    /// </summary>
+    uint32_t GetHeight() const
+    {
+        return m_height;
+    }
+
+    /// <summary>
+    ///     Returns the depth buffer, row by row from the top of the screen.
+    /// </summary>
+    const float* GetDepth() const
+    {
+        return m_depth.data();
+    }
+
+    /// <summary>
+    ///     Returns the number of triangles binned since the last Clear.
+    /// </summary>
+    size_t GetTriangleCount() const
+    {
+        return m_triangles.size();
+    }
+
+private:
+    // The coordinates are clamped before the conversions, the ones of vertices close to the camera plane can be huge
+    static int32_t FloorToPixel(const float coordinate, const uint32_t resolution)
+    {
+        return Math::FloorToInt(Math::Clamp(coordinate, 0.0f, static_cast<float>(resolution)));
+    }
+
+    static int32_t CeilToPixel(const float coordinate, const uint32_t resolution)
+    {
+        return Math::CeilToInt(Math::Clamp(coordinate, 0.0f, static_cast<float>(resolution)));
+    }
+
+    void ClipAndAddTriangle(const Vector4Base<float>& v0, const Vector4Base<float>& v1, const Vector4Base<float>& v2)
+    {
+        const Vector4Base<float> input[3] = { v0, v1, v2 };
+
+        auto insideCount = 0;
+        for (const auto& vertex : input)
+            insideCount += vertex.z >= 0.0f ? 1 : 0;
+
+        if (insideCount == 0)
+            return;
+
+        if (insideCount == 3)
+        {
+            AddTriangle(v0, v1, v2);
+            return;
+        }
+
+        // Clip the polygon against the near plane (z = 0), the result has 3 or 4 vertices
+        Vector4Base<float> polygon[4];
+        auto polygonSize = 0;
+
+        for (auto i = 0; i < 3; i++)
+        {
+            const auto& current = input[i];
+            const auto& next = input[(i + 1) % 3];
+
+            if (current.z >= 0.0f)
+                polygon[polygonSize++] = current;
+
+            if ((current.z >= 0.0f) != (next.z >= 0.0f))
+            {
+                const auto amount = current.z / (current.z - next.z);
+                polygon[polygonSize++] = current + (next - current) * amount;
+            }
+        }
+
+        AddTriangle(polygon[0], polygon[1], polygon[2]);
+
+        if (polygonSize == 4)
+            AddTriangle(polygon[0], polygon[2], polygon[3]);
+    }
+
+    void AddTriangle(const Vector4Base<float>& v0, const Vector4Base<float>& v1, const Vector4Base<float>& v2)
+    {
+        const Vector4Base<float>* clip[3] = { &v0, &v1, &v2 };
+
+        float x[3];
+        float y[3];
+        float z[3];
+        for (auto i = 0; i < 3; i++)
+        {
+            const auto inverseW = 1.0f / clip[i]->w;
+            x[i] = (clip[i]->x * inverseW * 0.5f + 0.5f) * m_width;
+            y[i] = (0.5f - clip[i]->y * inverseW * 0.5f) * m_height;
+            z[i] = clip[i]->z * inverseW;
+        }
+
+        Triangle triangle;
+        triangle.minX = FloorToPixel(Math::Min(x[0], x[1], x[2]), m_width);
+        triangle.minY = FloorToPixel(Math::Min(y[0], y[1], y[2]), m_height);
+        triangle.maxX = CeilToPixel(Math::Max(x[0], x[1], x[2]), m_width);
+        triangle.maxY = CeilToPixel(Math::Max(y[0], y[1], y[2]), m_height);
+
+        if (triangle.minX >= triangle.maxX || triangle.minY >= triangle.maxY)
+            return;
+
+        // Edge i is opposite of vertex i, its function is twice the signed area of the sub-triangle
+        // formed with the pixel, which makes them the unnormalized barycentric coordinates
+        for (auto i = 0; i < 3; i++)
+        {
+            const auto a = (i + 1) % 3;
+            const auto b = (i + 2) % 3;
+
+            triangle.edgeA[i] = y[a] - y[b];
+            triangle.edgeB[i] = x[b] - x[a];
+            triangle.edgeC[i] = x[a] * y[b] - y[a] * x[b];
+        }
+
+        auto area = triangle.edgeA[0] * x[0] + triangle.edgeB[0] * y[0] + triangle.edgeC[0];
+        if (area == 0.0f)
+            return;
+
+        // Both windings are rasterized, the back-facing ones are flipped
+        if (area < 0.0f)
+        {
+            for (auto i = 0; i < 3; i++)
+            {
+                triangle.edgeA[i] = -triangle.edgeA[i];
+                triangle.edgeB[i] = -triangle.edgeB[i];
+                triangle.edgeC[i] = -triangle.edgeC[i];
+            }
+
+            area = -area;
+        }
+
+        const auto inverseArea = 1.0f / area;
+        triangle.depthA = (triangle.edgeA[0] * z[0] + triangle.edgeA[1] * z[1] + triangle.edgeA[2] * z[2]) * inverseArea;
+        triangle.depthB = (triangle.edgeB[0] * z[0] + triangle.edgeB[1] * z[1] + triangle.edgeB[2] * z[2]) * inverseArea;
+        triangle.depthC = (triangle.edgeC[0] * z[0] + triangle.edgeC[1] * z[1] + triangle.edgeC[2] * z[2]) * inverseArea;
+
+        const auto index = static_cast<uint32_t>(m_triangles.size());
+        m_triangles.push_back(triangle);
+
+        const auto tileMinX = static_cast<uint32_t>(triangle.minX) / TileWidth;
+        const auto tileMinY = static_cast<uint32_t>(triangle.minY) / TileHeight;
+        const auto tileMaxX = static_cast<uint32_t>(triangle.maxX - 1) / TileWidth;
+        const auto tileMaxY = static_cast<uint32_t>(triangle.maxY - 1) / TileHeight;
+
+        for (auto tileY = tileMinY; tileY <= tileMaxY; tileY++)
+        {
+            for (auto tileX = tileMinX; tileX <= tileMaxX; tileX++)
+                m_bins[tileY * m_tilesX + tileX].push_back(index);
+        }
+    }
+
+    void RasterizeTile(const uint32_t tile)
+    {
+        const auto tileMinX = static_cast<int32_t>((tile % m_tilesX) * TileWidth);
+        const auto tileMinY = static_cast<int32_t>((tile / m_tilesX) * TileHeight);
+        const auto tileMaxX = tileMinX + static_cast<int32_t>(TileWidth);
+        const auto tileMaxY = tileMinY + static_cast<int32_t>(TileHeight);
+
+        for (auto y = tileMinY; y < tileMaxY; y++)
+        {
+            const auto row = m_depth.data() + size_t(y) * m_width;
+            std::fill(row + tileMinX, row + tileMaxX, 1.0f);
+        }
+
+        for (const auto index : m_bins[tile])
+        {
+            const auto& triangle = m_triangles[index];
+
+            // The rows are processed in groups of 4 pixels, the tiles are aligned to 4
+            const auto minX = Math::Max(triangle.minX, tileMinX) & ~3;
+            const auto minY = Math::Max(triangle.minY, tileMinY);
+            const auto maxX = Math::Min(triangle.maxX, tileMaxX);
+            const auto maxY = Math::Min(triangle.maxY, tileMaxY);
+
+#if SIMD_X86
+            if (m_useSSE2)
+            {
+                RasterizeTriangleSSE2(triangle, minX, minY, maxX, maxY, m_depth.data(), m_width);
+                continue;
+            }
+#endif
+            RasterizeTriangleScalar(triangle, minX, minY, maxX, maxY, m_depth.data(), m_width);
+        }
+
+        // Update the farthest depth of the blocks
+        const auto blocksPerRow = m_width / BlockSize;
+
+        for (auto blockY = tileMinY; blockY < tileMaxY; blockY += BlockSize)
+        {
+            for (auto blockX = tileMinX; blockX < tileMaxX; blockX += BlockSize)
+            {
+                auto farthest = 0.0f;
+
+                for (auto y = blockY; y < blockY + static_cast<int32_t>(BlockSize); y++)
+                {
+                    const auto row = m_depth.data() + size_t(y) * m_width;
+                    for (auto x = blockX; x < blockX + static_cast<int32_t>(BlockSize); x++)
+                        farthest = Math::Max(farthest, row[x]);
+                }
+
+                m_blockDepth[(blockY / BlockSize) * blocksPerRow + blockX / BlockSize] = farthest;
+            }
+        }
+    }
+
+    static void RasterizeTriangleScalar(const Triangle& triangle, const int32_t minX, const int32_t minY, const int32_t maxX, const int32_t maxY, float* depth, const uint32_t stride)
+    {
+        for (auto y = minY; y < maxY; y++)
+        {
+            const auto pixelY = static_cast<float>(y) + 0.5f;
+            const auto row = depth + size_t(y) * stride;
+
+            for (auto x = minX; x < maxX; x += 4)
+            {
+                for (auto lane = 0; lane < 4; lane++)
+                {
+                    const auto pixelX = static_cast<float>(x + lane) + 0.5f;
+
+                    auto inside = true;
+                    for (auto i = 0; i < 3; i++)
+                        inside &= triangle.edgeA[i] * pixelX + triangle.edgeB[i] * pixelY + triangle.edgeC[i] >= 0.0f;
+
+                    const auto z = triangle.depthA * pixelX + triangle.depthB * pixelY + triangle.depthC;
+                    if (inside)
+                        row[x + lane] = Math::Min(row[x + lane], z);
+                }
+            }
+        }
+    }
+
+#if SIMD_X86
+    SIMD_TARGET_SSE2 static void RasterizeTriangleSSE2(const Triangle& triangle, const int32_t minX, const int32_t minY, const int32_t maxX, const int32_t maxY, float* depth, const uint32_t stride)
+    {
+        const auto zero = _mm_setzero_ps();
+        const auto pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(minX)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+
+        __m128 edgeStep[3];
+        __m128 edgeRow[3];
+        for (auto i = 0; i < 3; i++)
+        {
+            edgeStep[i] = _mm_set1_ps(triangle.edgeA[i] * 4.0f);
+            edgeRow[i] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[i]), pixelX), _mm_set1_ps(triangle.edgeC[i]));
+        }
+
+        const auto depthStep = _mm_set1_ps(triangle.depthA * 4.0f);
+        const auto depthRow = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.depthA), pixelX), _mm_set1_ps(triangle.depthC));
+
+        for (auto y = minY; y < maxY; y++)
+        {
+            const auto pixelY = static_cast<float>(y) + 0.5f;
+            const auto row = depth + size_t(y) * stride;
+
+            auto edge0 = _mm_add_ps(edgeRow[0], _mm_set1_ps(triangle.edgeB[0] * pixelY));
+            auto edge1 = _mm_add_ps(edgeRow[1], _mm_set1_ps(triangle.edgeB[1] * pixelY));
+            auto edge2 = _mm_add_ps(edgeRow[2], _mm_set1_ps(triangle.edgeB[2] * pixelY));
+            auto z = _mm_add_ps(depthRow, _mm_set1_ps(triangle.depthB * pixelY));
+
+            for (auto x = minX; x < maxX; x += 4)
+            {
+                const auto inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+
+                if (_mm_movemask_ps(inside) != 0)
+                {
+                    const auto current = _mm_loadu_ps(row + x);
+                    const auto nearest = _mm_min_ps(current, z);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+                }
+
+                edge0 = _mm_add_ps(edge0, edgeStep[0]);
+                edge1 = _mm_add_ps(edge1, edgeStep[1]);
+                edge2 = _mm_add_ps(edge2, edgeStep[2]);
+                z = _mm_add_ps(z, depthStep);
+            }
+        }
+    }
+#endif
+
+    bool ProjectBoxScalar(const float origin[4], const float axes[3][4], float bounds[5]) const
+    {
+        // Component-major, corner i adds axis j when bit j of i is set
+        float clip[4][8];
+        for (auto j = 0; j < 4; j++)
+        {
+            clip[j][0] = origin[j];
+            clip[j][1] = origin[j] + axes[0][j];
+
+            for (auto i = 0; i < 2; i++)
+                clip[j][2 + i] = clip[j][i] + axes[1][j];
+
+            for (auto i = 0; i < 4; i++)
+                clip[j][4 + i] = clip[j][i] + axes[2][j];
+        }
+
+        auto crossesNearPlane = false;
+        bounds[0] = bounds[1] = bounds[4] = std::numeric_limits<float>::max();
+        bounds[2] = bounds[3] = std::numeric_limits<float>::lowest();
+
+        for (auto i = 0; i < 8; i++)
+        {
+            crossesNearPlane |= clip[2][i] < 0.0f || clip[3][i] <= 0.0f;
+
+            const auto inverseW = 1.0f / clip[3][i];
+            const auto screenX = (clip[0][i] * inverseW * 0.5f + 0.5f) * m_width;
+            const auto screenY = (0.5f - clip[1][i] * inverseW * 0.5f) * m_height;
+
+            bounds[0] = Math::Min(bounds[0], screenX);
+            bounds[1] = Math::Min(bounds[1], screenY);
+            bounds[2] = Math::Max(bounds[2], screenX);
+            bounds[3] = Math::Max(bounds[3], screenY);
+            bounds[4] = Math::Min(bounds[4], clip[2][i] * inverseW);
+        }
+
+        return crossesNearPlane;
+    }
+
+#if SIMD_X86
+    SIMD_TARGET_SSE2 static float HorizontalMin(__m128 value)
+    {
+        value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(_mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1))));
+    }
+
+    SIMD_TARGET_SSE2 static float HorizontalMax(__m128 value)
+    {
+        value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(_mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1))));
+    }
+
+    SIMD_TARGET_SSE2 bool ProjectBoxSSE2(const float origin[4], const float axes[3][4], float bounds[5]) const
+    {
+        // Corners 0-3 in the low and 4-7 in the high registers, one register per clip component
+        __m128 low[4];
+        __m128 high[4];
+        for (auto j = 0; j < 4; j++)
+        {
+            low[j] = _mm_add_ps(_mm_set1_ps(origin[j]), _mm_setr_ps(0.0f, axes[0][j], axes[1][j], axes[0][j] + axes[1][j]));
+            high[j] = _mm_add_ps(low[j], _mm_set1_ps(axes[2][j]));
+        }
+
+        const auto zero = _mm_setzero_ps();
+        const auto behind = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(low[2], zero), _mm_cmple_ps(low[3], zero)),
+            _mm_or_ps(_mm_cmplt_ps(high[2], zero), _mm_cmple_ps(high[3], zero)));
+
+        if (_mm_movemask_ps(behind) != 0)
+            return true;
+
+        const auto half = _mm_set1_ps(0.5f);
+        const auto width = _mm_set1_ps(static_cast<float>(m_width));
+        const auto height = _mm_set1_ps(static_cast<float>(m_height));
+
+        const auto inverseWLow = _mm_div_ps(_mm_set1_ps(1.0f), low[3]);
+        const auto inverseWHigh = _mm_div_ps(_mm_set1_ps(1.0f), high[3]);
+
+        const auto xLow = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(low[0], inverseWLow), half), half), width);
+        const auto xHigh = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(high[0], inverseWHigh), half), half), width);
+        const auto yLow = _mm_mul_ps(_mm_sub_ps(half, _mm_mul_ps(_mm_mul_ps(low[1], inverseWLow), half)), height);
+        const auto yHigh = _mm_mul_ps(_mm_sub_ps(half, _mm_mul_ps(_mm_mul_ps(high[1], inverseWHigh), half)), height);
+        const auto depth = _mm_min_ps(_mm_mul_ps(low[2], inverseWLow), _mm_mul_ps(high[2], inverseWHigh));
+
+        bounds[0] = HorizontalMin(_mm_min_ps(xLow, xHigh));
+        bounds[1] = HorizontalMin(_mm_min_ps(yLow, yHigh));
+        bounds[2] = HorizontalMax(_mm_max_ps(xLow, xHigh));
+        bounds[3] = HorizontalMax(_mm_max_ps(yLow, yHigh));
+        bounds[4] = HorizontalMin(depth);
+
+        return false;
+    }
+#endif
+
+    bool IsRectangleVisible(const int32_t minX, const int32_t minY, const int32_t maxX, const int32_t maxY, const float nearestDepth) const
+    {
+        const auto blocksPerRow = m_width / BlockSize;
+        const auto blockSize = static_cast<int32_t>(BlockSize);
+
+        for (auto blockY = minY / blockSize; blockY <= (maxY - 1) / blockSize; blockY++)
+        {
+            for (auto blockX = minX / blockSize; blockX <= (maxX - 1) / blockSize; blockX++)
+            {
+                // Every pixel of the block is nearer than the occludee
+                if (m_blockDepth[blockY * blocksPerRow + blockX] < nearestDepth)
+                    continue;
+
+                const auto y0 = Math::Max(blockY * blockSize, minY);
+                const auto y1 = Math::Min(blockY * blockSize + blockSize, maxY);
+                const auto x0 = Math::Max(blockX * blockSize, minX);
+                const auto x1 = Math::Min(blockX * blockSize + blockSize, maxX);
+
+                for (auto y = y0; y < y1; y++)
+                {
+                    const auto row = m_depth.data() + size_t(y) * m_width;
+                    for (auto x = x0; x < x1; x++)
+                    {
+                        if (row[x] >= nearestDepth)
+                            return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+private:
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_tilesX = 0;
+    uint32_t m_tilesY = 0;
+    bool m_useSSE2 = false;
+
+    Matrix4x4Base<T> m_viewProjection;
+
+    std::vector<float> m_depth;
+    std::vector<float> m_blockDepth;
+    std::vector<Triangle> m_triangles;
+    std::vector<std::vector<uint32_t>> m_bins;
+    std::vector<Vector4Base<float>> m_clipVertices;
+};
@@ -0,0 +1,360 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <array>
+#include <limits>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "Quaternion.h"
+#include "Matrix4x4Base.h"
+#include "BoundingBoxBase.h"
+
+template<typename T>
+struct OrientedBoundingBoxBase
+{
+public:
+    /// <summary>
+    /// Default constructor
+    /// Sets 0 to the center and extents, the axes are the world axes
+    /// </summary>
+    OrientedBoundingBoxBase()
+    {
+        center = Vector3Base<T>::Zero;
+        extents = Vector3Base<T>::Zero;
+        axes[0] = Vector3Base<T>::UnitX;
+        axes[1] = Vector3Base<T>::UnitY;
+        axes[2] = Vector3Base<T>::UnitZ;
+    }
+
+    /// <summary>
+    /// Constructs OrientedBoundingBox with given center, half-extents and orthonormal axes.
+    /// </summary>
+    /// <param name="center">The center of the OrientedBoundingBox.</param>
+    /// <param name="extents">The half-extents along the axes.</param>
+    /// <param name="axisX">The local X axis.</param>
+    /// <param name="axisY">The local Y axis.</param>
+    /// <param name="axisZ">The local Z axis.</param>
+    explicit OrientedBoundingBoxBase(const Vector3Base<T>& center, const Vector3Base<T>& extents,
+        const Vector3Base<T>& axisX, const Vector3Base<T>& axisY, const Vector3Base<T>& axisZ)
+    {
+        this->center = center;
+        this->extents = extents;
+        axes[0] = axisX;
+        axes[1] = axisY;
+        axes[2] = axisZ;
+    }
+
+    /// <summary>
+    /// Constructs OrientedBoundingBox with given center, half-extents and rotation.
+    /// </summary>
+    /// <param name="center">The center of the OrientedBoundingBox.</param>
+    /// <param name="extents">The half-extents along the rotated axes.</param>
+    /// <param name="rotation">The rotation, has to be normalized.</param>
+    explicit OrientedBoundingBoxBase(const Vector3Base<T>& center, const Vector3Base<T>& extents, const Quaternion& rotation)
+    {
+        this->center = center;
+        this->extents = extents;
+        axes[0] = Vector3Base<T>::Transform(Vector3Base<T>::UnitX, rotation);
+        axes[1] = Vector3Base<T>::Transform(Vector3Base<T>::UnitY, rotation);
+        axes[2] = Vector3Base<T>::Transform(Vector3Base<T>::UnitZ, rotation);
+    }
+
+public:
+    /// <summary>
+    /// Returns the radius of the projection of this box onto the direction
+    /// (scaled by the direction length when it is not normalized).
+    /// </summary>
+    T GetProjectedRadius(const Vector3Base<T>& direction) const
+    {
+        return extents.x * Math::Abs(Vector3Base<T>::Dot(direction, axes[0]))
+            + extents.y * Math::Abs(Vector3Base<T>::Dot(direction, axes[1]))
+            + extents.z * Math::Abs(Vector3Base<T>::Dot(direction, axes[2]));
+    }
+
+    /// <summary>
+    /// Returns the 8 corners of this box, corner i is at the positive extent of axis j when bit j of i is set.
+    /// </summary>
+    std::array<Vector3Base<T>, 8> GetCorners() const
+    {
+        std::array<Vector3Base<T>, 8> corners = {};
+
+        const auto x = axes[0] * extents.x;
+        const auto y = axes[1] * extents.y;
+        const auto z = axes[2] * extents.z;
+
+        for (auto i = 0; i < 8; i++)
+        {
+            corners[i] = center
+                + ((i & 1) != 0 ? x : -x)
+                + ((i & 2) != 0 ? y : -y)
+                + ((i & 4) != 0 ? z : -z);
+        }
+
+        return corners;
+    }
+
+    /// <summary>
+    /// Returns the smallest axis-aligned BoundingBox containing this box
+    /// </summary>
+    BoundingBoxBase<T> ToBoundingBox() const
+    {
+        auto halfSize = Vector3Base<T>::Zero;
+
+        for (auto i = 0; i < 3; i++)
+            halfSize += Vector3Base<T>::Abs(axes[i]) * extents[i];
+
+        return BoundingBoxBase<T>(center, halfSize * T(2));
+    }
+
+public:
+    /// <summary>
+    /// Creates an OrientedBoundingBox of the given points, aligned with the principal axes of their covariance.
+    /// Tight for elongated point sets, the axes are arbitrary when the point spread is about the same in all directions
+    /// </summary>
+    static OrientedBoundingBoxBase<T> FromPoints(const Vector3Base<T>* points, const size_t count)
+    {
+        if (count == 0)
+            return OrientedBoundingBoxBase<T>();
+
+        auto mean = Vector3Base<T>::Zero;
+        for (auto i = size_t(0); i < count; i++)
+            mean += points[i];
+        mean /= static_cast<T>(count);
+
+        // The covariance is accumulated around the mean, so it does not lose precision far from the origin
+        T covariance[3][3] = {};
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto offset = points[i] - mean;
+
+            for (auto row = 0; row < 3; row++)
+            {
+                for (auto column = row; column < 3; column++)
+                    covariance[row][column] += offset[row] * offset[column];
+            }
+        }
+
+        for (auto row = 1; row < 3; row++)
+        {
+            for (auto column = 0; column < row; column++)
+                covariance[row][column] = covariance[column][row];
+        }
+
+        OrientedBoundingBoxBase<T> box;
+        GetEigenvectors(covariance, box.axes);
+
+        Vector3Base<T> minimum(std::numeric_limits<T>::max());
+        Vector3Base<T> maximum(std::numeric_limits<T>::lowest());
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto offset = points[i] - mean;
+
+            for (auto axis = 0; axis < 3; axis++)
+            {
+                const auto projection = Vector3Base<T>::Dot(offset, box.axes[axis]);
+                minimum[axis] = Math::Min(minimum[axis], projection);
+                maximum[axis] = Math::Max(maximum[axis], projection);
+            }
+        }
+
+        box.center = mean;
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            box.center += box.axes[axis] * ((minimum[axis] + maximum[axis]) * T(0.5));
+            box.extents[axis] = (maximum[axis] - minimum[axis]) * T(0.5);
+        }
+
+        return box;
+    }
+
+    /// <summary>
+    /// Creates an OrientedBoundingBox from a local-space BoundingBox and a transform (rotation, scale and translation)
+    /// </summary>
+    static OrientedBoundingBoxBase<T> FromBoundingBox(const BoundingBoxBase<T>& box, const Matrix4x4Base<T>& transform)
+    {
+        OrientedBoundingBoxBase<T> result;
+        result.center = Vector3Base<T>::Transform(box.center, transform);
+
+        const Vector3Base<T> rows[3] = {
+            Vector3Base<T>(transform.m11, transform.m12, transform.m13),
+            Vector3Base<T>(transform.m21, transform.m22, transform.m23),
+            Vector3Base<T>(transform.m31, transform.m32, transform.m33)
+        };
+
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            const auto scale = rows[axis].Length();
+            result.axes[axis] = Math::IsZero(scale) ? rows[axis] : rows[axis] / scale;
+            result.extents[axis] = box.size[axis] * T(0.5) * scale;
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Check if two OrientedBoundingBoxes intersect each other, using the 15 separating axes:
+    /// the face normals of both boxes and the cross products of their edge directions
+    /// </summary>
+    static bool Intersects(const OrientedBoundingBoxBase<T>& a, const OrientedBoundingBoxBase<T>& b)
+    {
+        // b's axes expressed in a's frame, the epsilon keeps the edge-edge axes from producing
+        // false separations when two edges are (nearly) parallel and their cross product degenerates
+        const auto epsilon = T(Math::ZeroTolerance);
+
+        T rotation[3][3];
+        T absRotation[3][3];
+        for (auto i = 0; i < 3; i++)
+        {
+            for (auto j = 0; j < 3; j++)
+            {
+                rotation[i][j] = Vector3Base<T>::Dot(a.axes[i], b.axes[j]);
+                absRotation[i][j] = Math::Abs(rotation[i][j]) + epsilon;
+            }
+        }
+
+        const auto offset = b.center - a.center;
+        const T translation[3] = {
+            Vector3Base<T>::Dot(offset, a.axes[0]),
+            Vector3Base<T>::Dot(offset, a.axes[1]),
+            Vector3Base<T>::Dot(offset, a.axes[2])
+        };
+
+        // a's face normals
+        for (auto i = 0; i < 3; i++)
+        {
+            const auto rb = b.extents.x * absRotation[i][0] + b.extents.y * absRotation[i][1] + b.extents.z * absRotation[i][2];
+            if (Math::Abs(translation[i]) > a.extents[i] + rb)
+                return false;
+        }
+
+        // b's face normals
+        for (auto j = 0; j < 3; j++)
+        {
+            const auto ra = a.extents.x * absRotation[0][j] + a.extents.y * absRotation[1][j] + a.extents.z * absRotation[2][j];
+            const auto distance = translation[0] * rotation[0][j] + translation[1] * rotation[1][j] + translation[2] * rotation[2][j];
+            if (Math::Abs(distance) > ra + b.extents[j])
+                return false;
+        }
+
+        // Cross(a.axes[i], b.axes[j])
+        for (auto i = 0; i < 3; i++)
+        {
+            const auto i1 = (i + 1) % 3;
+            const auto i2 = (i + 2) % 3;
+
+            for (auto j = 0; j < 3; j++)
+            {
+                const auto j1 = (j + 1) % 3;
+                const auto j2 = (j + 2) % 3;
+
+                const auto ra = a.extents[i1] * absRotation[i2][j] + a.extents[i2] * absRotation[i1][j];
+                const auto rb = b.extents[j1] * absRotation[i][j2] + b.extents[j2] * absRotation[i][j1];
+                const auto distance = translation[i2] * rotation[i1][j] - translation[i1] * rotation[i2][j];
+                if (Math::Abs(distance) > ra + rb)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Check if an OrientedBoundingBox and a BoundingBox intersect each other
+    /// </summary>
+    static bool Intersects(const OrientedBoundingBoxBase<T>& a, const BoundingBoxBase<T>& b)
+    {
+        return Intersects(a, OrientedBoundingBoxBase<T>(b.center, b.size * T(0.5),
+            Vector3Base<T>::UnitX, Vector3Base<T>::UnitY, Vector3Base<T>::UnitZ));
+    }
+
+    /// <summary>
+    /// Check if point is within an OrientedBoundingBox
+    /// </summary>
+    static bool Contains(const OrientedBoundingBoxBase<T>& box, const Vector3Base<T>& point)
+    {
+        const auto offset = point - box.center;
+
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            if (Math::Abs(Vector3Base<T>::Dot(offset, box.axes[axis])) > box.extents[axis])
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    static void GetEigenvectors(T matrix[3][3], Vector3Base<T> eigenvectors[3])
+    {
+        // Cyclic Jacobi: every rotation zeroes one off-diagonal element of the symmetric matrix,
+        // the accumulated rotations are the eigenvectors. 3x3 matrices converge in a handful of sweeps.
+        T vectors[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+
+        for (auto sweep = 0; sweep < 32; sweep++)
+        {
+            const auto offDiagonal = matrix[0][1] * matrix[0][1] + matrix[0][2] * matrix[0][2] + matrix[1][2] * matrix[1][2];
+            const auto diagonal = matrix[0][0] * matrix[0][0] + matrix[1][1] * matrix[1][1] + matrix[2][2] * matrix[2][2];
+
+            if (offDiagonal <= diagonal * std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon())
+                break;
+
+            for (auto p = 0; p < 2; p++)
+            {
+                for (auto q = p + 1; q < 3; q++)
+                {
+                    if (matrix[p][q] == T(0))
+                        continue;
+
+                    const auto theta = (matrix[q][q] - matrix[p][p]) / (T(2) * matrix[p][q]);
+                    const auto t = (theta >= T(0) ? T(1) : T(-1)) / (Math::Abs(theta) + Math::Sqrt(theta * theta + T(1)));
+                    const auto c = T(1) / Math::Sqrt(t * t + T(1));
+                    const auto s = t * c;
+
+                    matrix[p][p] -= t * matrix[p][q];
+                    matrix[q][q] += t * matrix[p][q];
+                    matrix[p][q] = matrix[q][p] = T(0);
+
+                    const auto r = 3 - p - q;
+                    const auto rp = matrix[r][p];
+                    const auto rq = matrix[r][q];
+                    matrix[r][p] = matrix[p][r] = c * rp - s * rq;
+                    matrix[r][q] = matrix[q][r] = s * rp + c * rq;
+
+                    for (auto row = 0; row < 3; row++)
+                    {
+                        const auto vp = vectors[row][p];
+                        const auto vq = vectors[row][q];
+                        vectors[row][p] = c * vp - s * vq;
+                        vectors[row][q] = s * vp + c * vq;
+                    }
+                }
+            }
+        }
+
+        for (auto i = 0; i < 3; i++)
+            eigenvectors[i] = Vector3Base<T>(vectors[0][i], vectors[1][i], vectors[2][i]);
+
+        // Keep the basis right-handed
+        eigenvectors[2] = Vector3Base<T>::Cross(eigenvectors[0], eigenvectors[1]);
+    }
+
+public:
+    /// <summary>
+    /// Center of this OrientedBoundingBox
+    /// </summary>
+    Vector3Base<T> center;
+
+    /// <summary>
+    /// Half of the size of this OrientedBoundingBox along each of its axes
+    /// </summary>
+    Vector3Base<T> extents;
+
+    /// <summary>
+    /// The orthonormal local axes of this OrientedBoundingBox
+    /// </summary>
+    Vector3Base<T> axes[3];
+};
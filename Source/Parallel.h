@@ -0,0 +1,348 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "JobSystem.h"
+#include "Vector3Base.h"
+#include "Vector4Base.h"
+#include "Quaternion.h"
+#include "Matrix4x4Base.h"
+#include "BoundingBoxBase.h"
+#include "BoundingSphereBase.h"
+#include "OrientedBoundingBoxBase.h"
+#include "BoundingFrustumBase.h"
+#include "Skinning.h"
+#include "Mesh.h"
+
+/// <summary>
+///     Multithreaded overloads of the array kernels.
+///     The arrays are split into cache-sized chunks which are executed by the default JobSystem,
+///     or by a custom scheduler when one is set using SetScheduler.
+/// </summary>
+class Parallel
+{
+public:
+    /// <summary>
+    ///     Custom scheduler hook, has to call function(begin, end) once for every chunk
+    ///     [k * chunkSize, min((k + 1) * chunkSize, count)) and return once all of them have been executed.
+    /// </summary>
+    typedef std::function<void(size_t count, size_t chunkSize, const JobSystem::RangeFunction& function)> Scheduler;
+
+    /// <summary>
+    ///     The number of bytes processed by a single job, small enough for the input and output of a chunk to stay in L2.
+    /// </summary>
+    static const size_t ChunkBytes = 32 * 1024;
+
+public:
+    /// <summary>
+    ///     Sets a custom scheduler used by all of the parallel kernels, pass an empty scheduler
+    ///     to go back to the default JobSystem.
+    /// </summary>
+    static void SetScheduler(const Scheduler& scheduler)
+    {
+        GetScheduler() = scheduler;
+    }
+
+    /// <summary>
+    ///     Splits the range [0, count) into chunks and executes them in parallel.
+    /// </summary>
+    /// <param name="count">The element count.</param>
+    /// <param name="chunkSize">The maximum number of elements per chunk.</param>
+    /// <param name="function">The function, called as function(begin, end) for every chunk.</param>
+    static void For(const size_t count, const size_t chunkSize, const JobSystem::RangeFunction& function)
+    {
+        const auto& scheduler = GetScheduler();
+
+        if (scheduler)
+            scheduler(count, chunkSize, function);
+        else
+            JobSystem::GetDefault().For(count, chunkSize, function);
+    }
+
+    /// <summary>
+    ///     Returns the cache-sized chunk length for an element type.
+    /// </summary>
+    template<typename TElement>
+    static size_t GetChunkSize()
+    {
+        return Math::Max(ChunkBytes / sizeof(TElement), size_t(1));
+    }
+
+public:
+    /// <summary>
+    ///     Parallel Vector3Base::TransformArray.
+    /// </summary>
+    template<typename T>
+    static void TransformArray(const Vector3Base<T>* source, const MatrixBase<T, 4, 4>& matrix, Vector3Base<T>* destination, const size_t count)
+    {
+        For(count, GetChunkSize<Vector3Base<T>>(), [&](const size_t begin, const size_t end)
+        {
+            Vector3Base<T>::TransformArray(source + begin, matrix, destination + begin, end - begin);
+        });
+    }
+
+    /// <summary>
+    ///     Parallel Vector3Base::TransformArray.
+    /// </summary>
+    template<typename T>
+    static void TransformArray(const Vector3Base<T>* source, const Quaternion& rotation, Vector3Base<T>* destination, const size_t count)
+    {
+        For(count, GetChunkSize<Vector3Base<T>>(), [&](const size_t begin, const size_t end)
+        {
+            Vector3Base<T>::TransformArray(source + begin, rotation, destination + begin, end - begin);
+        });
+    }
+
+    /// <summary>
+    ///     Parallel Vector3Base::NormalizeArray.
+    /// </summary>
+    template<typename T>
+    static void NormalizeArray(const Vector3Base<T>* source, Vector3Base<T>* destination, const size_t count)
+    {
+        For(count, GetChunkSize<Vector3Base<T>>(), [&](const size_t begin, const size_t end)
+        {
+            Vector3Base<T>::NormalizeArray(source + begin, destination + begin, end - begin);
+        });
+    }
+
+    /// <summary>
+    ///     Parallel BoundingFrustumBase::Cull, the visible indices are reported in ascending order.
+    /// </summary>
+    template<typename T>
+    static size_t Cull(const BoundingFrustumBase<T>& frustum, const BoundingBoxBase<T>* boxes, const size_t count, uint32_t* visibleIndices)
+    {
+        return CullInternal(count, GetChunkSize<BoundingBoxBase<T>>(), visibleIndices, [&](const size_t begin, const size_t end, uint32_t* output)
+        {
+            return frustum.Cull(boxes + begin, end - begin, output, static_cast<uint32_t>(begin));
+        });
+    }
+
+    /// <summary>
+    ///     Parallel BoundingFrustumBase::Cull, the visible indices are reported in ascending order.
+    /// </summary>
+    template<typename T>
+    static size_t Cull(const BoundingFrustumBase<T>& frustum, const BoundingSphereBase<T>* spheres, const size_t count, uint32_t* visibleIndices)
+    {
+        return CullInternal(count, GetChunkSize<BoundingSphereBase<T>>(), visibleIndices, [&](const size_t begin, const size_t end, uint32_t* output)
+        {
+            return frustum.Cull(spheres + begin, end - begin, output, static_cast<uint32_t>(begin));
+        });
+    }
+
+    /// <summary>
+    ///     Parallel BoundingFrustumBase::Cull, the visible indices are reported in ascending order.
+    /// </summary>
+    template<typename T>
+    static size_t Cull(const BoundingFrustumBase<T>& frustum, const OrientedBoundingBoxBase<T>* boxes, const size_t count, uint32_t* visibleIndices)
+    {
+        return CullInternal(count, GetChunkSize<OrientedBoundingBoxBase<T>>(), visibleIndices, [&](const size_t begin, const size_t end, uint32_t* output)
+        {
+            return frustum.Cull(boxes + begin, end - begin, output, static_cast<uint32_t>(begin));
+        });
+    }
+
+    /// <summary>
+    ///     Parallel BoundingBoxBase::FromPoints.
+    /// </summary>
+    template<typename T>
+    static BoundingBoxBase<T> FromPoints(const Vector3Base<T>* points, const size_t count)
+    {
+        const auto chunkSize = GetChunkSize<Vector3Base<T>>();
+        const auto chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        if (chunkCount <= 1)
+            return BoundingBoxBase<T>::FromPoints(points, count);
+
+        std::vector<BoundingBoxBase<T>> chunkBounds(chunkCount);
+        For(count, chunkSize, [&](const size_t begin, const size_t end)
+        {
+            chunkBounds[begin / chunkSize] = BoundingBoxBase<T>::FromPoints(points + begin, end - begin);
+        });
+
+        auto minimum = chunkBounds[0].Minimum();
+        auto maximum = chunkBounds[0].Maximum();
+
+        for (auto i = size_t(1); i < chunkCount; i++)
+        {
+            const auto chunkMinimum = chunkBounds[i].Minimum();
+            const auto chunkMaximum = chunkBounds[i].Maximum();
+
+            minimum = Vector3Base<T>(Math::Min(minimum.x, chunkMinimum.x), Math::Min(minimum.y, chunkMinimum.y), Math::Min(minimum.z, chunkMinimum.z));
+            maximum = Vector3Base<T>(Math::Max(maximum.x, chunkMaximum.x), Math::Max(maximum.y, chunkMaximum.y), Math::Max(maximum.z, chunkMaximum.z));
+        }
+
+        return BoundingBoxBase<T>::FromMinMax(minimum, maximum);
+    }
+
+    /// <summary>
+    ///     Parallel Skinning::SkinVertices.
+    /// </summary>
+    template<typename T, typename TIndex>
+    static void SkinVertices(const Vector3Base<T>* positions, const Vector3Base<T>* normals,
+        const Vector4Base<TIndex>* boneIndices, const Vector4Base<T>* boneWeights, const Matrix4x4Base<T>* palette,
+        Vector3Base<T>* outPositions, Vector3Base<T>* outNormals, const size_t count)
+    {
+        const auto skinNormals = normals != nullptr && outNormals != nullptr;
+
+        For(count, GetChunkSize<Vector3Base<T>>() / 4, [&](const size_t begin, const size_t end)
+        {
+            Skinning::SkinVertices<T, TIndex>(positions + begin, skinNormals ? normals + begin : nullptr,
+                boneIndices + begin, boneWeights + begin, palette,
+                outPositions + begin, skinNormals ? outNormals + begin : nullptr, end - begin);
+        });
+    }
+
+    /// <summary>
+    ///     Parallel Mesh::ComputeNormals.
+    /// </summary>
+    template<typename T, typename TIndex>
+    static void ComputeNormals(const Vector3Base<T>* positions, const size_t vertexCount, const TIndex* indices, const size_t indexCount,
+        Vector3Base<T>* normals, const NormalWeighting weighting = NormalWeighting::Angle)
+    {
+        AccumulateTriangles(indices, indexCount / 3, vertexCount, 1, normals,
+            [&](const size_t begin, const size_t end, Vector3Base<T>* sums, const size_t firstVertex)
+        {
+            Mesh::AccumulateNormals(positions, indices, begin, end, weighting, sums, firstVertex);
+        });
+
+        For(vertexCount, GetChunkSize<Vector3Base<T>>(), [&](const size_t begin, const size_t end)
+        {
+            Mesh::FinishNormals(normals + begin, end - begin);
+        });
+    }
+
+    /// <summary>
+    ///     Parallel Mesh::ComputeTangents.
+    /// </summary>
+    template<typename T, typename TIndex>
+    static void ComputeTangents(const Vector3Base<T>* positions, const Vector3Base<T>* normals, const Vector2Base<T>* uvs, const size_t vertexCount,
+        const TIndex* indices, const size_t indexCount, Vector4Base<T>* tangents, const NormalWeighting weighting = NormalWeighting::Angle)
+    {
+        std::vector<Vector3Base<T>> sums(vertexCount * 2);
+        AccumulateTriangles(indices, indexCount / 3, vertexCount, 2, sums.data(),
+            [&](const size_t begin, const size_t end, Vector3Base<T>* partialSums, const size_t firstVertex)
+        {
+            Mesh::AccumulateTangents(positions, uvs, indices, begin, end, weighting, partialSums, firstVertex);
+        });
+
+        For(vertexCount, GetChunkSize<Vector4Base<T>>(), [&](const size_t begin, const size_t end)
+        {
+            Mesh::FinishTangents(normals + begin, sums.data() + begin * 2, end - begin, tangents + begin);
+        });
+    }
+
+private:
+    static Scheduler& GetScheduler()
+    {
+        static Scheduler scheduler;
+        return scheduler;
+    }
+
+    static size_t GetConcurrency()
+    {
+        // A custom scheduler replaces the default JobSystem, which must not be started just to be queried
+        if (GetScheduler())
+            return Math::Max(size_t(std::thread::hardware_concurrency()), size_t(1));
+
+        return JobSystem::GetDefault().GetThreadCount();
+    }
+
+    template<typename TCullFunction>
+    static size_t CullInternal(const size_t count, const size_t chunkSize, uint32_t* visibleIndices, const TCullFunction& cull)
+    {
+        // Every chunk writes its visible indices at its own offset, the chunks are compacted afterwards
+        const auto chunkCount = (count + chunkSize - 1) / chunkSize;
+        std::vector<size_t> chunkVisible(chunkCount);
+
+        For(count, chunkSize, [&](const size_t begin, const size_t end)
+        {
+            chunkVisible[begin / chunkSize] = cull(begin, end, visibleIndices + begin);
+        });
+
+        auto visibleCount = size_t(0);
+        for (auto chunk = size_t(0); chunk < chunkCount; chunk++)
+        {
+            const auto begin = chunk * chunkSize;
+            if (visibleCount != begin)
+                memmove(visibleIndices + visibleCount, visibleIndices + begin, chunkVisible[chunk] * sizeof(uint32_t));
+
+            visibleCount += chunkVisible[chunk];
+        }
+
+        return visibleCount;
+    }
+
+    /// <summary>
+    ///     Race-free scatter of per-triangle values into per-vertex sums (valuesPerVertex vectors per vertex).
+    ///     The triangles are split into one range per thread, every range accumulates into its own partial buffer
+    ///     which covers only the vertex range its triangles reference (a small window for the locally indexed
+    ///     meshes of terrain or tessellation). The windows are then summed per vertex chunk, in the order of the ranges.
+    /// </summary>
+    template<typename T, typename TIndex, typename TAccumulate>
+    static void AccumulateTriangles(const TIndex* indices, const size_t triangleCount, const size_t vertexCount, const size_t valuesPerVertex,
+        Vector3Base<T>* sums, const TAccumulate& accumulate)
+    {
+        const auto minimumTriangles = size_t(16 * 1024);
+        const auto rangeCount = Math::Min(GetConcurrency(), triangleCount / minimumTriangles);
+
+        if (rangeCount <= 1)
+        {
+            std::fill(sums, sums + vertexCount * valuesPerVertex, Vector3Base<T>(T(0)));
+            accumulate(0, triangleCount, sums, 0);
+            return;
+        }
+
+        struct Partial
+        {
+            size_t firstVertex;
+            size_t vertexCount;
+            std::vector<Vector3Base<T>> sums;
+        };
+
+        std::vector<Partial> partials(rangeCount);
+        For(rangeCount, 1, [&](const size_t first, const size_t last)
+        {
+            for (auto range = first; range < last; range++)
+            {
+                const auto begin = triangleCount * range / rangeCount;
+                const auto end = triangleCount * (range + 1) / rangeCount;
+
+                auto minimum = static_cast<size_t>(indices[begin * 3]);
+                auto maximum = minimum;
+                for (auto i = begin * 3; i < end * 3; i++)
+                {
+                    minimum = Math::Min(minimum, static_cast<size_t>(indices[i]));
+                    maximum = Math::Max(maximum, static_cast<size_t>(indices[i]));
+                }
+
+                auto& partial = partials[range];
+                partial.firstVertex = minimum;
+                partial.vertexCount = maximum - minimum + 1;
+                partial.sums.assign(partial.vertexCount * valuesPerVertex, Vector3Base<T>(T(0)));
+
+                accumulate(begin, end, partial.sums.data(), minimum);
+            }
+        });
+
+        For(vertexCount, GetChunkSize<Vector3Base<T>>(), [&](const size_t begin, const size_t end)
+        {
+            std::fill(sums + begin * valuesPerVertex, sums + end * valuesPerVertex, Vector3Base<T>(T(0)));
+
+            for (const auto& partial : partials)
+            {
+                const auto overlapBegin = Math::Max(begin, partial.firstVertex);
+                const auto overlapEnd = Math::Min(end, partial.firstVertex + partial.vertexCount);
+
+                for (auto i = overlapBegin * valuesPerVertex; i < overlapEnd * valuesPerVertex; i++)
+                    sums[i] += partial.sums[i - partial.firstVertex * valuesPerVertex];
+            }
+        });
+    }
+};
@@ -2,6 +2,12 @@
 
 #pragma once
 
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "BoundingBoxBase.h"
+#include "BoundingSphereBase.h"
+
 enum class PlaneIntersection
 {
     None,
@@ -10,6 +16,10 @@ enum class PlaneIntersection
     Front
 };
 
+/// <summary>
+///     A plane as the packed components (normal.x, normal.y, normal.z, distance), so an array of float planes
+///     is an array of 16 byte vectors which the SIMD kernels load directly.
+/// </summary>
 template<typename T>
 struct PlaneBase
 {
@@ -25,7 +35,7 @@ public:
     ///     Initializes a new instance of the Plane struct.
     /// </summary>
     /// <param name="value">The value that will be assigned to all components.</param>
-    explicit PlaneBase(const float value)
+    explicit PlaneBase(const T value)
     {
         normal.x = normal.y = normal.z = distance = value;
     }
@@ -37,7 +47,7 @@ public:
     /// <param name="b">The Y component of the normal.</param>
     /// <param name="c">The Z component of the normal.</param>
     /// <param name="d">The distance of the plane along its normal from the origin.</param>
-    explicit PlaneBase(float a, float b, float c, float d)
+    explicit PlaneBase(const T a, const T b, const T c, const T d)
     {
         normal.x = a;
         normal.y = b;
@@ -50,9 +60,9 @@ public:
     /// </summary>
     /// <param name="point">Any point that lies along the plane.</param>
     /// <param name="normal">The normal vector to the plane.</param>
-    explicit PlaneBase(Vector3Base<T> point, Vector3Base<T> normal)
+    explicit PlaneBase(const Vector3Base<T>& point, const Vector3Base<T>& normal)
     {
-        normal = normal;
+        this->normal = normal;
         distance = -Vector3Base<T>::Dot(normal, point);
     }
 
@@ -62,23 +72,26 @@ public:
     /// <param name="a">First point of a triangle defining the plane.</param>
     /// <param name="b">Second point of a triangle defining the plane.</param>
     /// <param name="c">Third point of a triangle defining the plane.</param>
-    explicit PlaneBase(Vector3Base<T> a, Vector3Base<T> b, Vector3Base<T> c)
+    explicit PlaneBase(const Vector3Base<T>& a, const Vector3Base<T>& b, const Vector3Base<T>& c)
     {
         auto xa = b - a;
         auto xb = a - c;
         auto dir = Vector3Base<T>::Cross(xa, xb);
         dir.Normalize();
         normal = dir;
-        distance = dir.Length();
+        distance = -Vector3Base<T>::Dot(dir, a);
     }
 
 public:
-    float Dot(const Vector3Base<T> point) const
+    /// <summary>
+    ///     Returns the signed distance of a point from the plane, in the normal length.
+    /// </summary>
+    T Dot(const Vector3Base<T>& point) const
     {
-        return normal.x* point.x
+        return normal.x * point.x
             + normal.y * point.y
             + normal.z * point.z
-            + distance * 1;
+            + distance;
     }
 
     /// <summary>
@@ -86,13 +99,13 @@ public:
     /// </summary>
     void Normalize()
     {
-        auto magnitude = 1.0f / static_cast<float>(Math::Sqrt(
-            (normal.x * normal.x) + (normal.y * normal.y) + (normal.z * normal.z)));
+        auto magnitude = T(1) / Math::Sqrt(
+            (normal.x * normal.x) + (normal.y * normal.y) + (normal.z * normal.z));
 
         normal.x *= magnitude;
         normal.y *= magnitude;
         normal.z *= magnitude;
-        distance = magnitude;
+        distance *= magnitude;
     }
 
 public:
@@ -102,15 +115,51 @@ public:
     /// <param name="plane">The plane to test.</param>
     /// <param name="point">The point to test.</param>
     /// <returns>Whether the two objects intersected.</returns>
-    static PlaneIntersection PlaneIntersectsPoint(PlaneBase<T>& plane, Vector3Base<T>& point)
+    static PlaneIntersection PlaneIntersectsPoint(const PlaneBase<T>& plane, const Vector3Base<T>& point)
+    {
+        return Classify(plane.Dot(point), T(0));
+    }
+
+    /// <summary>
+    ///     Determines whether there is an intersection between a <see cref="Plane"/> and a sphere.
+    /// </summary>
+    /// <param name="plane">The plane to test.</param>
+    /// <param name="sphere">The sphere to test.</param>
+    /// <returns>Front or Back when the sphere is entirely on one side of the plane, otherwise Intersecting.</returns>
+    static PlaneIntersection PlaneIntersectsSphere(const PlaneBase<T>& plane, const BoundingSphereBase<T>& sphere)
     {
-        auto distance = Vector3Base<T>::Dot(plane.normal, point);
-        distance += plane.distance;
+        return Classify(plane.Dot(sphere.center), sphere.radius);
+    }
 
-        if (distance > 0.0f)
+    /// <summary>
+    ///     Determines whether there is an intersection between a <see cref="Plane"/> and a box.
+    /// </summary>
+    /// <param name="plane">The plane to test.</param>
+    /// <param name="box">The box to test.</param>
+    /// <returns>Front or Back when the box is entirely on one side of the plane, otherwise Intersecting.</returns>
+    static PlaneIntersection PlaneIntersectsBox(const PlaneBase<T>& plane, const BoundingBoxBase<T>& box)
+    {
+        return Classify(plane.Dot(box.center), GetProjectedRadius(plane, box));
+    }
+
+    /// <summary>
+    ///     Returns the half of the extent of a box along the plane normal, in the normal length.
+    /// </summary>
+    static T GetProjectedRadius(const PlaneBase<T>& plane, const BoundingBoxBase<T>& box)
+    {
+        const auto extents = box.size * T(0.5);
+        return Math::Abs(plane.normal.x) * extents.x
+            + Math::Abs(plane.normal.y) * extents.y
+            + Math::Abs(plane.normal.z) * extents.z;
+    }
+
+private:
+    static PlaneIntersection Classify(const T distance, const T radius)
+    {
+        if (distance > radius)
             return PlaneIntersection::Front;
 
-        if (distance < 0.0f)
+        if (distance < -radius)
             return PlaneIntersection::Back;
 
         return PlaneIntersection::Intersecting;
@@ -125,5 +174,8 @@ public:
     /// <summary>
     ///     The distance of the plane along its normal from the origin.
     /// </summary>
-    float distance = 0.0f;
+    T distance = T(0);
 };
+
+static_assert(sizeof(PlaneBase<float>) == 4 * sizeof(float), "PlaneBase has to be packed into four components");
+static_assert(sizeof(PlaneBase<double>) == 4 * sizeof(double), "PlaneBase has to be packed into four components");
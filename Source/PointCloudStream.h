@@ -0,0 +1,454 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "Matrix4x4Base.h"
+#include "BoundingBoxBase.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+
+/// <summary>
+///     How a point file is read.
+/// </summary>
+enum class PointFileAccess
+{
+    Mapped,     // Memory-mapped, read-ahead and release hints are passed to the OS per chunk
+    Buffered    // Read with fread, for file systems where mapping is slow or unavailable
+};
+
+/// <summary>
+///     Streams arrays of points which are too large to be loaded at once through a fixed-size pipeline:
+///     transform, bounds accumulation, voxel-grid downsampling and a user callback, one chunk at a time.
+///     A reader thread loads the next chunk into one of two buffers while the calling thread processes
+///     the other one (using the Parallel kernels), so the memory use is two chunks plus the voxel grid
+///     and the processing is hidden behind the file reads.
+/// </summary>
+template<typename T>
+class PointCloudStreamBase
+{
+public:
+    typedef std::function<void(const Vector3Base<T>* points, size_t count)> ChunkFunction;
+
+    static const size_t DefaultChunkPointCount = 1024 * 1024;
+
+public:
+    /// <summary>
+    ///     Constructs a stream.
+    /// </summary>
+    /// <param name="chunkPointCount">The number of points loaded and processed at once.</param>
+    explicit PointCloudStreamBase(const size_t chunkPointCount = DefaultChunkPointCount)
+        : m_chunkPointCount(chunkPointCount > 0 ? chunkPointCount : 1)
+    {
+        Reset();
+    }
+
+public:
+    /// <summary>
+    ///     Sets the transform applied to the points before everything else, identity (the default) skips the transform.
+    /// </summary>
+    void SetTransform(const Matrix4x4Base<T>& transform)
+    {
+        m_transform = transform;
+        m_hasTransform = !Matrix4x4Base<T>::IsIdentity(transform);
+    }
+
+    /// <summary>
+    ///     Sets the voxel size of the downsampling grid, every occupied voxel is reduced to the centroid of its points.
+    ///     Zero (the default) disables the downsampling. Changing the size clears the grid.
+    /// </summary>
+    void SetVoxelSize(const T voxelSize)
+    {
+        m_voxelSize = voxelSize;
+        m_inverseVoxelSize = voxelSize > T(0) ? T(1) / voxelSize : T(0);
+        ClearVoxels();
+    }
+
+    /// <summary>
+    ///     Sets a function called with every chunk of transformed points, e.g. to write them out or to run further kernels.
+    /// </summary>
+    void SetChunkFunction(const ChunkFunction& function)
+    {
+        m_chunkFunction = function;
+    }
+
+    /// <summary>
+    ///     Clears the accumulated bounds, point count and voxel grid, the settings are kept.
+    /// </summary>
+    void Reset()
+    {
+        m_pointCount = 0;
+        m_minimum = Vector3Base<T>(std::numeric_limits<T>::max());
+        m_maximum = Vector3Base<T>(std::numeric_limits<T>::lowest());
+        ClearVoxels();
+    }
+
+public:
+    /// <summary>
+    ///     Streams all points of a file, the results are accumulated with the previously processed points.
+    /// </summary>
+    /// <param name="path">The file path.</param>
+    /// <param name="headerSize">The number of bytes skipped at the start of the file, the points follow tightly packed.</param>
+    /// <param name="access">How the file is read.</param>
+    /// <returns>False when the file cannot be opened or read, the points processed up to the error are kept.</returns>
+    /// <remarks>An exception thrown by the chunk function is rethrown once the reading has stopped.</remarks>
+    bool ProcessFile(const char* path, const size_t headerSize = 0, const PointFileAccess access = PointFileAccess::Mapped)
+    {
+        if (access == PointFileAccess::Mapped)
+        {
+            MappedFile file;
+            if (!file.Open(path, true) || file.GetSize() < headerSize)
+                return false;
+
+            const auto chunkBytes = m_chunkPointCount * sizeof(Vector3Base<T>);
+            const auto count = (file.GetSize() - headerSize) / sizeof(Vector3Base<T>);
+
+            // Reading a chunk prefetches the one after the next, so there is always a chunk in flight,
+            // the copied pages are released right away instead of being kept in the page cache
+            file.WillNeed(headerSize, 2 * chunkBytes);
+            return Stream(count, [&](const size_t first, const size_t chunkCount, Vector3Base<T>* points)
+            {
+                const auto offset = headerSize + first * sizeof(Vector3Base<T>);
+                file.WillNeed(offset + 2 * chunkBytes, chunkBytes);
+                std::memcpy(static_cast<void*>(points), file.GetData() + offset, chunkCount * sizeof(Vector3Base<T>));
+                file.DontNeed(offset, chunkCount * sizeof(Vector3Base<T>));
+                return true;
+            });
+        }
+
+        auto file = std::fopen(path, "rb");
+        if (file == nullptr)
+            return false;
+
+        auto result = false;
+        if (Seek(file, 0, SEEK_END))
+        {
+            const auto size = Tell(file);
+            if (size >= 0 && uint64_t(size) >= headerSize && Seek(file, headerSize, SEEK_SET))
+            {
+                const auto count = static_cast<size_t>((uint64_t(size) - headerSize) / sizeof(Vector3Base<T>));
+                try
+                {
+                    result = Stream(count, [&](const size_t, const size_t chunkCount, Vector3Base<T>* points)
+                    {
+                        return std::fread(points, sizeof(Vector3Base<T>), chunkCount, file) == chunkCount;
+                    });
+                }
+                catch (...)
+                {
+                    std::fclose(file);
+                    throw;
+                }
+            }
+        }
+
+        std::fclose(file);
+        return result;
+    }
+
+    /// <summary>
+    ///     Runs an array of points through the same pipeline, the source array is not modified.
+    /// </summary>
+    void ProcessPoints(const Vector3Base<T>* points, const size_t count)
+    {
+        std::vector<Vector3Base<T>> chunk(Math::Min(count, m_chunkPointCount));
+        for (auto first = size_t(0); first < count; first += m_chunkPointCount)
+        {
+            const auto chunkCount = Math::Min(count - first, m_chunkPointCount);
+            std::copy(points + first, points + first + chunkCount, chunk.data());
+            ProcessChunk(chunk.data(), chunkCount);
+        }
+    }
+
+public:
+    /// <summary>
+    ///     Returns the number of processed points.
+    /// </summary>
+    size_t GetPointCount() const
+    {
+        return m_pointCount;
+    }
+
+    /// <summary>
+    ///     Returns the bounds of the processed (transformed) points.
+    /// </summary>
+    BoundingBoxBase<T> GetBounds() const
+    {
+        return m_pointCount > 0 ? BoundingBoxBase<T>::FromMinMax(m_minimum, m_maximum) : BoundingBoxBase<T>();
+    }
+
+    /// <summary>
+    ///     Returns the number of occupied voxels.
+    /// </summary>
+    size_t GetVoxelCount() const
+    {
+        return m_voxelCount;
+    }
+
+    /// <summary>
+    ///     Returns the downsampled point cloud, the centroid of every occupied voxel (in no particular order).
+    /// </summary>
+    std::vector<Vector3Base<T>> GetVoxelPoints() const
+    {
+        std::vector<Vector3Base<T>> points;
+        points.reserve(m_voxelCount);
+
+        for (const auto& voxel : m_voxels)
+        {
+            if (voxel.count == 0)
+                continue;
+
+            const auto scale = 1.0 / double(voxel.count);
+            points.push_back(Vector3Base<T>(T(voxel.sum[0] * scale), T(voxel.sum[1] * scale), T(voxel.sum[2] * scale)));
+        }
+
+        return points;
+    }
+
+private:
+    struct Voxel
+    {
+        uint64_t key;
+        uint32_t count;
+        double sum[3];
+    };
+
+    // std::fseek and std::ftell take a long, which is 32 bits on Windows
+    static bool Seek(std::FILE* file, const uint64_t offset, const int origin)
+    {
+#if defined(_WIN32)
+        return _fseeki64(file, static_cast<int64_t>(offset), origin) == 0;
+#else
+        return fseeko(file, static_cast<off_t>(offset), origin) == 0;
+#endif
+    }
+
+    static int64_t Tell(std::FILE* file)
+    {
+#if defined(_WIN32)
+        return _ftelli64(file);
+#else
+        return static_cast<int64_t>(ftello(file));
+#endif
+    }
+
+    template<typename TReadFunction>
+    bool Stream(const size_t count, const TReadFunction& read)
+    {
+        struct Buffer
+        {
+            std::vector<Vector3Base<T>> points;
+            size_t count = 0;
+            bool full = false;
+        };
+
+        Buffer buffers[2];
+        for (auto& buffer : buffers)
+            buffer.points.resize(Math::Min(count, m_chunkPointCount));
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::exception_ptr readException;
+        auto failed = false;
+        auto stopped = false;
+
+        // The reader fills the buffers alternately and waits while the next one is still being processed
+        std::thread reader([&]()
+        {
+            try
+            {
+                auto chunk = size_t(0);
+                for (auto first = size_t(0); first < count; first += m_chunkPointCount, chunk++)
+                {
+                    auto& buffer = buffers[chunk & 1];
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        condition.wait(lock, [&] { return !buffer.full || stopped; });
+                        if (stopped)
+                            return;
+                    }
+
+                    const auto chunkCount = Math::Min(count - first, m_chunkPointCount);
+                    const auto success = read(first, chunkCount, buffer.points.data());
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    buffer.count = chunkCount;
+                    buffer.full = success;
+                    failed = !success;
+                    condition.notify_all();
+
+                    if (!success)
+                        break;
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                readException = std::current_exception();
+                failed = true;
+                condition.notify_all();
+            }
+        });
+
+        // Stops and joins the reader on every exit, so a throwing chunk never leaves it waiting for a free buffer
+        struct ReaderGuard
+        {
+            std::thread& reader;
+            std::mutex& mutex;
+            std::condition_variable& condition;
+            bool& stopped;
+
+            ~ReaderGuard()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopped = true;
+                }
+
+                condition.notify_all();
+                reader.join();
+            }
+        };
+
+        {
+            ReaderGuard guard = { reader, mutex, condition, stopped };
+
+            auto chunk = size_t(0);
+            for (auto first = size_t(0); first < count; first += m_chunkPointCount, chunk++)
+            {
+                auto& buffer = buffers[chunk & 1];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [&] { return buffer.full || failed; });
+                    if (!buffer.full)
+                        break;
+                }
+
+                ProcessChunk(buffer.points.data(), buffer.count);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                buffer.full = false;
+                condition.notify_all();
+            }
+        }
+
+        if (readException)
+            std::rethrow_exception(readException);
+
+        return !failed;
+    }
+
+    void ProcessChunk(Vector3Base<T>* points, const size_t count)
+    {
+        if (count == 0)
+            return;
+
+        if (m_hasTransform)
+            Parallel::TransformArray(points, m_transform, points, count);
+
+        const auto bounds = Parallel::FromPoints(points, count);
+        const auto minimum = bounds.Minimum();
+        const auto maximum = bounds.Maximum();
+        m_minimum = Vector3Base<T>(Math::Min(m_minimum.x, minimum.x), Math::Min(m_minimum.y, minimum.y), Math::Min(m_minimum.z, minimum.z));
+        m_maximum = Vector3Base<T>(Math::Max(m_maximum.x, maximum.x), Math::Max(m_maximum.y, maximum.y), Math::Max(m_maximum.z, maximum.z));
+        m_pointCount += count;
+
+        if (m_voxelSize > T(0))
+            AccumulateVoxels(points, count);
+
+        if (m_chunkFunction)
+            m_chunkFunction(points, count);
+    }
+
+    void ClearVoxels()
+    {
+        m_voxels.assign(m_voxelSize > T(0) ? 1024 : 0, Voxel { 0, 0, { 0.0, 0.0, 0.0 } });
+        m_voxelCount = 0;
+    }
+
+    void AccumulateVoxels(const Vector3Base<T>* points, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            // Kept below half full, so the linear probing stays short
+            if ((m_voxelCount + 1) * 2 > m_voxels.size())
+                GrowVoxels();
+
+            const auto& point = points[i];
+            const auto key = GetVoxelKey(point);
+            auto& voxel = FindVoxel(key);
+
+            if (voxel.count == 0)
+            {
+                voxel.key = key;
+                m_voxelCount++;
+            }
+
+            voxel.count++;
+            voxel.sum[0] += double(point.x);
+            voxel.sum[1] += double(point.y);
+            voxel.sum[2] += double(point.z);
+        }
+    }
+
+    uint64_t GetVoxelKey(const Vector3Base<T>& point) const
+    {
+        // 21 bits per axis, the cells wrap around after 2^21 voxels in any direction
+        const auto x = uint64_t(uint32_t(Math::FloorToInt(point.x * m_inverseVoxelSize))) & 0x1FFFFFu;
+        const auto y = uint64_t(uint32_t(Math::FloorToInt(point.y * m_inverseVoxelSize))) & 0x1FFFFFu;
+        const auto z = uint64_t(uint32_t(Math::FloorToInt(point.z * m_inverseVoxelSize))) & 0x1FFFFFu;
+        return x | (y << 21) | (z << 42);
+    }
+
+    Voxel& FindVoxel(const uint64_t key)
+    {
+        const auto mask = m_voxels.size() - 1;
+        auto index = size_t((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+        while (m_voxels[index].count != 0 && m_voxels[index].key != key)
+            index = (index + 1) & mask;
+
+        return m_voxels[index];
+    }
+
+    void GrowVoxels()
+    {
+        std::vector<Voxel> voxels(m_voxels.size() * 2, Voxel { 0, 0, { 0.0, 0.0, 0.0 } });
+        voxels.swap(m_voxels);
+
+        for (const auto& voxel : voxels)
+        {
+            if (voxel.count != 0)
+                FindVoxel(voxel.key) = voxel;
+        }
+    }
+
+private:
+    size_t m_chunkPointCount;
+    Matrix4x4Base<T> m_transform = Matrix4x4Base<T>::Identity;
+    bool m_hasTransform = false;
+    T m_voxelSize = T(0);
+    T m_inverseVoxelSize = T(0);
+    ChunkFunction m_chunkFunction;
+
+    size_t m_pointCount = 0;
+    Vector3Base<T> m_minimum;
+    Vector3Base<T> m_maximum;
+
+    std::vector<Voxel> m_voxels;
+    size_t m_voxelCount = 0;
+};
@@ -0,0 +1,185 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+
+template<typename T>
+struct RayBase
+{
+public:
+    /// <summary>
+    /// Default constructor
+    /// Sets 0 to all components of this structure
+    /// </summary>
+    RayBase()
+    {
+        position = Vector3Base<T>::Zero;
+        direction = Vector3Base<T>::Zero;
+    }
+
+    /// <summary>
+    /// Constructs Ray with given position and direction.
+    /// </summary>
+    /// <param name="position">The position of the Ray origin.</param>
+    /// <param name="direction">The direction of the Ray, the hit distances are measured in its length.</param>
+    explicit RayBase(const Vector3Base<T>& position, const Vector3Base<T>& direction)
+    {
+        this->position = position;
+        this->direction = direction;
+    }
+
+public:
+    /// <summary>
+    /// Returns the point at the given distance along this Ray.
+    /// </summary>
+    Vector3Base<T> GetPoint(const T distance) const
+    {
+        return position + direction * distance;
+    }
+
+public:
+    /// <summary>
+    /// Intersects a ray with a triangle (Moller-Trumbore), both faces are hit.
+    /// The hit point is p0 + u * (p1 - p0) + v * (p2 - p0).
+    /// </summary>
+    /// <param name="ray">The ray.</param>
+    /// <param name="p0">The first corner of the triangle.</param>
+    /// <param name="p1">The second corner of the triangle.</param>
+    /// <param name="p2">The third corner of the triangle.</param>
+    /// <param name="distance">Receives the distance along the ray, when hit.</param>
+    /// <param name="u">Receives the barycentric coordinate of p1, when hit.</param>
+    /// <param name="v">Receives the barycentric coordinate of p2, when hit.</param>
+    /// <returns>True when the triangle is hit at a non-negative distance.</returns>
+    static bool Intersects(const RayBase<T>& ray, const Vector3Base<T>& p0, const Vector3Base<T>& p1, const Vector3Base<T>& p2, T& distance, T& u, T& v)
+    {
+        return IntersectsEdges(ray, p0, p1 - p0, p2 - p0, distance, u, v);
+    }
+
+    /// <summary>
+    /// Intersects a ray with a triangle given by its first corner and the edges p1 - p0 and p2 - p0.
+    /// </summary>
+    static bool IntersectsEdges(const RayBase<T>& ray, const Vector3Base<T>& p0, const Vector3Base<T>& edge1, const Vector3Base<T>& edge2, T& distance, T& u, T& v)
+    {
+        const auto p = Vector3Base<T>::Cross(ray.direction, edge2);
+        const auto determinant = Vector3Base<T>::Dot(edge1, p);
+
+        // Parallel to the plane or degenerate. Close to zero the quotients blow up and fail the range tests below
+        if (determinant == T(0))
+            return false;
+
+        const auto inverse = T(1) / determinant;
+        const auto offset = ray.position - p0;
+        const auto q = Vector3Base<T>::Cross(offset, edge1);
+
+        const auto hitU = Vector3Base<T>::Dot(offset, p) * inverse;
+        const auto hitV = Vector3Base<T>::Dot(ray.direction, q) * inverse;
+        const auto hitDistance = Vector3Base<T>::Dot(edge2, q) * inverse;
+
+        if (!(hitU >= T(0) && hitV >= T(0) && hitU + hitV <= T(1) && hitDistance >= T(0)))
+            return false;
+
+        distance = hitDistance;
+        u = hitU;
+        v = hitV;
+        return true;
+    }
+
+public:
+    /// <summary>
+    /// Position of this Ray origin
+    /// </summary>
+    Vector3Base<T> position;
+
+    /// <summary>
+    /// Direction of this Ray
+    /// </summary>
+    Vector3Base<T> direction;
+};
+
+/// <summary>
+///     The closest hit of a ray against a TriangleArray.
+/// </summary>
+struct RayHit
+{
+    static constexpr uint32_t InvalidTriangle = ~0u;
+
+    /// <summary>
+    ///     The hit distance. On input, only the triangles closer than it are considered.
+    /// </summary>
+    float distance = std::numeric_limits<float>::max();
+
+    /// <summary>
+    ///     The barycentric coordinates of the second and the third corner.
+    /// </summary>
+    float u = 0.0f;
+    float v = 0.0f;
+
+    /// <summary>
+    ///     The index of the hit triangle, InvalidTriangle when nothing was hit.
+    /// </summary>
+    uint32_t triangle = InvalidTriangle;
+};
+
+/// <summary>
+///     Eight single-precision rays in structure of arrays layout, tested together against every triangle.
+///     The rays should be coherent (for example neighbouring camera pixels), as all of them pay for every triangle.
+///     Lanes with zero distance never hit anything, so a default constructed packet can be partially filled.
+/// </summary>
+struct RayPacket
+{
+    static const size_t Size = 8;
+
+    /// <summary>
+    ///     Sets the ray of a lane and resets its hit.
+    /// </summary>
+    void SetRay(const size_t lane, const RayBase<float>& ray, const float maxDistance = std::numeric_limits<float>::max())
+    {
+        positionX[lane] = ray.position.x;
+        positionY[lane] = ray.position.y;
+        positionZ[lane] = ray.position.z;
+        directionX[lane] = ray.direction.x;
+        directionY[lane] = ray.direction.y;
+        directionZ[lane] = ray.direction.z;
+
+        distance[lane] = maxDistance;
+        u[lane] = v[lane] = 0.0f;
+        triangle[lane] = RayHit::InvalidTriangle;
+    }
+
+    /// <summary>
+    ///     Returns the hit of a lane.
+    /// </summary>
+    RayHit GetHit(const size_t lane) const
+    {
+        RayHit hit;
+        hit.distance = distance[lane];
+        hit.u = u[lane];
+        hit.v = v[lane];
+        hit.triangle = triangle[lane];
+        return hit;
+    }
+
+    float positionX[Size] = {};
+    float positionY[Size] = {};
+    float positionZ[Size] = {};
+    float directionX[Size] = {};
+    float directionY[Size] = {};
+    float directionZ[Size] = {};
+
+    /// <summary>
+    ///     The hit distances, on input the maximum distances.
+    /// </summary>
+    float distance[Size] = {};
+
+    float u[Size] = {};
+    float v[Size] = {};
+
+    uint32_t triangle[Size] = { RayHit::InvalidTriangle, RayHit::InvalidTriangle, RayHit::InvalidTriangle, RayHit::InvalidTriangle,
+        RayHit::InvalidTriangle, RayHit::InvalidTriangle, RayHit::InvalidTriangle, RayHit::InvalidTriangle };
+};
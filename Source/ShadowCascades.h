@@ -0,0 +1,226 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "Vector4Base.h"
+#include "Matrix4x4Base.h"
+#include "BoundingSphereBase.h"
+#include "BoundingFrustumBase.h"
+
+/// <summary>
+///     The distribution of the cascade split depths.
+/// </summary>
+enum class CascadeSplitMode
+{
+    Uniform,        // Linear between the near and far plane
+    Logarithmic,    // Constant ratio between consecutive splits, matches the perspective texel density
+    Practical       // Blend of the two, weighted by lambda (0 is uniform, 1 is logarithmic)
+};
+
+/// <summary>
+///     A single shadow cascade, everything is in world space.
+/// </summary>
+template<typename T>
+struct ShadowCascadeBase
+{
+public:
+    /// <summary>
+    ///     The view depth of the cascade's near plane.
+    /// </summary>
+    T nearDepth = T(0);
+
+    /// <summary>
+    ///     The view depth of the cascade's far plane.
+    /// </summary>
+    T farDepth = T(0);
+
+    /// <summary>
+    ///     The corners of the camera frustum slice covered by the cascade, same order as BoundingFrustumBase::GetCorners.
+    /// </summary>
+    std::array<Vector3Base<T>, 8> corners = {};
+
+    /// <summary>
+    ///     The bounding sphere of the corners, its radius is the half-width of the light projection.
+    /// </summary>
+    BoundingSphereBase<T> bounds;
+
+    /// <summary>
+    ///     The light view matrix, a rotation only so it does not change when the camera moves.
+    /// </summary>
+    Matrix4x4Base<T> view;
+
+    /// <summary>
+    ///     The texel-snapped orthographic light projection.
+    /// </summary>
+    Matrix4x4Base<T> projection;
+
+    /// <summary>
+    ///     view * projection.
+    /// </summary>
+    Matrix4x4Base<T> viewProjection;
+
+    /// <summary>
+    ///     The frustum of viewProjection, for culling the shadow casters of the cascade.
+    /// </summary>
+    BoundingFrustumBase<T> frustum;
+};
+
+/// <summary>
+///     Cascaded shadow map setup: split depths, camera frustum slices and stable light matrices.
+/// </summary>
+class ShadowCascades
+{
+public:
+    /// <summary>
+    ///     Computes the cascade split depths.
+    /// </summary>
+    /// <param name="mode">The split distribution.</param>
+    /// <param name="nearPlane">The camera near plane.</param>
+    /// <param name="farPlane">The camera (or shadow) far plane.</param>
+    /// <param name="cascadeCount">The cascade count.</param>
+    /// <param name="splits">The output depths, cascadeCount + 1 values from nearPlane to farPlane.</param>
+    /// <param name="lambda">The logarithmic weight of the Practical mode.</param>
+    template<typename T>
+    static void ComputeSplits(const CascadeSplitMode mode, const T nearPlane, const T farPlane, const size_t cascadeCount, T* splits, const T lambda = T(0.5))
+    {
+        const auto weight = mode == CascadeSplitMode::Uniform ? T(0) : mode == CascadeSplitMode::Logarithmic ? T(1) : lambda;
+
+        splits[0] = nearPlane;
+        for (auto i = size_t(1); i < cascadeCount; i++)
+        {
+            const auto fraction = static_cast<T>(i) / static_cast<T>(cascadeCount);
+            const auto uniform = nearPlane + (farPlane - nearPlane) * fraction;
+            const auto logarithmic = nearPlane * Math::Pow(farPlane / nearPlane, fraction);
+
+            splits[i] = Math::Lerp(uniform, logarithmic, weight);
+        }
+        splits[cascadeCount] = farPlane;
+    }
+
+    /// <summary>
+    ///     Computes the 8 world-space corners of a view frustum by unprojecting the corners of the clip volume,
+    ///     same order as BoundingFrustumBase::GetCorners.
+    /// </summary>
+    /// <param name="inverseViewProjection">The inverse of the camera view-projection matrix.</param>
+    /// <param name="corners">The output corners.</param>
+    template<typename T>
+    static void GetFrustumCorners(const Matrix4x4Base<T>& inverseViewProjection, std::array<Vector3Base<T>, 8>& corners)
+    {
+        const T x[4] = { T(1), T(1), T(-1), T(-1) };
+        const T y[4] = { T(-1), T(1), T(1), T(-1) };
+
+        for (auto i = 0; i < 8; i++)
+        {
+            const auto corner = Vector4Base<T>::Transform(Vector4Base<T>(x[i & 3], y[i & 3], i < 4 ? T(0) : T(1), T(1)), inverseViewProjection);
+            corners[i] = Vector3Base<T>(corner.x, corner.y, corner.z) / corner.w;
+        }
+    }
+
+    /// <summary>
+    ///     Splits the camera frustum into cascades and fits a stable orthographic light projection to every one of them.
+    ///     The camera frustum is unprojected once, the cascade corners are interpolated along its edges.
+    ///     The projections are sized by the bounding sphere of the slice and their origin is snapped to whole
+    ///     shadow map texels, so the shadow edges do not shimmer when the camera moves or rotates.
+    ///     Every projection spans the sphere diameter plus one texel, which keeps the sphere inside after the snapping.
+    /// </summary>
+    /// <param name="view">The camera view matrix.</param>
+    /// <param name="projection">The camera perspective projection matrix.</param>
+    /// <param name="splits">The cascade split view depths, cascadeCount + 1 values (see ComputeSplits).</param>
+    /// <param name="cascadeCount">The cascade count.</param>
+    /// <param name="lightDirection">The normalized direction the light travels in.</param>
+    /// <param name="resolution">The shadow map resolution (of a single cascade).</param>
+    /// <param name="casterDistance">How far in front of a cascade (towards the light) shadow casters are included.</param>
+    /// <param name="cascades">The output cascades.</param>
+    template<typename T>
+    static void ComputeCascades(const Matrix4x4Base<T>& view, const Matrix4x4Base<T>& projection,
+        const T* splits, const size_t cascadeCount, const Vector3Base<T>& lightDirection, const uint32_t resolution,
+        const T casterDistance, ShadowCascadeBase<T>* cascades)
+    {
+        // The slices are built in view space, so their size only depends on the projection
+        // and does not pick up rounding noise from the camera transform
+        std::array<Vector3Base<T>, 8> frustumCorners;
+        GetFrustumCorners(Matrix4x4Base<T>::Invert(projection), frustumCorners);
+
+        const auto inverseView = Matrix4x4Base<T>::Invert(view);
+        const auto nearPlane = frustumCorners[0].z;
+        const auto depthRange = frustumCorners[4].z - frustumCorners[0].z;
+
+        // Any up vector works as long as it is not parallel to the light
+        const auto up = Math::Abs(lightDirection.y) < T(0.99) ? Vector3Base<T>::Up : Vector3Base<T>::Forward;
+        const auto lightView = Matrix4x4Base<T>::CreateLookAt(Vector3Base<T>::Zero, lightDirection, up);
+        const Vector3Base<T> lightAxes[3] = {
+            Vector3Base<T>(lightView.m11, lightView.m21, lightView.m31),
+            Vector3Base<T>(lightView.m12, lightView.m22, lightView.m32),
+            Vector3Base<T>(lightView.m13, lightView.m23, lightView.m33)
+        };
+
+        for (auto cascadeIndex = size_t(0); cascadeIndex < cascadeCount; cascadeIndex++)
+        {
+            auto& cascade = cascades[cascadeIndex];
+            cascade.nearDepth = splits[cascadeIndex];
+            cascade.farDepth = splits[cascadeIndex + 1];
+
+            // The view depth is linear along the edges between the near and far corners
+            const auto nearFraction = (cascade.nearDepth - nearPlane) / depthRange;
+            const auto farFraction = (cascade.farDepth - nearPlane) / depthRange;
+
+            auto center = Vector3Base<T>::Zero;
+            for (auto i = 0; i < 4; i++)
+            {
+                const auto edge = frustumCorners[i + 4] - frustumCorners[i];
+                cascade.corners[i] = frustumCorners[i] + edge * nearFraction;
+                cascade.corners[i + 4] = frustumCorners[i] + edge * farFraction;
+
+                center += cascade.corners[i] + cascade.corners[i + 4];
+            }
+            center /= T(8);
+
+            auto radiusSquared = T(0);
+            for (auto& corner : cascade.corners)
+            {
+                radiusSquared = Math::Max(radiusSquared, Vector3Base<T>::DistanceSquared(corner, center));
+                corner = Vector3Base<T>::Transform(corner, inverseView);
+            }
+
+            const auto radius = Math::Sqrt(radiusSquared);
+            center = Vector3Base<T>::Transform(center, inverseView);
+            cascade.bounds = BoundingSphereBase<T>(center, radius);
+
+            const auto lightCenter = Vector3Base<T>::Transform(center, lightView);
+
+            // Snapping moves the window by up to one texel, so it spans the diameter plus one texel,
+            // the resolution texels of size 2r / (resolution - 1) still cover the whole sphere after the flooring
+            const auto texelSize = radius * T(2) / static_cast<T>(Math::Max(resolution, 2u) - 1);
+            const auto extent = radius * T(2) + texelSize;
+
+            const auto left = std::floor((lightCenter.x - radius) / texelSize) * texelSize;
+            const auto bottom = std::floor((lightCenter.y - radius) / texelSize) * texelSize;
+            const T minimum[3] = { left, bottom, lightCenter.z - radius - casterDistance };
+            const T maximum[3] = { left + extent, bottom + extent, lightCenter.z + radius };
+
+            cascade.view = lightView;
+            cascade.projection = Matrix4x4Base<T>::CreateOrthoOffCenter(minimum[0], maximum[0], minimum[1], maximum[1], minimum[2], maximum[2]);
+            cascade.viewProjection = cascade.view * cascade.projection;
+
+            // The planes of an orthographic frustum are the light axes, no need to extract and normalize them
+            auto& frustum = cascade.frustum;
+            for (auto axis = 0; axis < 3; axis++)
+            {
+                auto& minimumPlane = frustum.GetPlane(axis == 0 ? 0 : axis == 1 ? 3 : 4);
+                auto& maximumPlane = frustum.GetPlane(axis == 0 ? 1 : axis == 1 ? 2 : 5);
+
+                minimumPlane.normal = lightAxes[axis];
+                minimumPlane.distance = -minimum[axis];
+                maximumPlane.normal = -lightAxes[axis];
+                maximumPlane.distance = maximum[axis];
+            }
+        }
+    }
+};
@@ -0,0 +1,3023 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+
+#include "Config.h"
+#include "Cpu.h"
+#include "Vector3Base.h"
+#include "Quaternion.h"
+#include "Matrix4x4Base.h"
+#include "BoundingBoxBase.h"
+#include "BoundingSphereBase.h"
+#include "BoundingFrustumBase.h"
+#include "PlaneBase.h"
+#include "ColorBase.h"
+#include "RayBase.h"
+
+#if SIMD_X86
+#include <immintrin.h>
+
+// Per-function instruction set selection, so the library can be compiled for the baseline ISA
+// and still contain the AVX2/AVX-512 kernels. MSVC allows all intrinsics without any flags.
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET_SSE2                __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2                __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX512              __attribute__((target("avx512f,avx2,fma")))
+#else
+#define SIMD_TARGET_SSE2
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#endif
+#endif
+
+/// <summary>
+///     Single-precision array kernels with runtime instruction set dispatch.
+///     The implementation is selected once from Cpu::GetSimdLevel, so a binary compiled for the baseline ISA
+///     uses AVX2/AVX-512 on the machines that support it. All kernels produce the same results as the scalar
+///     library functions, up to floating-point rounding (the AVX2 kernels use FMA).
+/// </summary>
+class SimdKernels
+{
+private:
+    struct Table
+    {
+        SimdLevel level;
+
+        void (*multiplyMatrices)(const Matrix4x4Base<float>* a, const Matrix4x4Base<float>* b, Matrix4x4Base<float>* result, size_t count);
+        void (*transformPoints)(const Vector3Base<float>* source, const Matrix4x4Base<float>& matrix, Vector3Base<float>* destination, size_t count);
+        void (*multiplyQuaternions)(const Quaternion* a, const Quaternion* b, Quaternion* result, size_t count);
+        size_t (*cullBoxes)(const PlaneBase<float>* planes, size_t planeCount, const BoundingBoxBase<float>* boxes, size_t count, uint32_t* visibleIndices, uint32_t firstIndex);
+        size_t (*cullSpheres)(const PlaneBase<float>* planes, size_t planeCount, const BoundingSphereBase<float>* spheres, size_t count, uint32_t* visibleIndices, uint32_t firstIndex);
+        void (*colorsToRGBA8)(const ColorBase<float>* colors, uint32_t* packed, size_t count);
+        void (*colorsFromRGBA8)(const uint32_t* packed, ColorBase<float>* colors, size_t count);
+        BoundingBoxBase<float> (*fromPoints)(const Vector3Base<float>* points, size_t count);
+        void (*eulerToQuaternions)(const float* yaw, const float* pitch, const float* roll, float* x, float* y, float* z, float* w, size_t count);
+        void (*quaternionsToEuler)(const float* x, const float* y, const float* z, const float* w, float* yaw, float* pitch, float* roll, size_t count);
+        void (*quaternionsToMatrices)(const float* x, const float* y, const float* z, const float* w, Matrix4x4Base<float>* matrices, size_t count);
+        void (*matricesToQuaternions)(const Matrix4x4Base<float>* matrices, float* x, float* y, float* z, float* w, size_t count);
+        void (*composeTransforms)(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, Matrix4x4Base<float>* matrices, size_t count);
+        void (*composeTransforms3x4)(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, float* rows, size_t count);
+        void (*decomposeTransforms)(const Matrix4x4Base<float>* matrices, Vector3Base<float>* positions, Quaternion* rotations, Vector3Base<float>* scales, size_t count);
+        void (*triangleNormals)(const Vector3Base<float>* positions, const uint32_t* indices, float* x, float* y, float* z, float* weight0, float* weight1, float* weight2, size_t count);
+        bool (*intersectRay)(const RayBase<float>& ray, const float* const* triangles, size_t begin, size_t end, RayHit& hit);
+        void (*intersectPacket)(RayPacket& packet, const float* const* triangles, size_t count);
+        void (*signedDistances)(const PlaneBase<float>& plane, const Vector3Base<float>* points, float* distances, size_t count);
+        void (*classifyPoints)(const PlaneBase<float>& plane, const Vector3Base<float>* points, PlaneIntersection* results, size_t count);
+        void (*classifySpheres)(const PlaneBase<float>& plane, const BoundingSphereBase<float>* spheres, PlaneIntersection* results, size_t count);
+        void (*classifyBoxes)(const PlaneBase<float>& plane, const BoundingBoxBase<float>* boxes, PlaneIntersection* results, size_t count);
+        void (*skinVertices)(const Vector3Base<float>* positions, const Vector3Base<float>* normals, const uint32_t* boneIndices, const float* boneWeights,
+            const Matrix4x4Base<float>* palette, Vector3Base<float>* outPositions, Vector3Base<float>* outNormals, size_t count);
+    };
+
+public:
+    /// <summary>
+    ///     Returns the SIMD level of the selected kernels.
+    /// </summary>
+    static SimdLevel GetSimdLevel()
+    {
+        return GetTable().level;
+    }
+
+    /// <summary>
+    ///     Selects the kernels of a given SIMD level, mostly for testing and benchmarking.
+    ///     Levels that are not supported by the CPU are clamped to the detected one.
+    ///     Must not be called while any of the kernels is running.
+    /// </summary>
+    /// <returns>The selected level.</returns>
+    static SimdLevel SetSimdLevel(const SimdLevel level)
+    {
+        const auto detected = Cpu::DetectSimdLevel();
+        GetTable() = CreateTable(level < detected ? level : detected);
+        return GetTable().level;
+    }
+
+    /// <summary>
+    ///     Multiplies arrays of matrices, result[i] = a[i] * b[i]. The result can alias either of the inputs.
+    /// </summary>
+    static void MultiplyMatrices(const Matrix4x4Base<float>* a, const Matrix4x4Base<float>* b, Matrix4x4Base<float>* result, const size_t count)
+    {
+        GetTable().multiplyMatrices(a, b, result, count);
+    }
+
+    /// <summary>
+    ///     Transforms an array of points by a matrix, same as Vector3Base::TransformArray.
+    ///     The destination can be the same as the source.
+    /// </summary>
+    static void TransformPoints(const Vector3Base<float>* source, const Matrix4x4Base<float>& matrix, Vector3Base<float>* destination, const size_t count)
+    {
+        GetTable().transformPoints(source, matrix, destination, count);
+    }
+
+    /// <summary>
+    ///     Rotates an array of points by a quaternion, same as Vector3Base::TransformArray.
+    ///     The destination can be the same as the source.
+    /// </summary>
+    static void RotatePoints(const Vector3Base<float>* source, const Quaternion& rotation, Vector3Base<float>* destination, const size_t count)
+    {
+        GetTable().transformPoints(source, CreateRotationMatrix(rotation), destination, count);
+    }
+
+    /// <summary>
+    ///     Multiplies arrays of quaternions, result[i] = a[i] * b[i]. The result can alias either of the inputs.
+    /// </summary>
+    static void MultiplyQuaternions(const Quaternion* a, const Quaternion* b, Quaternion* result, const size_t count)
+    {
+        GetTable().multiplyQuaternions(a, b, result, count);
+    }
+
+    /// <summary>
+    ///     Culls an array of bounding boxes against a frustum, same as BoundingFrustumBase::Cull.
+    /// </summary>
+    static size_t Cull(const BoundingFrustumBase<float>& frustum, const BoundingBoxBase<float>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0)
+    {
+        PlaneBase<float> planes[6];
+        GetPlanes(frustum, planes);
+        return GetTable().cullBoxes(planes, 6, boxes, count, visibleIndices, firstIndex);
+    }
+
+    /// <summary>
+    ///     Culls an array of bounding spheres against a frustum, same as BoundingFrustumBase::Cull.
+    /// </summary>
+    static size_t Cull(const BoundingFrustumBase<float>& frustum, const BoundingSphereBase<float>* spheres, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0)
+    {
+        PlaneBase<float> planes[6];
+        GetPlanes(frustum, planes);
+        return GetTable().cullSpheres(planes, 6, spheres, count, visibleIndices, firstIndex);
+    }
+
+    /// <summary>
+    ///     Culls an array of bounding boxes against a convex volume given by its planes (normals pointing inside,
+    ///     for example a portal or an occluder volume). A box is culled when it is entirely behind any of the planes.
+    /// </summary>
+    static size_t Cull(const PlaneBase<float>* planes, const size_t planeCount, const BoundingBoxBase<float>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0)
+    {
+        return GetTable().cullBoxes(planes, planeCount, boxes, count, visibleIndices, firstIndex);
+    }
+
+    /// <summary>
+    ///     Culls an array of bounding spheres against a convex volume given by its planes, see the function above.
+    /// </summary>
+    static size_t Cull(const PlaneBase<float>* planes, const size_t planeCount, const BoundingSphereBase<float>* spheres, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex = 0)
+    {
+        return GetTable().cullSpheres(planes, planeCount, spheres, count, visibleIndices, firstIndex);
+    }
+
+    /// <summary>
+    ///     Computes the signed distances of points from a plane, same as PlaneBase::Dot.
+    /// </summary>
+    static void SignedDistances(const PlaneBase<float>& plane, const Vector3Base<float>* points, float* distances, const size_t count)
+    {
+        GetTable().signedDistances(plane, points, distances, count);
+    }
+
+    /// <summary>
+    ///     Classifies points against a plane, same as PlaneBase::PlaneIntersectsPoint.
+    /// </summary>
+    static void Classify(const PlaneBase<float>& plane, const Vector3Base<float>* points, PlaneIntersection* results, const size_t count)
+    {
+        GetTable().classifyPoints(plane, points, results, count);
+    }
+
+    /// <summary>
+    ///     Classifies bounding spheres against a plane, same as PlaneBase::PlaneIntersectsSphere.
+    /// </summary>
+    static void Classify(const PlaneBase<float>& plane, const BoundingSphereBase<float>* spheres, PlaneIntersection* results, const size_t count)
+    {
+        GetTable().classifySpheres(plane, spheres, results, count);
+    }
+
+    /// <summary>
+    ///     Classifies bounding boxes against a plane, same as PlaneBase::PlaneIntersectsBox.
+    /// </summary>
+    static void Classify(const PlaneBase<float>& plane, const BoundingBoxBase<float>* boxes, PlaneIntersection* results, const size_t count)
+    {
+        GetTable().classifyBoxes(plane, boxes, results, count);
+    }
+
+    /// <summary>
+    ///     Converts colors to packed 8-bit RGBA (R in the lowest byte), the components are clamped to [0, 1] and rounded.
+    /// </summary>
+    static void ColorsToRGBA8(const ColorBase<float>* colors, uint32_t* packed, const size_t count)
+    {
+        GetTable().colorsToRGBA8(colors, packed, count);
+    }
+
+    /// <summary>
+    ///     Converts packed 8-bit RGBA colors (R in the lowest byte) to floating-point colors.
+    /// </summary>
+    static void ColorsFromRGBA8(const uint32_t* packed, ColorBase<float>* colors, const size_t count)
+    {
+        GetTable().colorsFromRGBA8(packed, colors, count);
+    }
+
+    /// <summary>
+    ///     Creates the smallest bounding box containing all of the given points, same as BoundingBoxBase::FromPoints.
+    /// </summary>
+    static BoundingBoxBase<float> FromPoints(const Vector3Base<float>* points, const size_t count)
+    {
+        return GetTable().fromPoints(points, count);
+    }
+
+    /// <summary>
+    ///     Converts arrays of Euler angles (in radians) to arrays of quaternion components, same as Quaternion::Rotation(yaw, pitch, roll).
+    ///     The SIMD kernels evaluate all of the sines and cosines of a block at once with polynomial approximations,
+    ///     which are accurate to a few ulps within a few thousand radians.
+    /// </summary>
+    static void EulerToQuaternions(const float* yaw, const float* pitch, const float* roll, float* x, float* y, float* z, float* w, const size_t count)
+    {
+        GetTable().eulerToQuaternions(yaw, pitch, roll, x, y, z, w, count);
+    }
+
+    /// <summary>
+    ///     Converts arrays of unit quaternion components to Euler angles, the inverse of EulerToQuaternions.
+    ///     The pitch is in [-pi/2, pi/2], at the poles the roll is zero and the yaw holds all of the rotation about the vertical axis.
+    /// </summary>
+    static void QuaternionsToEuler(const float* x, const float* y, const float* z, const float* w, float* yaw, float* pitch, float* roll, const size_t count)
+    {
+        GetTable().quaternionsToEuler(x, y, z, w, yaw, pitch, roll, count);
+    }
+
+    /// <summary>
+    ///     Converts arrays of unit quaternion components to rotation matrices, same as Matrix4x4Base::CreateRotation.
+    /// </summary>
+    static void QuaternionsToMatrices(const float* x, const float* y, const float* z, const float* w, Matrix4x4Base<float>* matrices, const size_t count)
+    {
+        GetTable().quaternionsToMatrices(x, y, z, w, matrices, count);
+    }
+
+    /// <summary>
+    ///     Converts an array of rotation matrices to arrays of quaternion components, same as Quaternion::Rotation(matrix).
+    ///     The SIMD kernels select the numerically best of the four extraction formulas per lane without branching.
+    /// </summary>
+    static void MatricesToQuaternions(const Matrix4x4Base<float>* matrices, float* x, float* y, float* z, float* w, const size_t count)
+    {
+        GetTable().matricesToQuaternions(matrices, x, y, z, w, count);
+    }
+
+    /// <summary>
+    ///     Builds transform matrices from separate position, rotation and scale arrays, same as Matrix4x4Base::CreateTransform.
+    /// </summary>
+    static void ComposeTransforms(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, Matrix4x4Base<float>* matrices, const size_t count)
+    {
+        GetTable().composeTransforms(positions, rotations, scales, matrices, count);
+    }
+
+    /// <summary>
+    ///     Builds the affine part of transform matrices for instance buffers, 12 floats per transform.
+    ///     These are the three columns of the matrix stored as rows (m11 m21 m31 m41, m12 m22 m32 m42, m13 m23 m33 m43),
+    ///     so a shader computes the world position as three dot products with float4(position, 1).
+    /// </summary>
+    static void ComposeTransforms3x4(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, float* rows, const size_t count)
+    {
+        GetTable().composeTransforms3x4(positions, rotations, scales, rows, count);
+    }
+
+    /// <summary>
+    ///     Splits transform matrices into position, rotation and scale arrays, same as Matrix4x4Base::DecomposeTransform.
+    ///     Mirrored matrices get a negative x scale, the rotations are normalized.
+    /// </summary>
+    static void DecomposeTransforms(const Matrix4x4Base<float>* matrices, Vector3Base<float>* positions, Quaternion* rotations, Vector3Base<float>* scales, const size_t count)
+    {
+        GetTable().decomposeTransforms(matrices, positions, rotations, scales, count);
+    }
+
+    /// <summary>
+    ///     Computes the normals of indexed triangles (three indices per triangle) as arrays of components,
+    ///     normal = Cross(p1 - p0, p2 - p0), so its length is twice the triangle area.
+    ///     The optional weight arrays receive the angle at every corner divided by that length, so normal * weight
+    ///     is the unit normal weighted by the corner angle (zero for degenerate triangles).
+    /// </summary>
+    static void TriangleNormals(const Vector3Base<float>* positions, const uint32_t* indices, float* x, float* y, float* z,
+        float* weight0, float* weight1, float* weight2, const size_t count)
+    {
+        GetTable().triangleNormals(positions, indices, x, y, z, weight0, weight1, weight2, count);
+    }
+
+    /// <summary>
+    ///     Intersects a ray with triangles stored as nine component arrays: the first corners (x, y, z),
+    ///     the edges p1 - p0 and the edges p2 - p0, see RayBase::IntersectsEdges. Both faces are hit.
+    ///     Only hits closer than hit.distance are considered, ties go to the lower triangle index.
+    /// </summary>
+    /// <returns>True when a closer triangle was hit and hit was updated.</returns>
+    static bool IntersectTriangles(const RayBase<float>& ray, const float* const* triangles, const size_t count, RayHit& hit)
+    {
+        return GetTable().intersectRay(ray, triangles, 0, count, hit);
+    }
+
+    /// <summary>
+    ///     Intersects the eight rays of a packet with every triangle (stored as in the function above),
+    ///     updating the lanes which hit a triangle closer than their distance.
+    /// </summary>
+    static void IntersectTriangles(RayPacket& packet, const float* const* triangles, const size_t count)
+    {
+        GetTable().intersectPacket(packet, triangles, count);
+    }
+
+    /// <summary>
+    ///     Linear-blend skinning with four bone indices and weights per vertex, same as Skinning::SkinVertices.
+    ///     The normals are only skinned when both normal arrays are given.
+    /// </summary>
+    static void SkinVertices(const Vector3Base<float>* positions, const Vector3Base<float>* normals, const uint32_t* boneIndices, const float* boneWeights,
+        const Matrix4x4Base<float>* palette, Vector3Base<float>* outPositions, Vector3Base<float>* outNormals, const size_t count)
+    {
+        GetTable().skinVertices(positions, normals, boneIndices, boneWeights, palette, outPositions, outNormals, count);
+    }
+
+private:
+    static Table& GetTable()
+    {
+        static Table table = CreateTable(Cpu::GetSimdLevel());
+        return table;
+    }
+
+    static Table CreateTable(const SimdLevel level)
+    {
+        Table table = { SimdLevel::None, MultiplyMatricesScalar, TransformPointsScalar, MultiplyQuaternionsScalar,
+            CullBoxesScalar, CullSpheresScalar, ColorsToRGBA8Scalar, ColorsFromRGBA8Scalar, FromPointsScalar,
+            EulerToQuaternionsScalar, QuaternionsToEulerScalar, QuaternionsToMatricesScalar, MatricesToQuaternionsScalar,
+            ComposeTransformsScalar, ComposeTransforms3x4Scalar, DecomposeTransformsScalar, TriangleNormalsScalar,
+            IntersectRayScalar, IntersectPacketScalar, SignedDistancesScalar, ClassifyPointsScalar, ClassifySpheresScalar, ClassifyBoxesScalar,
+            SkinVerticesScalar };
+
+#if SIMD_X86
+        if (level >= SimdLevel::SSE2)
+        {
+            table = { SimdLevel::SSE2, MultiplyMatricesSSE2, TransformPointsSSE2, MultiplyQuaternionsSSE2,
+                CullBoxesSSE2, CullSpheresSSE2, ColorsToRGBA8SSE2, ColorsFromRGBA8SSE2, FromPointsSSE2,
+                EulerToQuaternionsSSE2, QuaternionsToEulerSSE2, QuaternionsToMatricesSSE2, MatricesToQuaternionsSSE2,
+                ComposeTransformsSSE2, ComposeTransforms3x4SSE2, DecomposeTransformsSSE2, TriangleNormalsSSE2,
+                IntersectRaySSE2, IntersectPacketSSE2, SignedDistancesSSE2, ClassifyPointsSSE2, ClassifySpheresSSE2, ClassifyBoxesSSE2,
+                SkinVerticesSSE2 };
+        }
+
+        if (level >= SimdLevel::AVX2)
+        {
+            table = { SimdLevel::AVX2, MultiplyMatricesAVX2, TransformPointsAVX2, MultiplyQuaternionsAVX2,
+                CullBoxesAVX2, CullSpheresAVX2, ColorsToRGBA8AVX2, ColorsFromRGBA8AVX2, FromPointsAVX2,
+                EulerToQuaternionsAVX2, QuaternionsToEulerAVX2, QuaternionsToMatricesAVX2, MatricesToQuaternionsAVX2,
+                ComposeTransformsAVX2, ComposeTransforms3x4AVX2, DecomposeTransformsSSE2, TriangleNormalsAVX2,
+                IntersectRayAVX2, IntersectPacketAVX2, SignedDistancesAVX2, ClassifyPointsAVX2, ClassifySpheresAVX2, ClassifyBoxesAVX2,
+                SkinVerticesAVX2 };
+        }
+
+        if (level >= SimdLevel::AVX512)
+        {
+            table.level = SimdLevel::AVX512;
+            table.multiplyMatrices = MultiplyMatricesAVX512;
+            table.cullBoxes = CullBoxesAVX512;
+            table.cullSpheres = CullSpheresAVX512;
+            table.fromPoints = FromPointsAVX512;
+        }
+#else
+        (void)level;
+#endif
+
+        return table;
+    }
+
+    static void GetPlanes(const BoundingFrustumBase<float>& frustum, PlaneBase<float> (&planes)[6])
+    {
+        for (auto p = 0; p < 6; p++)
+            planes[p] = frustum.GetPlane(p);
+    }
+
+    static Matrix4x4Base<float> CreateRotationMatrix(const Quaternion& rotation)
+    {
+        const auto x = rotation.x + rotation.x;
+        const auto y = rotation.y + rotation.y;
+        const auto z = rotation.z + rotation.z;
+        const auto wx = rotation.w * x;
+        const auto wy = rotation.w * y;
+        const auto wz = rotation.w * z;
+        const auto xx = rotation.x * x;
+        const auto xy = rotation.x * y;
+        const auto xz = rotation.x * z;
+        const auto yy = rotation.y * y;
+        const auto yz = rotation.y * z;
+        const auto zz = rotation.z * z;
+
+        return Matrix4x4Base<float>(
+            (1.0f - yy) - zz, xy + wz, xz - wy, 0.0f,
+            xy - wz, (1.0f - xx) - zz, yz + wx, 0.0f,
+            xz + wy, yz - wx, (1.0f - xx) - yy, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    static uint32_t PackRGBA8(const ColorBase<float>& color)
+    {
+        auto packed = 0u;
+        for (auto i = 0; i < 4; i++)
+            packed |= static_cast<uint32_t>(Math::Clamp(color.components[i], 0.0f, 1.0f) * 255.0f + 0.5f) << (i * 8);
+
+        return packed;
+    }
+
+    static ColorBase<float> UnpackRGBA8(const uint32_t packed)
+    {
+        const auto scale = 1.0f / 255.0f;
+        return ColorBase<float>(
+            static_cast<float>(packed & 0xFFu) * scale,
+            static_cast<float>((packed >> 8) & 0xFFu) * scale,
+            static_cast<float>((packed >> 16) & 0xFFu) * scale,
+            static_cast<float>(packed >> 24) * scale);
+    }
+
+private:
+    /* Scalar kernels */
+    // Above this sine of the pitch, yaw and roll are treated as the same rotation (within ~0.08 degrees of the pole)
+    static constexpr float GimbalLockSine = 0.999999f;
+
+    static void MultiplyMatricesScalar(const Matrix4x4Base<float>* a, const Matrix4x4Base<float>* b, Matrix4x4Base<float>* result, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            result[i] = a[i] * b[i];
+    }
+
+    static void TransformPointsScalar(const Vector3Base<float>* source, const Matrix4x4Base<float>& matrix, Vector3Base<float>* destination, const size_t count)
+    {
+        Vector3Base<float>::TransformArray(source, matrix, destination, count);
+    }
+
+    static void MultiplyQuaternionsScalar(const Quaternion* a, const Quaternion* b, Quaternion* result, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            result[i] = a[i] * b[i];
+    }
+
+    static size_t CullBoxesScalar(const PlaneBase<float>* planes, const size_t planeCount, const BoundingBoxBase<float>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex)
+    {
+        auto visibleCount = size_t(0);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            // Same as BoundingFrustumBase::Classify
+            auto visible = true;
+            for (auto p = size_t(0); p < planeCount; p++)
+                visible &= !(planes[p].Dot(boxes[i].center) < -PlaneBase<float>::GetProjectedRadius(planes[p], boxes[i]));
+
+            visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i);
+            visibleCount += visible ? 1 : 0;
+        }
+
+        return visibleCount;
+    }
+
+    static size_t CullSpheresScalar(const PlaneBase<float>* planes, const size_t planeCount, const BoundingSphereBase<float>* spheres, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex)
+    {
+        auto visibleCount = size_t(0);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            // Same as BoundingFrustumBase::Cull
+            auto visible = true;
+            for (auto p = size_t(0); p < planeCount; p++)
+                visible &= planes[p].Dot(spheres[i].center) >= -spheres[i].radius;
+
+            visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i);
+            visibleCount += visible ? 1 : 0;
+        }
+
+        return visibleCount;
+    }
+
+    static BoundingBoxBase<float> FromPointsScalar(const Vector3Base<float>* points, const size_t count)
+    {
+        return BoundingBoxBase<float>::FromPoints(points, count);
+    }
+
+    static BoundingBoxBase<float> FoldBounds(const float* minimum, const float* maximum, const size_t valueCount, const Vector3Base<float>* points, const size_t count)
+    {
+        // The SIMD reductions treat the points as a flat stream of floats, value i of a block holds component i % 3
+        auto result = BoundingBoxBase<float>::FromPoints(points, count);
+        auto resultMinimum = count > 0 ? result.Minimum() : Vector3Base<float>(minimum[0], minimum[1], minimum[2]);
+        auto resultMaximum = count > 0 ? result.Maximum() : Vector3Base<float>(maximum[0], maximum[1], maximum[2]);
+
+        for (auto i = size_t(0); i < valueCount; i++)
+        {
+            resultMinimum[i % 3] = Math::Min(resultMinimum[i % 3], minimum[i]);
+            resultMaximum[i % 3] = Math::Max(resultMaximum[i % 3], maximum[i]);
+        }
+
+        return BoundingBoxBase<float>::FromMinMax(resultMinimum, resultMaximum);
+    }
+
+    static void ColorsToRGBA8Scalar(const ColorBase<float>* colors, uint32_t* packed, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            packed[i] = PackRGBA8(colors[i]);
+    }
+
+    static void ColorsFromRGBA8Scalar(const uint32_t* packed, ColorBase<float>* colors, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            colors[i] = UnpackRGBA8(packed[i]);
+    }
+
+    static void EulerToQuaternionsScalar(const float* yaw, const float* pitch, const float* roll, float* x, float* y, float* z, float* w, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto rotation = Quaternion::Rotation(yaw[i], pitch[i], roll[i]);
+            x[i] = rotation.x;
+            y[i] = rotation.y;
+            z[i] = rotation.z;
+            w[i] = rotation.w;
+        }
+    }
+
+    static void QuaternionsToEulerScalar(const float* x, const float* y, const float* z, const float* w, float* yaw, float* pitch, float* roll, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            // The angles are read from the rotation matrix, pitch from m32, yaw from m31 and m33, roll from m12 and m22
+            const auto sinPitch = Math::Clamp(2.0f * (x[i] * w[i] - y[i] * z[i]), -1.0f, 1.0f);
+            pitch[i] = std::asin(sinPitch);
+
+            if (Math::Abs(sinPitch) < GimbalLockSine)
+            {
+                yaw[i] = std::atan2(2.0f * (z[i] * x[i] + y[i] * w[i]), 1.0f - 2.0f * (x[i] * x[i] + y[i] * y[i]));
+                roll[i] = std::atan2(2.0f * (x[i] * y[i] + z[i] * w[i]), 1.0f - 2.0f * (z[i] * z[i] + x[i] * x[i]));
+            }
+            else
+            {
+                // Yaw and roll rotate about the same axis, all of it is put into the yaw (from m13 and m11)
+                yaw[i] = std::atan2(2.0f * (y[i] * w[i] - z[i] * x[i]), 1.0f - 2.0f * (y[i] * y[i] + z[i] * z[i]));
+                roll[i] = 0.0f;
+            }
+        }
+    }
+
+    static void QuaternionsToMatricesScalar(const float* x, const float* y, const float* z, const float* w, Matrix4x4Base<float>* matrices, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            matrices[i] = CreateRotationMatrix(Quaternion(x[i], y[i], z[i], w[i]));
+    }
+
+    static void MatricesToQuaternionsScalar(const Matrix4x4Base<float>* matrices, float* x, float* y, float* z, float* w, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto rotation = Quaternion::Rotation(matrices[i]);
+            x[i] = rotation.x;
+            y[i] = rotation.y;
+            z[i] = rotation.z;
+            w[i] = rotation.w;
+        }
+    }
+
+    static void ComposeTransformsScalar(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, Matrix4x4Base<float>* matrices, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            matrices[i] = Matrix4x4Base<float>::CreateTransform(positions[i], rotations[i], scales[i]);
+    }
+
+    static void ComposeTransforms3x4Scalar(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, float* rows, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto matrix = Matrix4x4Base<float>::CreateTransform(positions[i], rotations[i], scales[i]);
+            const auto output = rows + i * 12;
+            for (auto c = 0; c < 3; c++)
+            {
+                output[c * 4 + 0] = matrix[0 * 4 + c];
+                output[c * 4 + 1] = matrix[1 * 4 + c];
+                output[c * 4 + 2] = matrix[2 * 4 + c];
+                output[c * 4 + 3] = matrix[3 * 4 + c];
+            }
+        }
+    }
+
+    static void DecomposeTransformsScalar(const Matrix4x4Base<float>* matrices, Vector3Base<float>* positions, Quaternion* rotations, Vector3Base<float>* scales, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            auto matrix = matrices[i];
+            matrix.DecomposeTransform(positions[i], rotations[i], scales[i]);
+        }
+    }
+
+    static void TriangleNormalsScalar(const Vector3Base<float>* positions, const uint32_t* indices, float* x, float* y, float* z,
+        float* weight0, float* weight1, float* weight2, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto& p0 = positions[indices[i * 3 + 0]];
+            const auto& p1 = positions[indices[i * 3 + 1]];
+            const auto& p2 = positions[indices[i * 3 + 2]];
+
+            const auto edge01 = p1 - p0;
+            const auto edge02 = p2 - p0;
+            const auto normal = Vector3Base<float>::Cross(edge01, edge02);
+
+            x[i] = normal.x;
+            y[i] = normal.y;
+            z[i] = normal.z;
+
+            if (weight0 == nullptr)
+                continue;
+
+            // The sine of every corner angle times the lengths of its edges is the cross product length,
+            // the cosine times the lengths is the dot product of the edges
+            const auto edge12 = p2 - p1;
+            const auto length = normal.Length();
+            const auto scale = length > 0.0f ? 1.0f / length : 0.0f;
+
+            weight0[i] = std::atan2(length, Vector3Base<float>::Dot(edge01, edge02)) * scale;
+            weight1[i] = std::atan2(length, -Vector3Base<float>::Dot(edge01, edge12)) * scale;
+            weight2[i] = std::atan2(length, Vector3Base<float>::Dot(edge02, edge12)) * scale;
+        }
+    }
+
+    static Vector3Base<float> LoadTriangleVector(const float* const* triangles, const size_t component, const size_t index)
+    {
+        return Vector3Base<float>(triangles[component][index], triangles[component + 1][index], triangles[component + 2][index]);
+    }
+
+    static bool IntersectRayScalar(const RayBase<float>& ray, const float* const* triangles, const size_t begin, const size_t end, RayHit& hit)
+    {
+        auto found = false;
+        for (auto i = begin; i < end; i++)
+        {
+            float distance, u, v;
+            if (!RayBase<float>::IntersectsEdges(ray, LoadTriangleVector(triangles, 0, i), LoadTriangleVector(triangles, 3, i), LoadTriangleVector(triangles, 6, i), distance, u, v))
+                continue;
+
+            if (distance < hit.distance)
+            {
+                hit.distance = distance;
+                hit.u = u;
+                hit.v = v;
+                hit.triangle = static_cast<uint32_t>(i);
+                found = true;
+            }
+        }
+
+        return found;
+    }
+
+    static void IntersectPacketScalar(RayPacket& packet, const float* const* triangles, const size_t count)
+    {
+        for (auto lane = size_t(0); lane < RayPacket::Size; lane++)
+        {
+            const auto ray = RayBase<float>(
+                Vector3Base<float>(packet.positionX[lane], packet.positionY[lane], packet.positionZ[lane]),
+                Vector3Base<float>(packet.directionX[lane], packet.directionY[lane], packet.directionZ[lane]));
+
+            auto hit = packet.GetHit(lane);
+            if (!IntersectRayScalar(ray, triangles, 0, count, hit))
+                continue;
+
+            packet.distance[lane] = hit.distance;
+            packet.u[lane] = hit.u;
+            packet.v[lane] = hit.v;
+            packet.triangle[lane] = hit.triangle;
+        }
+    }
+
+    /// <summary>
+    ///     Picks the closest of the per-lane hits of the SIMD kernels, ties go to the lower triangle index.
+    /// </summary>
+    static bool ReduceHits(const float* distance, const float* u, const float* v, const uint32_t* triangle, const size_t laneCount, RayHit& hit)
+    {
+        auto found = false;
+        for (auto lane = size_t(0); lane < laneCount; lane++)
+        {
+            if (triangle[lane] == RayHit::InvalidTriangle)
+                continue;
+
+            if (!found || distance[lane] < hit.distance || (distance[lane] == hit.distance && triangle[lane] < hit.triangle))
+            {
+                hit.distance = distance[lane];
+                hit.u = u[lane];
+                hit.v = v[lane];
+                hit.triangle = triangle[lane];
+                found = true;
+            }
+        }
+
+        return found;
+    }
+
+    static void SignedDistancesScalar(const PlaneBase<float>& plane, const Vector3Base<float>* points, float* distances, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            distances[i] = plane.Dot(points[i]);
+    }
+
+    static void ClassifyPointsScalar(const PlaneBase<float>& plane, const Vector3Base<float>* points, PlaneIntersection* results, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            results[i] = PlaneBase<float>::PlaneIntersectsPoint(plane, points[i]);
+    }
+
+    static void ClassifySpheresScalar(const PlaneBase<float>& plane, const BoundingSphereBase<float>* spheres, PlaneIntersection* results, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            results[i] = PlaneBase<float>::PlaneIntersectsSphere(plane, spheres[i]);
+    }
+
+    static void ClassifyBoxesScalar(const PlaneBase<float>& plane, const BoundingBoxBase<float>* boxes, PlaneIntersection* results, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+            results[i] = PlaneBase<float>::PlaneIntersectsBox(plane, boxes[i]);
+    }
+
+    static void SkinVerticesScalar(const Vector3Base<float>* positions, const Vector3Base<float>* normals, const uint32_t* boneIndices, const float* boneWeights,
+        const Matrix4x4Base<float>* palette, Vector3Base<float>* outPositions, Vector3Base<float>* outNormals, const size_t count)
+    {
+        const auto skinNormals = normals != nullptr && outNormals != nullptr;
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            // The first three columns of the four rows, blended over all of the influences
+            float rows[12] = {};
+            for (auto k = size_t(0); k < 4; k++)
+            {
+                const auto weight = boneWeights[i * 4 + k];
+                const auto bone = &palette[boneIndices[i * 4 + k]].m11;
+
+                for (auto r = size_t(0); r < 4; r++)
+                {
+                    rows[r * 3 + 0] += bone[r * 4 + 0] * weight;
+                    rows[r * 3 + 1] += bone[r * 4 + 1] * weight;
+                    rows[r * 3 + 2] += bone[r * 4 + 2] * weight;
+                }
+            }
+
+            const auto& position = positions[i];
+            outPositions[i] = Vector3Base<float>(
+                position.x * rows[0] + position.y * rows[3] + position.z * rows[6] + rows[9],
+                position.x * rows[1] + position.y * rows[4] + position.z * rows[7] + rows[10],
+                position.x * rows[2] + position.y * rows[5] + position.z * rows[8] + rows[11]);
+
+            if (!skinNormals)
+                continue;
+
+            const auto& normal = normals[i];
+            outNormals[i] = Vector3Base<float>(
+                normal.x * rows[0] + normal.y * rows[3] + normal.z * rows[6],
+                normal.x * rows[1] + normal.y * rows[4] + normal.z * rows[7],
+                normal.x * rows[2] + normal.y * rows[5] + normal.z * rows[8]);
+            outNormals[i].Normalize();
+        }
+    }
+
+#if SIMD_X86
+private:
+    /* SSE2 kernels */
+    SIMD_TARGET_SSE2 static void Transpose(__m128& r0, __m128& r1, __m128& r2, __m128& r3)
+    {
+        const auto t0 = _mm_unpacklo_ps(r0, r1);
+        const auto t1 = _mm_unpacklo_ps(r2, r3);
+        const auto t2 = _mm_unpackhi_ps(r0, r1);
+        const auto t3 = _mm_unpackhi_ps(r2, r3);
+
+        r0 = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        r1 = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        r2 = _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        r3 = _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    SIMD_TARGET_SSE2 static size_t StoreVisible(const uint32_t mask, const size_t laneCount, const uint32_t firstIndex, uint32_t* visibleIndices, size_t visibleCount)
+    {
+        for (auto lane = size_t(0); lane < laneCount; lane++)
+        {
+            visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(lane);
+            visibleCount += (mask >> lane) & 1u;
+        }
+
+        return visibleCount;
+    }
+
+    SIMD_TARGET_SSE2 static void MultiplyMatricesSSE2(const Matrix4x4Base<float>* a, const Matrix4x4Base<float>* b, Matrix4x4Base<float>* result, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto lhs = &a[i].m11;
+            const auto rhs = &b[i].m11;
+
+            const auto b0 = _mm_loadu_ps(rhs + 0);
+            const auto b1 = _mm_loadu_ps(rhs + 4);
+            const auto b2 = _mm_loadu_ps(rhs + 8);
+            const auto b3 = _mm_loadu_ps(rhs + 12);
+
+            __m128 rows[4];
+            for (auto r = 0; r < 4; r++)
+            {
+                const auto row = _mm_loadu_ps(lhs + r * 4);
+
+                auto value = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+                rows[r] = value;
+            }
+
+            const auto output = &result[i].m11;
+            for (auto r = 0; r < 4; r++)
+                _mm_storeu_ps(output + r * 4, rows[r]);
+        }
+    }
+
+    SIMD_TARGET_SSE2 static void TransformPointsSSE2(const Vector3Base<float>* source, const Matrix4x4Base<float>& matrix, Vector3Base<float>* destination, const size_t count)
+    {
+        const auto m11 = _mm_set1_ps(matrix.m11), m12 = _mm_set1_ps(matrix.m12), m13 = _mm_set1_ps(matrix.m13);
+        const auto m21 = _mm_set1_ps(matrix.m21), m22 = _mm_set1_ps(matrix.m22), m23 = _mm_set1_ps(matrix.m23);
+        const auto m31 = _mm_set1_ps(matrix.m31), m32 = _mm_set1_ps(matrix.m32), m33 = _mm_set1_ps(matrix.m33);
+        const auto m41 = _mm_set1_ps(matrix.m41), m42 = _mm_set1_ps(matrix.m42), m43 = _mm_set1_ps(matrix.m43);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            // Deinterleave 4 points (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) into x, y and z vectors
+            const auto input = &source[i].x;
+            const auto m03 = _mm_loadu_ps(input + 0);
+            const auto m14 = _mm_loadu_ps(input + 4);
+            const auto m25 = _mm_loadu_ps(input + 8);
+
+            const auto xy = _mm_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+            const auto yz = _mm_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+            const auto x = _mm_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+            const auto y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            const auto z = _mm_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+
+            const auto rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m11), _mm_mul_ps(y, m21)), _mm_mul_ps(z, m31)), m41);
+            const auto ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m12), _mm_mul_ps(y, m22)), _mm_mul_ps(z, m32)), m42);
+            const auto rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m13), _mm_mul_ps(y, m23)), _mm_mul_ps(z, m33)), m43);
+
+            // Interleave back
+            const auto rxy = _mm_shuffle_ps(rx, ry, _MM_SHUFFLE(2, 0, 2, 0));
+            const auto ryz = _mm_shuffle_ps(ry, rz, _MM_SHUFFLE(3, 1, 3, 1));
+            const auto rzx = _mm_shuffle_ps(rz, rx, _MM_SHUFFLE(3, 1, 2, 0));
+
+            const auto output = &destination[i].x;
+            _mm_storeu_ps(output + 0, _mm_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(output + 4, _mm_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm_storeu_ps(output + 8, _mm_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+
+        TransformPointsScalar(source + i, matrix, destination + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void MultiplyQuaternionsSSE2(const Quaternion* a, const Quaternion* b, Quaternion* result, const size_t count)
+    {
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            auto lx = _mm_loadu_ps(&a[i + 0].x);
+            auto ly = _mm_loadu_ps(&a[i + 1].x);
+            auto lz = _mm_loadu_ps(&a[i + 2].x);
+            auto lw = _mm_loadu_ps(&a[i + 3].x);
+            Transpose(lx, ly, lz, lw);
+
+            auto rx = _mm_loadu_ps(&b[i + 0].x);
+            auto ry = _mm_loadu_ps(&b[i + 1].x);
+            auto rz = _mm_loadu_ps(&b[i + 2].x);
+            auto rw = _mm_loadu_ps(&b[i + 3].x);
+            Transpose(rx, ry, rz, rw);
+
+            // Same as Quaternion::operator*=
+            const auto cx = _mm_sub_ps(_mm_mul_ps(ly, rz), _mm_mul_ps(lz, ry));
+            const auto cy = _mm_sub_ps(_mm_mul_ps(lz, rx), _mm_mul_ps(lx, rz));
+            const auto cz = _mm_sub_ps(_mm_mul_ps(lx, ry), _mm_mul_ps(ly, rx));
+            const auto dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, rx), _mm_mul_ps(ly, ry)), _mm_mul_ps(lz, rz));
+
+            auto x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, rw), _mm_mul_ps(rx, lw)), cx);
+            auto y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ly, rw), _mm_mul_ps(ry, lw)), cy);
+            auto z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lz, rw), _mm_mul_ps(rz, lw)), cz);
+            auto w = _mm_sub_ps(_mm_mul_ps(lw, rw), dot);
+            Transpose(x, y, z, w);
+
+            _mm_storeu_ps(&result[i + 0].x, x);
+            _mm_storeu_ps(&result[i + 1].x, y);
+            _mm_storeu_ps(&result[i + 2].x, z);
+            _mm_storeu_ps(&result[i + 3].x, w);
+        }
+
+        MultiplyQuaternionsScalar(a + i, b + i, result + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static size_t CullBoxesSSE2(const PlaneBase<float>* planes, const size_t planeCount, const BoundingBoxBase<float>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex)
+    {
+        const auto half = _mm_set1_ps(0.5f);
+        const auto signMask = _mm_set1_ps(-0.0f);
+
+        auto visibleCount = size_t(0);
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            // Every box is loaded as (cx cy cz sx) and (cz sx sy sz), both transposed into SoA vectors
+            const auto box = &boxes[i].center.x;
+            auto cx = _mm_loadu_ps(box + 0), cy = _mm_loadu_ps(box + 6), cz = _mm_loadu_ps(box + 12), sx = _mm_loadu_ps(box + 18);
+            auto cz2 = _mm_loadu_ps(box + 2), sx2 = _mm_loadu_ps(box + 8), sy = _mm_loadu_ps(box + 14), sz = _mm_loadu_ps(box + 20);
+            Transpose(cx, cy, cz, sx);
+            Transpose(cz2, sx2, sy, sz);
+
+            const auto ex = _mm_mul_ps(sx, half);
+            const auto ey = _mm_mul_ps(sy, half);
+            const auto ez = _mm_mul_ps(sz, half);
+
+            auto visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (auto p = size_t(0); p < planeCount; p++)
+            {
+                const auto& plane = planes[p];
+                const auto nx = _mm_set1_ps(plane.normal.x);
+                const auto ny = _mm_set1_ps(plane.normal.y);
+                const auto nz = _mm_set1_ps(plane.normal.z);
+
+                const auto distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_mul_ps(nz, cz)), _mm_set1_ps(plane.distance));
+                const auto radius = _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+                    _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+                    _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+
+                visible = _mm_and_ps(visible, _mm_cmpnlt_ps(distance, _mm_xor_ps(radius, signMask)));
+            }
+
+            const auto mask = static_cast<uint32_t>(_mm_movemask_ps(visible));
+            visibleCount = StoreVisible(mask, 4, firstIndex + static_cast<uint32_t>(i), visibleIndices, visibleCount);
+        }
+
+        return visibleCount + CullBoxesScalar(planes, planeCount, boxes + i, count - i, visibleIndices + visibleCount, firstIndex + static_cast<uint32_t>(i));
+    }
+
+    SIMD_TARGET_SSE2 static size_t CullSpheresSSE2(const PlaneBase<float>* planes, const size_t planeCount, const BoundingSphereBase<float>* spheres, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex)
+    {
+        const auto signMask = _mm_set1_ps(-0.0f);
+
+        auto visibleCount = size_t(0);
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            auto x = _mm_loadu_ps(&spheres[i + 0].center.x);
+            auto y = _mm_loadu_ps(&spheres[i + 1].center.x);
+            auto z = _mm_loadu_ps(&spheres[i + 2].center.x);
+            auto radius = _mm_loadu_ps(&spheres[i + 3].center.x);
+            Transpose(x, y, z, radius);
+
+            const auto negativeRadius = _mm_xor_ps(radius, signMask);
+
+            auto visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (auto p = size_t(0); p < planeCount; p++)
+            {
+                const auto& plane = planes[p];
+                const auto distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(plane.normal.x), x),
+                    _mm_mul_ps(_mm_set1_ps(plane.normal.y), y)),
+                    _mm_mul_ps(_mm_set1_ps(plane.normal.z), z)),
+                    _mm_set1_ps(plane.distance));
+
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negativeRadius));
+            }
+
+            const auto mask = static_cast<uint32_t>(_mm_movemask_ps(visible));
+            visibleCount = StoreVisible(mask, 4, firstIndex + static_cast<uint32_t>(i), visibleIndices, visibleCount);
+        }
+
+        return visibleCount + CullSpheresScalar(planes, planeCount, spheres + i, count - i, visibleIndices + visibleCount, firstIndex + static_cast<uint32_t>(i));
+    }
+
+    SIMD_TARGET_SSE2 static BoundingBoxBase<float> FromPointsSSE2(const Vector3Base<float>* points, const size_t count)
+    {
+        if (count < 4)
+            return FromPointsScalar(points, count);
+
+        // 4 points are 3 registers, every lane always sees the same component
+        const auto values = &points[0].x;
+        __m128 minimum[3];
+        __m128 maximum[3];
+        for (auto r = 0; r < 3; r++)
+            minimum[r] = maximum[r] = _mm_loadu_ps(values + r * 4);
+
+        auto i = size_t(4);
+        for (; i + 4 <= count; i += 4)
+        {
+            for (auto r = 0; r < 3; r++)
+            {
+                const auto value = _mm_loadu_ps(values + i * 3 + r * 4);
+                minimum[r] = _mm_min_ps(minimum[r], value);
+                maximum[r] = _mm_max_ps(maximum[r], value);
+            }
+        }
+
+        float minimumValues[12];
+        float maximumValues[12];
+        for (auto r = 0; r < 3; r++)
+        {
+            _mm_storeu_ps(minimumValues + r * 4, minimum[r]);
+            _mm_storeu_ps(maximumValues + r * 4, maximum[r]);
+        }
+
+        return FoldBounds(minimumValues, maximumValues, 12, points + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static __m128 Select(const __m128 mask, const __m128 a, const __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    SIMD_TARGET_SSE2 static void SinCos(const __m128 angle, __m128& sin, __m128& cos)
+    {
+        // Reduce to [-pi/4, pi/4] by the nearest multiple of pi/2, subtracted in three parts to keep the precision
+        const auto quadrant = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(0.636619772f)));
+        const auto multiple = _mm_cvtepi32_ps(quadrant);
+
+        auto r = _mm_sub_ps(angle, _mm_mul_ps(multiple, _mm_set1_ps(1.5703125f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(multiple, _mm_set1_ps(4.837512969970703125e-4f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(multiple, _mm_set1_ps(7.54978995489188216e-8f)));
+        const auto r2 = _mm_mul_ps(r, r);
+
+        // Minimax polynomials of the reduced angle
+        auto sinR = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), r2), _mm_set1_ps(8.3321608736e-3f));
+        sinR = _mm_add_ps(_mm_mul_ps(sinR, r2), _mm_set1_ps(-1.6666654611e-1f));
+        sinR = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinR, r2), r), r);
+
+        auto cosR = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), r2), _mm_set1_ps(-1.388731625493765e-3f));
+        cosR = _mm_add_ps(_mm_mul_ps(cosR, r2), _mm_set1_ps(4.166664568298827e-2f));
+        cosR = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cosR, r2), r2), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, _mm_set1_ps(0.5f))));
+
+        // Odd quadrants swap the two, quadrants 2 and 3 negate the sine, quadrants 1 and 2 the cosine
+        const auto one = _mm_set1_epi32(1);
+        const auto swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+        const auto sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+        const auto cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), _mm_set1_epi32(2)), 30));
+
+        sin = _mm_xor_ps(Select(swap, cosR, sinR), sinSign);
+        cos = _mm_xor_ps(Select(swap, sinR, cosR), cosSign);
+    }
+
+    SIMD_TARGET_SSE2 static __m128 Atan2(const __m128 y, const __m128 x)
+    {
+        const auto signMask = _mm_set1_ps(-0.0f);
+        const auto absoluteX = _mm_andnot_ps(signMask, x);
+        const auto absoluteY = _mm_andnot_ps(signMask, y);
+
+        // atan of the ratio in [0, 1], the octant is restored afterwards
+        const auto swap = _mm_cmpgt_ps(absoluteY, absoluteX);
+        const auto numerator = Select(swap, absoluteX, absoluteY);
+        const auto denominator = Select(swap, absoluteY, absoluteX);
+        const auto ratio = _mm_and_ps(_mm_div_ps(numerator, denominator), _mm_cmpgt_ps(denominator, _mm_setzero_ps()));
+
+        // Ratios above tan(pi/8) are reduced using atan(t) = pi/4 + atan((t - 1) / (t + 1))
+        const auto one = _mm_set1_ps(1.0f);
+        const auto reduce = _mm_cmpgt_ps(ratio, _mm_set1_ps(0.414213562f));
+        const auto t = Select(reduce, _mm_div_ps(_mm_sub_ps(ratio, one), _mm_add_ps(ratio, one)), ratio);
+        const auto t2 = _mm_mul_ps(t, t);
+
+        auto result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(8.05374449538e-2f), t2), _mm_set1_ps(-1.38776856032e-1f));
+        result = _mm_add_ps(_mm_mul_ps(result, t2), _mm_set1_ps(1.99777106478e-1f));
+        result = _mm_add_ps(_mm_mul_ps(result, t2), _mm_set1_ps(-3.33329491539e-1f));
+        result = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(result, t2), t), t);
+        result = _mm_add_ps(result, _mm_and_ps(reduce, _mm_set1_ps(0.785398163f)));
+
+        result = Select(swap, _mm_sub_ps(_mm_set1_ps(1.570796327f), result), result);
+        result = Select(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(3.141592654f), result), result);
+        return _mm_or_ps(result, _mm_and_ps(y, signMask));
+    }
+
+    SIMD_TARGET_SSE2 static void EulerToQuaternionsSSE2(const float* yaw, const float* pitch, const float* roll, float* x, float* y, float* z, float* w, const size_t count)
+    {
+        const auto half = _mm_set1_ps(0.5f);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 sinYaw, cosYaw, sinPitch, cosPitch, sinRoll, cosRoll;
+            SinCos(_mm_mul_ps(_mm_loadu_ps(yaw + i), half), sinYaw, cosYaw);
+            SinCos(_mm_mul_ps(_mm_loadu_ps(pitch + i), half), sinPitch, cosPitch);
+            SinCos(_mm_mul_ps(_mm_loadu_ps(roll + i), half), sinRoll, cosRoll);
+
+            // Same as Quaternion::Rotation(yaw, pitch, roll)
+            const auto cosYawCosPitch = _mm_mul_ps(cosYaw, cosPitch);
+            const auto sinYawSinPitch = _mm_mul_ps(sinYaw, sinPitch);
+            const auto cosYawSinPitch = _mm_mul_ps(cosYaw, sinPitch);
+            const auto sinYawCosPitch = _mm_mul_ps(sinYaw, cosPitch);
+
+            _mm_storeu_ps(x + i, _mm_add_ps(_mm_mul_ps(cosYawSinPitch, cosRoll), _mm_mul_ps(sinYawCosPitch, sinRoll)));
+            _mm_storeu_ps(y + i, _mm_sub_ps(_mm_mul_ps(sinYawCosPitch, cosRoll), _mm_mul_ps(cosYawSinPitch, sinRoll)));
+            _mm_storeu_ps(z + i, _mm_sub_ps(_mm_mul_ps(cosYawCosPitch, sinRoll), _mm_mul_ps(sinYawSinPitch, cosRoll)));
+            _mm_storeu_ps(w + i, _mm_add_ps(_mm_mul_ps(cosYawCosPitch, cosRoll), _mm_mul_ps(sinYawSinPitch, sinRoll)));
+        }
+
+        EulerToQuaternionsScalar(yaw + i, pitch + i, roll + i, x + i, y + i, z + i, w + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void QuaternionsToEulerSSE2(const float* x, const float* y, const float* z, const float* w, float* yaw, float* pitch, float* roll, const size_t count)
+    {
+        const auto one = _mm_set1_ps(1.0f);
+        const auto two = _mm_set1_ps(2.0f);
+        const auto signMask = _mm_set1_ps(-0.0f);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            const auto qx = _mm_loadu_ps(x + i);
+            const auto qy = _mm_loadu_ps(y + i);
+            const auto qz = _mm_loadu_ps(z + i);
+            const auto qw = _mm_loadu_ps(w + i);
+
+            const auto xx = _mm_mul_ps(qx, qx);
+            const auto yy = _mm_mul_ps(qy, qy);
+            const auto zz = _mm_mul_ps(qz, qz);
+
+            // Same as QuaternionsToEulerScalar, asin(s) is atan2(s, sqrt(1 - s^2))
+            auto sinPitch = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qx, qw), _mm_mul_ps(qy, qz)));
+            sinPitch = _mm_max_ps(_mm_min_ps(sinPitch, one), _mm_set1_ps(-1.0f));
+            const auto cosPitch = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(sinPitch, sinPitch)), _mm_setzero_ps()));
+
+            const auto zx = _mm_mul_ps(qz, qx);
+            const auto yw = _mm_mul_ps(qy, qw);
+            const auto yawDefault = Atan2(_mm_mul_ps(two, _mm_add_ps(zx, yw)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))));
+            const auto yawLocked = Atan2(_mm_mul_ps(two, _mm_sub_ps(yw, zx)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+            const auto rollDefault = Atan2(_mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(qx, qy), _mm_mul_ps(qz, qw))), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(zz, xx))));
+
+            const auto locked = _mm_cmpge_ps(_mm_andnot_ps(signMask, sinPitch), _mm_set1_ps(GimbalLockSine));
+
+            _mm_storeu_ps(yaw + i, Select(locked, yawLocked, yawDefault));
+            _mm_storeu_ps(pitch + i, Atan2(sinPitch, cosPitch));
+            _mm_storeu_ps(roll + i, _mm_andnot_ps(locked, rollDefault));
+        }
+
+        QuaternionsToEulerScalar(x + i, y + i, z + i, w + i, yaw + i, pitch + i, roll + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void QuaternionsToMatricesSSE2(const float* x, const float* y, const float* z, const float* w, Matrix4x4Base<float>* matrices, const size_t count)
+    {
+        const auto one = _mm_set1_ps(1.0f);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            const auto qx = _mm_loadu_ps(x + i);
+            const auto qy = _mm_loadu_ps(y + i);
+            const auto qz = _mm_loadu_ps(z + i);
+            const auto qw = _mm_loadu_ps(w + i);
+
+            // Same as CreateRotationMatrix
+            const auto x2 = _mm_add_ps(qx, qx);
+            const auto y2 = _mm_add_ps(qy, qy);
+            const auto z2 = _mm_add_ps(qz, qz);
+            const auto wx = _mm_mul_ps(qw, x2);
+            const auto wy = _mm_mul_ps(qw, y2);
+            const auto wz = _mm_mul_ps(qw, z2);
+            const auto xx = _mm_mul_ps(qx, x2);
+            const auto xy = _mm_mul_ps(qx, y2);
+            const auto xz = _mm_mul_ps(qx, z2);
+            const auto yy = _mm_mul_ps(qy, y2);
+            const auto yz = _mm_mul_ps(qy, z2);
+            const auto zz = _mm_mul_ps(qz, z2);
+
+            __m128 rows[3][4] = {
+                { _mm_sub_ps(_mm_sub_ps(one, yy), zz), _mm_add_ps(xy, wz), _mm_sub_ps(xz, wy), _mm_setzero_ps() },
+                { _mm_sub_ps(xy, wz), _mm_sub_ps(_mm_sub_ps(one, xx), zz), _mm_add_ps(yz, wx), _mm_setzero_ps() },
+                { _mm_add_ps(xz, wy), _mm_sub_ps(yz, wx), _mm_sub_ps(_mm_sub_ps(one, xx), yy), _mm_setzero_ps() }
+            };
+
+            // Every transposed row holds the same row of the 4 matrices
+            for (auto r = 0; r < 3; r++)
+            {
+                Transpose(rows[r][0], rows[r][1], rows[r][2], rows[r][3]);
+                for (auto k = 0; k < 4; k++)
+                    _mm_storeu_ps(&matrices[i + k].m11 + r * 4, rows[r][k]);
+            }
+
+            for (auto k = 0; k < 4; k++)
+                _mm_storeu_ps(&matrices[i + k].m41, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+        }
+
+        QuaternionsToMatricesScalar(x + i, y + i, z + i, w + i, matrices + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void RotationToQuaternion(const __m128 (&m)[3][4], __m128& qx, __m128& qy, __m128& qz, __m128& qw)
+    {
+        // m[r][c] holds element (r + 1, c + 1) of 4 rotation matrices
+        const auto one = _mm_set1_ps(1.0f);
+        const auto half = _mm_set1_ps(0.5f);
+
+        // Same cases as Quaternion::Rotation(matrix), the largest of w, x, y and z is computed from the diagonal
+        // and the others from the off-diagonal sums or differences, every lane selects its own case
+        const auto trace = _mm_add_ps(_mm_add_ps(m[0][0], m[1][1]), m[2][2]);
+        const auto caseW = _mm_cmpgt_ps(trace, _mm_setzero_ps());
+        const auto caseX = _mm_andnot_ps(caseW, _mm_and_ps(_mm_cmpge_ps(m[0][0], m[1][1]), _mm_cmpge_ps(m[0][0], m[2][2])));
+        const auto caseY = _mm_andnot_ps(_mm_or_ps(caseW, caseX), _mm_cmpgt_ps(m[1][1], m[2][2]));
+        const auto caseZ = _mm_andnot_ps(_mm_or_ps(_mm_or_ps(caseW, caseX), caseY), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+
+        // 1 + m11 + m22 + m33 with the signs of the diagonal flipped by the case
+        const auto negativeX = _mm_and_ps(_mm_or_ps(caseY, caseZ), _mm_set1_ps(-0.0f));
+        const auto negativeY = _mm_and_ps(_mm_or_ps(caseX, caseZ), _mm_set1_ps(-0.0f));
+        const auto negativeZ = _mm_and_ps(_mm_or_ps(caseX, caseY), _mm_set1_ps(-0.0f));
+        const auto largestSquared = _mm_add_ps(_mm_add_ps(one, _mm_xor_ps(m[0][0], negativeX)),
+            _mm_add_ps(_mm_xor_ps(m[1][1], negativeY), _mm_xor_ps(m[2][2], negativeZ)));
+
+        const auto root = _mm_sqrt_ps(largestSquared);
+        const auto scale = _mm_div_ps(half, root);
+        const auto largest = _mm_mul_ps(half, root);
+
+        const auto differenceX = _mm_sub_ps(m[1][2], m[2][1]);
+        const auto differenceY = _mm_sub_ps(m[2][0], m[0][2]);
+        const auto differenceZ = _mm_sub_ps(m[0][1], m[1][0]);
+        const auto sumXY = _mm_add_ps(m[0][1], m[1][0]);
+        const auto sumXZ = _mm_add_ps(m[0][2], m[2][0]);
+        const auto sumYZ = _mm_add_ps(m[1][2], m[2][1]);
+
+        qx = Select(caseX, largest, _mm_mul_ps(Select(caseW, differenceX, Select(caseY, sumXY, sumXZ)), scale));
+        qy = Select(caseY, largest, _mm_mul_ps(Select(caseW, differenceY, Select(caseX, sumXY, sumYZ)), scale));
+        qz = Select(caseZ, largest, _mm_mul_ps(Select(caseW, differenceZ, Select(caseX, sumXZ, sumYZ)), scale));
+        qw = Select(caseW, largest, _mm_mul_ps(Select(caseX, differenceX, Select(caseY, differenceY, differenceZ)), scale));
+    }
+
+    SIMD_TARGET_SSE2 static void MatricesToQuaternionsSSE2(const Matrix4x4Base<float>* matrices, float* x, float* y, float* z, float* w, const size_t count)
+    {
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 m[3][4];
+            for (auto r = 0; r < 3; r++)
+            {
+                for (auto k = 0; k < 4; k++)
+                    m[r][k] = _mm_loadu_ps(&matrices[i + k].m11 + r * 4);
+                Transpose(m[r][0], m[r][1], m[r][2], m[r][3]);
+            }
+
+            __m128 qx, qy, qz, qw;
+            RotationToQuaternion(m, qx, qy, qz, qw);
+
+            _mm_storeu_ps(x + i, qx);
+            _mm_storeu_ps(y + i, qy);
+            _mm_storeu_ps(z + i, qz);
+            _mm_storeu_ps(w + i, qw);
+        }
+
+        MatricesToQuaternionsScalar(matrices + i, x + i, y + i, z + i, w + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void LoadVector3x4(const float* input, __m128& x, __m128& y, __m128& z)
+    {
+        // Deinterleave 4 vectors (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3)
+        const auto m03 = _mm_loadu_ps(input + 0);
+        const auto m14 = _mm_loadu_ps(input + 4);
+        const auto m25 = _mm_loadu_ps(input + 8);
+
+        const auto xy = _mm_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+        const auto yz = _mm_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+        x = _mm_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+        y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        z = _mm_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+    }
+
+    SIMD_TARGET_SSE2 static void ComposeTransforms4(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, __m128 (&m)[4][3])
+    {
+        // m[r][c] receives element (r + 1, c + 1) of the 4 transforms, same as Matrix4x4Base::CreateTransform
+        auto qx = _mm_loadu_ps(&rotations[0].x);
+        auto qy = _mm_loadu_ps(&rotations[1].x);
+        auto qz = _mm_loadu_ps(&rotations[2].x);
+        auto qw = _mm_loadu_ps(&rotations[3].x);
+        Transpose(qx, qy, qz, qw);
+
+        __m128 sx, sy, sz;
+        LoadVector3x4(&scales[0].x, sx, sy, sz);
+        LoadVector3x4(&positions[0].x, m[3][0], m[3][1], m[3][2]);
+
+        const auto one = _mm_set1_ps(1.0f);
+        const auto x2 = _mm_add_ps(qx, qx);
+        const auto y2 = _mm_add_ps(qy, qy);
+        const auto z2 = _mm_add_ps(qz, qz);
+        const auto wx = _mm_mul_ps(qw, x2);
+        const auto wy = _mm_mul_ps(qw, y2);
+        const auto wz = _mm_mul_ps(qw, z2);
+        const auto xx = _mm_mul_ps(qx, x2);
+        const auto xy = _mm_mul_ps(qx, y2);
+        const auto xz = _mm_mul_ps(qx, z2);
+        const auto yy = _mm_mul_ps(qy, y2);
+        const auto yz = _mm_mul_ps(qy, z2);
+        const auto zz = _mm_mul_ps(qz, z2);
+
+        m[0][0] = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_add_ps(yy, zz)));
+        m[0][1] = _mm_mul_ps(sx, _mm_add_ps(xy, wz));
+        m[0][2] = _mm_mul_ps(sx, _mm_sub_ps(xz, wy));
+        m[1][0] = _mm_mul_ps(sy, _mm_sub_ps(xy, wz));
+        m[1][1] = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_add_ps(zz, xx)));
+        m[1][2] = _mm_mul_ps(sy, _mm_add_ps(yz, wx));
+        m[2][0] = _mm_mul_ps(sz, _mm_add_ps(xz, wy));
+        m[2][1] = _mm_mul_ps(sz, _mm_sub_ps(yz, wx));
+        m[2][2] = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_add_ps(yy, xx)));
+    }
+
+    SIMD_TARGET_SSE2 static void ComposeTransformsSSE2(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, Matrix4x4Base<float>* matrices, const size_t count)
+    {
+        const auto zero = _mm_setzero_ps();
+        const auto one = _mm_set1_ps(1.0f);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 m[4][3];
+            ComposeTransforms4(positions + i, rotations + i, scales + i, m);
+
+            for (auto r = 0; r < 4; r++)
+            {
+                auto r0 = m[r][0], r1 = m[r][1], r2 = m[r][2], r3 = r == 3 ? one : zero;
+                Transpose(r0, r1, r2, r3);
+                _mm_storeu_ps(&matrices[i + 0].m11 + r * 4, r0);
+                _mm_storeu_ps(&matrices[i + 1].m11 + r * 4, r1);
+                _mm_storeu_ps(&matrices[i + 2].m11 + r * 4, r2);
+                _mm_storeu_ps(&matrices[i + 3].m11 + r * 4, r3);
+            }
+        }
+
+        ComposeTransformsScalar(positions + i, rotations + i, scales + i, matrices + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void ComposeTransforms3x4SSE2(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, float* rows, const size_t count)
+    {
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 m[4][3];
+            ComposeTransforms4(positions + i, rotations + i, scales + i, m);
+
+            // Column c of the 4 transforms, transposed into one output row per transform
+            for (auto c = 0; c < 3; c++)
+            {
+                auto r0 = m[0][c], r1 = m[1][c], r2 = m[2][c], r3 = m[3][c];
+                Transpose(r0, r1, r2, r3);
+                _mm_storeu_ps(rows + (i + 0) * 12 + c * 4, r0);
+                _mm_storeu_ps(rows + (i + 1) * 12 + c * 4, r1);
+                _mm_storeu_ps(rows + (i + 2) * 12 + c * 4, r2);
+                _mm_storeu_ps(rows + (i + 3) * 12 + c * 4, r3);
+            }
+        }
+
+        ComposeTransforms3x4Scalar(positions + i, rotations + i, scales + i, rows + i * 12, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void DecomposeTransformsSSE2(const Matrix4x4Base<float>* matrices, Vector3Base<float>* positions, Quaternion* rotations, Vector3Base<float>* scales, const size_t count)
+    {
+        const auto zero = _mm_setzero_ps();
+        const auto one = _mm_set1_ps(1.0f);
+        const auto signMask = _mm_set1_ps(-0.0f);
+        const auto tolerance = _mm_set1_ps(Math::ZeroTolerance);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 m[3][4];
+            for (auto r = 0; r < 3; r++)
+            {
+                for (auto k = 0; k < 4; k++)
+                    m[r][k] = _mm_loadu_ps(&matrices[i + k].m11 + r * 4);
+                Transpose(m[r][0], m[r][1], m[r][2], m[r][3]);
+            }
+
+            for (auto k = 0; k < 4; k++)
+                positions[i + k] = Vector3Base<float>(matrices[i + k].m41, matrices[i + k].m42, matrices[i + k].m43);
+
+            // Same as Matrix4x4Base::DecomposeTransform, the row lengths are the scale and a negative determinant mirrors x
+            __m128 scale[3];
+            __m128 inverseScale[3];
+            for (auto r = 0; r < 3; r++)
+            {
+                scale[r] = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m[r][0], m[r][0]), _mm_mul_ps(m[r][1], m[r][1])), _mm_mul_ps(m[r][2], m[r][2])));
+                inverseScale[r] = _mm_and_ps(_mm_div_ps(one, scale[r]), _mm_cmpge_ps(scale[r], tolerance));
+            }
+
+            const auto determinant = _mm_add_ps(_mm_sub_ps(
+                _mm_mul_ps(m[0][0], _mm_sub_ps(_mm_mul_ps(m[1][1], m[2][2]), _mm_mul_ps(m[1][2], m[2][1]))),
+                _mm_mul_ps(m[0][1], _mm_sub_ps(_mm_mul_ps(m[1][0], m[2][2]), _mm_mul_ps(m[1][2], m[2][0])))),
+                _mm_mul_ps(m[0][2], _mm_sub_ps(_mm_mul_ps(m[1][0], m[2][1]), _mm_mul_ps(m[1][1], m[2][0]))));
+            const auto mirror = _mm_and_ps(_mm_cmplt_ps(determinant, zero), signMask);
+            scale[0] = _mm_xor_ps(scale[0], mirror);
+            inverseScale[0] = _mm_xor_ps(inverseScale[0], mirror);
+
+            for (auto r = 0; r < 3; r++)
+            {
+                for (auto c = 0; c < 3; c++)
+                    m[r][c] = _mm_mul_ps(m[r][c], inverseScale[r]);
+            }
+
+            __m128 qx, qy, qz, qw;
+            RotationToQuaternion(m, qx, qy, qz, qw);
+
+            // Quaternion::Normalize keeps zero-length quaternions unchanged
+            const auto lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)), _mm_add_ps(_mm_mul_ps(qz, qz), _mm_mul_ps(qw, qw)));
+            const auto inverseLength = Select(_mm_cmpge_ps(lengthSquared, tolerance), _mm_div_ps(one, _mm_sqrt_ps(lengthSquared)), one);
+            qx = _mm_mul_ps(qx, inverseLength);
+            qy = _mm_mul_ps(qy, inverseLength);
+            qz = _mm_mul_ps(qz, inverseLength);
+            qw = _mm_mul_ps(qw, inverseLength);
+
+            Transpose(qx, qy, qz, qw);
+            _mm_storeu_ps(&rotations[i + 0].x, qx);
+            _mm_storeu_ps(&rotations[i + 1].x, qy);
+            _mm_storeu_ps(&rotations[i + 2].x, qz);
+            _mm_storeu_ps(&rotations[i + 3].x, qw);
+
+            float scaleValues[4][4];
+            auto unused = zero;
+            Transpose(scale[0], scale[1], scale[2], unused);
+            for (auto k = 0; k < 3; k++)
+                _mm_storeu_ps(scaleValues[k], scale[k]);
+            _mm_storeu_ps(scaleValues[3], unused);
+
+            for (auto k = 0; k < 4; k++)
+                scales[i + k] = Vector3Base<float>(scaleValues[k][0], scaleValues[k][1], scaleValues[k][2]);
+        }
+
+        DecomposeTransformsScalar(matrices + i, positions + i, rotations + i, scales + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void TriangleNormalsSSE2(const Vector3Base<float>* positions, const uint32_t* indices, float* x, float* y, float* z,
+        float* weight0, float* weight1, float* weight2, const size_t count)
+    {
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            // There is no gather, the corners of the four triangles are transposed while loading
+            __m128 p[3][3];
+            for (auto k = 0; k < 3; k++)
+            {
+                const auto& a = positions[indices[i * 3 + k]];
+                const auto& b = positions[indices[i * 3 + 3 + k]];
+                const auto& c = positions[indices[i * 3 + 6 + k]];
+                const auto& d = positions[indices[i * 3 + 9 + k]];
+
+                p[k][0] = _mm_setr_ps(a.x, b.x, c.x, d.x);
+                p[k][1] = _mm_setr_ps(a.y, b.y, c.y, d.y);
+                p[k][2] = _mm_setr_ps(a.z, b.z, c.z, d.z);
+            }
+
+            __m128 edge01[3], edge02[3], edge12[3];
+            for (auto c = 0; c < 3; c++)
+            {
+                edge01[c] = _mm_sub_ps(p[1][c], p[0][c]);
+                edge02[c] = _mm_sub_ps(p[2][c], p[0][c]);
+                edge12[c] = _mm_sub_ps(p[2][c], p[1][c]);
+            }
+
+            const auto normalX = _mm_sub_ps(_mm_mul_ps(edge01[1], edge02[2]), _mm_mul_ps(edge01[2], edge02[1]));
+            const auto normalY = _mm_sub_ps(_mm_mul_ps(edge01[2], edge02[0]), _mm_mul_ps(edge01[0], edge02[2]));
+            const auto normalZ = _mm_sub_ps(_mm_mul_ps(edge01[0], edge02[1]), _mm_mul_ps(edge01[1], edge02[0]));
+
+            _mm_storeu_ps(x + i, normalX);
+            _mm_storeu_ps(y + i, normalY);
+            _mm_storeu_ps(z + i, normalZ);
+
+            if (weight0 == nullptr)
+                continue;
+
+            const auto length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, normalX), _mm_mul_ps(normalY, normalY)), _mm_mul_ps(normalZ, normalZ)));
+            const auto scale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), length), _mm_cmpgt_ps(length, _mm_setzero_ps()));
+
+            const auto dot0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge01[0], edge02[0]), _mm_mul_ps(edge01[1], edge02[1])), _mm_mul_ps(edge01[2], edge02[2]));
+            const auto dot1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge01[0], edge12[0]), _mm_mul_ps(edge01[1], edge12[1])), _mm_mul_ps(edge01[2], edge12[2]));
+            const auto dot2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge02[0], edge12[0]), _mm_mul_ps(edge02[1], edge12[1])), _mm_mul_ps(edge02[2], edge12[2]));
+
+            _mm_storeu_ps(weight0 + i, _mm_mul_ps(Atan2(length, dot0), scale));
+            _mm_storeu_ps(weight1 + i, _mm_mul_ps(Atan2(length, _mm_xor_ps(dot1, _mm_set1_ps(-0.0f))), scale));
+            _mm_storeu_ps(weight2 + i, _mm_mul_ps(Atan2(length, dot2), scale));
+        }
+
+        TriangleNormalsScalar(positions, indices + i * 3, x + i, y + i, z + i,
+            weight0 != nullptr ? weight0 + i : nullptr, weight1 != nullptr ? weight1 + i : nullptr, weight2 != nullptr ? weight2 + i : nullptr, count - i);
+    }
+
+    /// <summary>
+    ///     Moller-Trumbore for four ray and triangle pairs, same operations as RayBase::IntersectsEdges.
+    ///     Returns the mask of the hits at a non-negative distance.
+    /// </summary>
+    SIMD_TARGET_SSE2 static __m128 IntersectSSE2(const __m128 (&position)[3], const __m128 (&direction)[3],
+        const __m128 (&corner)[3], const __m128 (&edge1)[3], const __m128 (&edge2)[3], __m128& distance, __m128& u, __m128& v)
+    {
+        const auto zero = _mm_setzero_ps();
+
+        const auto pX = _mm_sub_ps(_mm_mul_ps(direction[1], edge2[2]), _mm_mul_ps(direction[2], edge2[1]));
+        const auto pY = _mm_sub_ps(_mm_mul_ps(direction[2], edge2[0]), _mm_mul_ps(direction[0], edge2[2]));
+        const auto pZ = _mm_sub_ps(_mm_mul_ps(direction[0], edge2[1]), _mm_mul_ps(direction[1], edge2[0]));
+        const auto determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge1[0], pX), _mm_mul_ps(edge1[1], pY)), _mm_mul_ps(edge1[2], pZ));
+        const auto inverse = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+
+        const auto offsetX = _mm_sub_ps(position[0], corner[0]);
+        const auto offsetY = _mm_sub_ps(position[1], corner[1]);
+        const auto offsetZ = _mm_sub_ps(position[2], corner[2]);
+        const auto qX = _mm_sub_ps(_mm_mul_ps(offsetY, edge1[2]), _mm_mul_ps(offsetZ, edge1[1]));
+        const auto qY = _mm_sub_ps(_mm_mul_ps(offsetZ, edge1[0]), _mm_mul_ps(offsetX, edge1[2]));
+        const auto qZ = _mm_sub_ps(_mm_mul_ps(offsetX, edge1[1]), _mm_mul_ps(offsetY, edge1[0]));
+
+        u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(offsetX, pX), _mm_mul_ps(offsetY, pY)), _mm_mul_ps(offsetZ, pZ)), inverse);
+        v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(direction[0], qX), _mm_mul_ps(direction[1], qY)), _mm_mul_ps(direction[2], qZ)), inverse);
+        distance = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edge2[0], qX), _mm_mul_ps(edge2[1], qY)), _mm_mul_ps(edge2[2], qZ)), inverse);
+
+        // The ordered comparisons also reject the NaN quotients of degenerate triangles
+        auto hit = _mm_and_ps(_mm_cmpneq_ps(determinant, zero), _mm_cmpge_ps(distance, zero));
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)));
+        return _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+    }
+
+    SIMD_TARGET_SSE2 static bool IntersectRaySSE2(const RayBase<float>& ray, const float* const* triangles, const size_t begin, const size_t end, RayHit& hit)
+    {
+        const __m128 position[3] = { _mm_set1_ps(ray.position.x), _mm_set1_ps(ray.position.y), _mm_set1_ps(ray.position.z) };
+        const __m128 direction[3] = { _mm_set1_ps(ray.direction.x), _mm_set1_ps(ray.direction.y), _mm_set1_ps(ray.direction.z) };
+
+        // Every lane keeps the closest hit of its own triangles, reduced once at the end
+        auto bestDistance = _mm_set1_ps(hit.distance);
+        auto bestU = _mm_setzero_ps();
+        auto bestV = _mm_setzero_ps();
+        auto bestTriangle = _mm_set1_epi32(-1);
+        auto indices = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(begin)), _mm_setr_epi32(0, 1, 2, 3));
+
+        auto i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 corner[3], edge1[3], edge2[3];
+            for (auto c = 0; c < 3; c++)
+            {
+                corner[c] = _mm_loadu_ps(triangles[c] + i);
+                edge1[c] = _mm_loadu_ps(triangles[3 + c] + i);
+                edge2[c] = _mm_loadu_ps(triangles[6 + c] + i);
+            }
+
+            __m128 distance, u, v;
+            const auto intersects = IntersectSSE2(position, direction, corner, edge1, edge2, distance, u, v);
+            const auto closer = _mm_and_ps(intersects, _mm_cmplt_ps(distance, bestDistance));
+
+            bestDistance = Select(closer, distance, bestDistance);
+            bestU = Select(closer, u, bestU);
+            bestV = Select(closer, v, bestV);
+            bestTriangle = _mm_castps_si128(Select(closer, _mm_castsi128_ps(indices), _mm_castsi128_ps(bestTriangle)));
+            indices = _mm_add_epi32(indices, _mm_set1_epi32(4));
+        }
+
+        float distances[4], us[4], vs[4];
+        uint32_t indexValues[4];
+        _mm_storeu_ps(distances, bestDistance);
+        _mm_storeu_ps(us, bestU);
+        _mm_storeu_ps(vs, bestV);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(indexValues), bestTriangle);
+
+        // The remaining triangles have higher indices, so they only replace strictly closer hits
+        const auto found = ReduceHits(distances, us, vs, indexValues, 4, hit);
+        return IntersectRayScalar(ray, triangles, i, end, hit) || found;
+    }
+
+    SIMD_TARGET_SSE2 static void IntersectPacketSSE2(RayPacket& packet, const float* const* triangles, const size_t count)
+    {
+        for (auto half = size_t(0); half < RayPacket::Size; half += 4)
+        {
+            const __m128 position[3] = { _mm_loadu_ps(packet.positionX + half), _mm_loadu_ps(packet.positionY + half), _mm_loadu_ps(packet.positionZ + half) };
+            const __m128 direction[3] = { _mm_loadu_ps(packet.directionX + half), _mm_loadu_ps(packet.directionY + half), _mm_loadu_ps(packet.directionZ + half) };
+
+            auto bestDistance = _mm_loadu_ps(packet.distance + half);
+            auto bestU = _mm_loadu_ps(packet.u + half);
+            auto bestV = _mm_loadu_ps(packet.v + half);
+            auto bestTriangle = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(packet.triangle + half)));
+
+            for (auto i = size_t(0); i < count; i++)
+            {
+                __m128 corner[3], edge1[3], edge2[3];
+                for (auto c = 0; c < 3; c++)
+                {
+                    corner[c] = _mm_set1_ps(triangles[c][i]);
+                    edge1[c] = _mm_set1_ps(triangles[3 + c][i]);
+                    edge2[c] = _mm_set1_ps(triangles[6 + c][i]);
+                }
+
+                __m128 distance, u, v;
+                const auto intersects = IntersectSSE2(position, direction, corner, edge1, edge2, distance, u, v);
+                const auto closer = _mm_and_ps(intersects, _mm_cmplt_ps(distance, bestDistance));
+
+                // Coherent rays mostly miss a triangle together
+                if (_mm_movemask_ps(closer) == 0)
+                    continue;
+
+                bestDistance = Select(closer, distance, bestDistance);
+                bestU = Select(closer, u, bestU);
+                bestV = Select(closer, v, bestV);
+                bestTriangle = Select(closer, _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(i))), bestTriangle);
+            }
+
+            _mm_storeu_ps(packet.distance + half, bestDistance);
+            _mm_storeu_ps(packet.u + half, bestU);
+            _mm_storeu_ps(packet.v + half, bestV);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(packet.triangle + half), _mm_castps_si128(bestTriangle));
+        }
+    }
+
+    // The SIMD kernels build the classification from the comparison masks
+    static_assert(sizeof(PlaneIntersection) == sizeof(int32_t), "PlaneIntersection has to be stored as 32-bit integers");
+    static_assert(static_cast<int>(PlaneIntersection::Back) == static_cast<int>(PlaneIntersection::Intersecting) + 1
+        && static_cast<int>(PlaneIntersection::Front) == static_cast<int>(PlaneIntersection::Intersecting) + 2, "Unexpected PlaneIntersection values");
+
+    /// <summary>
+    ///     Loads a plane as a single register and broadcasts its components.
+    /// </summary>
+    SIMD_TARGET_SSE2 static void LoadPlane(const PlaneBase<float>& plane, __m128 (&components)[4])
+    {
+        const auto value = _mm_loadu_ps(&plane.normal.x);
+        components[0] = _mm_shuffle_ps(value, value, _MM_SHUFFLE(0, 0, 0, 0));
+        components[1] = _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1));
+        components[2] = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 2, 2));
+        components[3] = _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    /// <summary>
+    ///     Returns the signed distances of four points, same as PlaneBase::Dot.
+    /// </summary>
+    SIMD_TARGET_SSE2 static __m128 GetPlaneDistances(const __m128 (&plane)[4], const Vector3Base<float>* points)
+    {
+        // Deinterleave as in TransformPointsSSE2
+        const auto input = &points[0].x;
+        const auto m03 = _mm_loadu_ps(input + 0);
+        const auto m14 = _mm_loadu_ps(input + 4);
+        const auto m25 = _mm_loadu_ps(input + 8);
+
+        const auto xy = _mm_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+        const auto yz = _mm_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+        const auto x = _mm_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+        const auto y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        const auto z = _mm_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+
+        return _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], x), _mm_mul_ps(plane[1], y)), _mm_mul_ps(plane[2], z)), plane[3]);
+    }
+
+    /// <summary>
+    ///     Returns the PlaneIntersection values of four signed distances against radii, same as PlaneBase::Classify.
+    /// </summary>
+    SIMD_TARGET_SSE2 static __m128i ClassifyDistances(const __m128 distance, const __m128 radius)
+    {
+        const auto front = _mm_castps_si128(_mm_cmpgt_ps(distance, radius));
+        const auto back = _mm_castps_si128(_mm_cmplt_ps(distance, _mm_xor_ps(radius, _mm_set1_ps(-0.0f))));
+
+        // The masks are -1, so Intersecting minus one for Back or minus two for Front
+        const auto intersecting = _mm_set1_epi32(static_cast<int>(PlaneIntersection::Intersecting));
+        return _mm_sub_epi32(_mm_sub_epi32(intersecting, back), _mm_add_epi32(front, front));
+    }
+
+    SIMD_TARGET_SSE2 static void SignedDistancesSSE2(const PlaneBase<float>& plane, const Vector3Base<float>* points, float* distances, const size_t count)
+    {
+        __m128 components[4];
+        LoadPlane(plane, components);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(distances + i, GetPlaneDistances(components, points + i));
+
+        SignedDistancesScalar(plane, points + i, distances + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void ClassifyPointsSSE2(const PlaneBase<float>& plane, const Vector3Base<float>* points, PlaneIntersection* results, const size_t count)
+    {
+        __m128 components[4];
+        LoadPlane(plane, components);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(results + i), ClassifyDistances(GetPlaneDistances(components, points + i), _mm_setzero_ps()));
+
+        ClassifyPointsScalar(plane, points + i, results + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void ClassifySpheresSSE2(const PlaneBase<float>& plane, const BoundingSphereBase<float>* spheres, PlaneIntersection* results, const size_t count)
+    {
+        __m128 components[4];
+        LoadPlane(plane, components);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            auto x = _mm_loadu_ps(&spheres[i + 0].center.x);
+            auto y = _mm_loadu_ps(&spheres[i + 1].center.x);
+            auto z = _mm_loadu_ps(&spheres[i + 2].center.x);
+            auto radius = _mm_loadu_ps(&spheres[i + 3].center.x);
+            Transpose(x, y, z, radius);
+
+            const auto distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(components[0], x), _mm_mul_ps(components[1], y)), _mm_mul_ps(components[2], z)), components[3]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(results + i), ClassifyDistances(distance, radius));
+        }
+
+        ClassifySpheresScalar(plane, spheres + i, results + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void ClassifyBoxesSSE2(const PlaneBase<float>& plane, const BoundingBoxBase<float>* boxes, PlaneIntersection* results, const size_t count)
+    {
+        __m128 components[4];
+        LoadPlane(plane, components);
+
+        const auto half = _mm_set1_ps(0.5f);
+        const auto signMask = _mm_set1_ps(-0.0f);
+        const auto absoluteX = _mm_andnot_ps(signMask, components[0]);
+        const auto absoluteY = _mm_andnot_ps(signMask, components[1]);
+        const auto absoluteZ = _mm_andnot_ps(signMask, components[2]);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            // Loaded as in CullBoxesSSE2
+            const auto box = &boxes[i].center.x;
+            auto cx = _mm_loadu_ps(box + 0), cy = _mm_loadu_ps(box + 6), cz = _mm_loadu_ps(box + 12), sx = _mm_loadu_ps(box + 18);
+            auto cz2 = _mm_loadu_ps(box + 2), sx2 = _mm_loadu_ps(box + 8), sy = _mm_loadu_ps(box + 14), sz = _mm_loadu_ps(box + 20);
+            Transpose(cx, cy, cz, sx);
+            Transpose(cz2, sx2, sy, sz);
+
+            const auto distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(components[0], cx), _mm_mul_ps(components[1], cy)), _mm_mul_ps(components[2], cz)), components[3]);
+            const auto radius = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(absoluteX, _mm_mul_ps(sx, half)),
+                _mm_mul_ps(absoluteY, _mm_mul_ps(sy, half))),
+                _mm_mul_ps(absoluteZ, _mm_mul_ps(sz, half)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(results + i), ClassifyDistances(distance, radius));
+        }
+
+        ClassifyBoxesScalar(plane, boxes + i, results + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void StoreVector3(Vector3Base<float>& destination, const __m128 value)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(&destination.x), value);
+        _mm_store_ss(&destination.z, _mm_movehl_ps(value, value));
+    }
+
+    SIMD_TARGET_SSE2 static void SkinVerticesSSE2(const Vector3Base<float>* positions, const Vector3Base<float>* normals, const uint32_t* boneIndices, const float* boneWeights,
+        const Matrix4x4Base<float>* palette, Vector3Base<float>* outPositions, Vector3Base<float>* outNormals, const size_t count)
+    {
+        const auto skinNormals = normals != nullptr && outNormals != nullptr;
+        const auto epsilon = _mm_set1_ps(FLT_EPSILON);
+
+        // One vertex per iteration, the blended rows are whole matrix rows and the fourth column is ignored
+        for (auto i = size_t(0); i < count; i++)
+        {
+            auto r0 = _mm_setzero_ps(), r1 = _mm_setzero_ps(), r2 = _mm_setzero_ps(), r3 = _mm_setzero_ps();
+            for (auto k = size_t(0); k < 4; k++)
+            {
+                const auto weight = _mm_set1_ps(boneWeights[i * 4 + k]);
+                const auto bone = &palette[boneIndices[i * 4 + k]].m11;
+
+                r0 = _mm_add_ps(r0, _mm_mul_ps(_mm_loadu_ps(bone + 0), weight));
+                r1 = _mm_add_ps(r1, _mm_mul_ps(_mm_loadu_ps(bone + 4), weight));
+                r2 = _mm_add_ps(r2, _mm_mul_ps(_mm_loadu_ps(bone + 8), weight));
+                r3 = _mm_add_ps(r3, _mm_mul_ps(_mm_loadu_ps(bone + 12), weight));
+            }
+
+            const auto& position = positions[i];
+            const auto transformed = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(position.x), r0),
+                _mm_mul_ps(_mm_set1_ps(position.y), r1)),
+                _mm_mul_ps(_mm_set1_ps(position.z), r2)), r3);
+            StoreVector3(outPositions[i], transformed);
+
+            if (!skinNormals)
+                continue;
+
+            const auto& normal = normals[i];
+            const auto rotated = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(normal.x), r0),
+                _mm_mul_ps(_mm_set1_ps(normal.y), r1)),
+                _mm_mul_ps(_mm_set1_ps(normal.z), r2));
+
+            // Normalized as Vector3Base::Normalize, which leaves near zero vectors unchanged
+            const auto squared = _mm_mul_ps(rotated, rotated);
+            const auto lengthSquared = _mm_add_ps(_mm_add_ps(
+                _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(0, 0, 0, 0)),
+                _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1))),
+                _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 2, 2, 2)));
+            const auto scale = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared));
+            const auto normalized = Select(_mm_cmplt_ps(lengthSquared, epsilon), rotated, _mm_mul_ps(rotated, scale));
+            StoreVector3(outNormals[i], normalized);
+        }
+    }
+
+    SIMD_TARGET_SSE2 static __m128i PackRGBA8x4(const ColorBase<float>* colors)
+    {
+        const auto zero = _mm_setzero_ps();
+        const auto one = _mm_set1_ps(1.0f);
+        const auto scale = _mm_set1_ps(255.0f);
+        const auto bias = _mm_set1_ps(0.5f);
+
+        __m128i values[4];
+        for (auto c = 0; c < 4; c++)
+        {
+            const auto color = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(colors[c].components), zero), one);
+            values[c] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(color, scale), bias));
+        }
+
+        return _mm_packus_epi16(_mm_packs_epi32(values[0], values[1]), _mm_packs_epi32(values[2], values[3]));
+    }
+
+    SIMD_TARGET_SSE2 static void ColorsToRGBA8SSE2(const ColorBase<float>* colors, uint32_t* packed, const size_t count)
+    {
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i), PackRGBA8x4(colors + i));
+
+        ColorsToRGBA8Scalar(colors + i, packed + i, count - i);
+    }
+
+    SIMD_TARGET_SSE2 static void ColorsFromRGBA8SSE2(const uint32_t* packed, ColorBase<float>* colors, const size_t count)
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto scale = _mm_set1_ps(1.0f / 255.0f);
+
+        auto i = size_t(0);
+        for (; i + 4 <= count; i += 4)
+        {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packed + i));
+            const auto low = _mm_unpacklo_epi8(bytes, zero);
+            const auto high = _mm_unpackhi_epi8(bytes, zero);
+
+            _mm_storeu_ps(colors[i + 0].components, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+            _mm_storeu_ps(colors[i + 1].components, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+            _mm_storeu_ps(colors[i + 2].components, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+            _mm_storeu_ps(colors[i + 3].components, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+        }
+
+        ColorsFromRGBA8Scalar(packed + i, colors + i, count - i);
+    }
+
+private:
+    /* AVX2 kernels, 8 elements per iteration. Element k of the lower and k + 4 of the upper 128-bit lane
+       are loaded into one register, so the SSE2 in-lane shuffles work unchanged for both halves. */
+    SIMD_TARGET_AVX2 static __m256 Load2(const float* low, const float* high)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+    }
+
+    SIMD_TARGET_AVX2 static void Store2(float* low, float* high, const __m256 value)
+    {
+        _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+        _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+    }
+
+    SIMD_TARGET_AVX2 static void Transpose(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+    {
+        const auto t0 = _mm256_unpacklo_ps(r0, r1);
+        const auto t1 = _mm256_unpacklo_ps(r2, r3);
+        const auto t2 = _mm256_unpackhi_ps(r0, r1);
+        const auto t3 = _mm256_unpackhi_ps(r2, r3);
+
+        r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    struct CompressTable
+    {
+        // For every 8-bit lane mask, the indices of the set lanes packed to the front and their count
+        uint8_t indices[256][8];
+        uint8_t counts[256];
+
+        CompressTable()
+        {
+            for (auto mask = 0; mask < 256; mask++)
+            {
+                auto count = 0;
+                for (auto lane = 0; lane < 8; lane++)
+                {
+                    indices[mask][lane] = 0;
+                    if (mask & (1 << lane))
+                        indices[mask][count++] = static_cast<uint8_t>(lane);
+                }
+
+                counts[mask] = static_cast<uint8_t>(count);
+            }
+        }
+    };
+
+    static const CompressTable& GetCompressTable()
+    {
+        static const CompressTable table;
+        return table;
+    }
+
+    SIMD_TARGET_AVX2 static size_t StoreVisible8(const uint32_t mask, const __m256i indices, const CompressTable& compressTable, uint32_t* visibleIndices, const size_t visibleCount)
+    {
+        // Writes all 8 lanes, the caller guarantees there is room for them (visibleCount <= first lane index)
+        const auto permutation = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(compressTable.indices[mask])));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(visibleIndices + visibleCount), _mm256_permutevar8x32_epi32(indices, permutation));
+
+        return visibleCount + compressTable.counts[mask];
+    }
+
+    SIMD_TARGET_AVX2 static void MultiplyMatricesAVX2(const Matrix4x4Base<float>* a, const Matrix4x4Base<float>* b, Matrix4x4Base<float>* result, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto lhs = &a[i].m11;
+            const auto rhs = &b[i].m11;
+
+            // Rows of b duplicated in both lanes, two rows of a per register
+            const auto b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 0));
+            const auto b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 4));
+            const auto b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 8));
+            const auto b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 12));
+
+            const auto a01 = _mm256_loadu_ps(lhs + 0);
+            const auto a23 = _mm256_loadu_ps(lhs + 8);
+
+            auto r01 = _mm256_mul_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+            auto r23 = _mm256_mul_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+            r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(1, 1, 1, 1)), b1, r01);
+            r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(1, 1, 1, 1)), b1, r23);
+            r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(2, 2, 2, 2)), b2, r01);
+            r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(2, 2, 2, 2)), b2, r23);
+            r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(3, 3, 3, 3)), b3, r01);
+            r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(3, 3, 3, 3)), b3, r23);
+
+            const auto output = &result[i].m11;
+            _mm256_storeu_ps(output + 0, r01);
+            _mm256_storeu_ps(output + 8, r23);
+        }
+    }
+
+    SIMD_TARGET_AVX2 static void TransformPointsAVX2(const Vector3Base<float>* source, const Matrix4x4Base<float>& matrix, Vector3Base<float>* destination, const size_t count)
+    {
+        const auto m11 = _mm256_set1_ps(matrix.m11), m12 = _mm256_set1_ps(matrix.m12), m13 = _mm256_set1_ps(matrix.m13);
+        const auto m21 = _mm256_set1_ps(matrix.m21), m22 = _mm256_set1_ps(matrix.m22), m23 = _mm256_set1_ps(matrix.m23);
+        const auto m31 = _mm256_set1_ps(matrix.m31), m32 = _mm256_set1_ps(matrix.m32), m33 = _mm256_set1_ps(matrix.m33);
+        const auto m41 = _mm256_set1_ps(matrix.m41), m42 = _mm256_set1_ps(matrix.m42), m43 = _mm256_set1_ps(matrix.m43);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            // Points 0-3 go to the lower lane and 4-7 to the upper lane, see TransformPointsSSE2
+            const auto input = &source[i].x;
+            const auto m03 = Load2(input + 0, input + 12);
+            const auto m14 = Load2(input + 4, input + 16);
+            const auto m25 = Load2(input + 8, input + 20);
+
+            const auto xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+            const auto yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+            const auto x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+            const auto y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            const auto z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+
+            const auto rx = _mm256_fmadd_ps(z, m31, _mm256_fmadd_ps(y, m21, _mm256_fmadd_ps(x, m11, m41)));
+            const auto ry = _mm256_fmadd_ps(z, m32, _mm256_fmadd_ps(y, m22, _mm256_fmadd_ps(x, m12, m42)));
+            const auto rz = _mm256_fmadd_ps(z, m33, _mm256_fmadd_ps(y, m23, _mm256_fmadd_ps(x, m13, m43)));
+
+            const auto rxy = _mm256_shuffle_ps(rx, ry, _MM_SHUFFLE(2, 0, 2, 0));
+            const auto ryz = _mm256_shuffle_ps(ry, rz, _MM_SHUFFLE(3, 1, 3, 1));
+            const auto rzx = _mm256_shuffle_ps(rz, rx, _MM_SHUFFLE(3, 1, 2, 0));
+
+            const auto output = &destination[i].x;
+            Store2(output + 0, output + 12, _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0)));
+            Store2(output + 4, output + 16, _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0)));
+            Store2(output + 8, output + 20, _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+
+        TransformPointsSSE2(source + i, matrix, destination + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void MultiplyQuaternionsAVX2(const Quaternion* a, const Quaternion* b, Quaternion* result, const size_t count)
+    {
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            auto lx = Load2(&a[i + 0].x, &a[i + 4].x);
+            auto ly = Load2(&a[i + 1].x, &a[i + 5].x);
+            auto lz = Load2(&a[i + 2].x, &a[i + 6].x);
+            auto lw = Load2(&a[i + 3].x, &a[i + 7].x);
+            Transpose(lx, ly, lz, lw);
+
+            auto rx = Load2(&b[i + 0].x, &b[i + 4].x);
+            auto ry = Load2(&b[i + 1].x, &b[i + 5].x);
+            auto rz = Load2(&b[i + 2].x, &b[i + 6].x);
+            auto rw = Load2(&b[i + 3].x, &b[i + 7].x);
+            Transpose(rx, ry, rz, rw);
+
+            const auto cx = _mm256_fmsub_ps(ly, rz, _mm256_mul_ps(lz, ry));
+            const auto cy = _mm256_fmsub_ps(lz, rx, _mm256_mul_ps(lx, rz));
+            const auto cz = _mm256_fmsub_ps(lx, ry, _mm256_mul_ps(ly, rx));
+            const auto dot = _mm256_fmadd_ps(lz, rz, _mm256_fmadd_ps(ly, ry, _mm256_mul_ps(lx, rx)));
+
+            auto x = _mm256_add_ps(_mm256_fmadd_ps(lx, rw, _mm256_mul_ps(rx, lw)), cx);
+            auto y = _mm256_add_ps(_mm256_fmadd_ps(ly, rw, _mm256_mul_ps(ry, lw)), cy);
+            auto z = _mm256_add_ps(_mm256_fmadd_ps(lz, rw, _mm256_mul_ps(rz, lw)), cz);
+            auto w = _mm256_fmsub_ps(lw, rw, dot);
+            Transpose(x, y, z, w);
+
+            Store2(&result[i + 0].x, &result[i + 4].x, x);
+            Store2(&result[i + 1].x, &result[i + 5].x, y);
+            Store2(&result[i + 2].x, &result[i + 6].x, z);
+            Store2(&result[i + 3].x, &result[i + 7].x, w);
+        }
+
+        MultiplyQuaternionsSSE2(a + i, b + i, result + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static size_t CullBoxesAVX2(const PlaneBase<float>* planes, const size_t planeCount, const BoundingBoxBase<float>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex)
+    {
+        const auto half = _mm256_set1_ps(0.5f);
+        const auto signMask = _mm256_set1_ps(-0.0f);
+        const auto laneIndices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const auto& compressTable = GetCompressTable();
+
+        auto visibleCount = size_t(0);
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto box = &boxes[i].center.x;
+            const auto high = box + 24;
+
+            auto cx = Load2(box + 0, high + 0), cy = Load2(box + 6, high + 6), cz = Load2(box + 12, high + 12), sx = Load2(box + 18, high + 18);
+            auto cz2 = Load2(box + 2, high + 2), sx2 = Load2(box + 8, high + 8), sy = Load2(box + 14, high + 14), sz = Load2(box + 20, high + 20);
+            Transpose(cx, cy, cz, sx);
+            Transpose(cz2, sx2, sy, sz);
+
+            const auto ex = _mm256_mul_ps(sx, half);
+            const auto ey = _mm256_mul_ps(sy, half);
+            const auto ez = _mm256_mul_ps(sz, half);
+
+            auto visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (auto p = size_t(0); p < planeCount; p++)
+            {
+                const auto& plane = planes[p];
+                const auto nx = _mm256_set1_ps(plane.normal.x);
+                const auto ny = _mm256_set1_ps(plane.normal.y);
+                const auto nz = _mm256_set1_ps(plane.normal.z);
+
+                const auto distance = _mm256_fmadd_ps(nz, cz, _mm256_fmadd_ps(ny, cy, _mm256_fmadd_ps(nx, cx, _mm256_set1_ps(plane.distance))));
+                const auto radius = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, nz), ez,
+                    _mm256_fmadd_ps(_mm256_andnot_ps(signMask, ny), ey, _mm256_mul_ps(_mm256_andnot_ps(signMask, nx), ex)));
+
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, _mm256_xor_ps(radius, signMask), _CMP_NLT_UQ));
+            }
+
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_ps(visible));
+            const auto indices = _mm256_add_epi32(laneIndices, _mm256_set1_epi32(static_cast<int>(firstIndex + static_cast<uint32_t>(i))));
+            visibleCount = StoreVisible8(mask, indices, compressTable, visibleIndices, visibleCount);
+        }
+
+        return visibleCount + CullBoxesSSE2(planes, planeCount, boxes + i, count - i, visibleIndices + visibleCount, firstIndex + static_cast<uint32_t>(i));
+    }
+
+    SIMD_TARGET_AVX2 static size_t CullSpheresAVX2(const PlaneBase<float>* planes, const size_t planeCount, const BoundingSphereBase<float>* spheres, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex)
+    {
+        const auto signMask = _mm256_set1_ps(-0.0f);
+        const auto laneIndices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const auto& compressTable = GetCompressTable();
+
+        auto visibleCount = size_t(0);
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            auto x = Load2(&spheres[i + 0].center.x, &spheres[i + 4].center.x);
+            auto y = Load2(&spheres[i + 1].center.x, &spheres[i + 5].center.x);
+            auto z = Load2(&spheres[i + 2].center.x, &spheres[i + 6].center.x);
+            auto radius = Load2(&spheres[i + 3].center.x, &spheres[i + 7].center.x);
+            Transpose(x, y, z, radius);
+
+            const auto negativeRadius = _mm256_xor_ps(radius, signMask);
+
+            auto visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (auto p = size_t(0); p < planeCount; p++)
+            {
+                const auto& plane = planes[p];
+                const auto distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.z), z,
+                    _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.y), y,
+                    _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.x), x, _mm256_set1_ps(plane.distance))));
+
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+            }
+
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_ps(visible));
+            const auto indices = _mm256_add_epi32(laneIndices, _mm256_set1_epi32(static_cast<int>(firstIndex + static_cast<uint32_t>(i))));
+            visibleCount = StoreVisible8(mask, indices, compressTable, visibleIndices, visibleCount);
+        }
+
+        return visibleCount + CullSpheresSSE2(planes, planeCount, spheres + i, count - i, visibleIndices + visibleCount, firstIndex + static_cast<uint32_t>(i));
+    }
+
+    SIMD_TARGET_AVX2 static void ColorsToRGBA8AVX2(const ColorBase<float>* colors, uint32_t* packed, const size_t count)
+    {
+        const auto zero = _mm256_setzero_ps();
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto scale = _mm256_set1_ps(255.0f);
+        const auto bias = _mm256_set1_ps(0.5f);
+        const auto order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i values[4];
+            for (auto c = 0; c < 4; c++)
+            {
+                const auto color = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(colors[i + c * 2].components), zero), one);
+                values[c] = _mm256_cvttps_epi32(_mm256_fmadd_ps(color, scale, bias));
+            }
+
+            // The in-lane packs leave the colors in 0 2 4 6 | 1 3 5 7 order
+            const auto bytes = _mm256_packus_epi16(_mm256_packs_epi32(values[0], values[1]), _mm256_packs_epi32(values[2], values[3]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(packed + i), _mm256_permutevar8x32_epi32(bytes, order));
+        }
+
+        ColorsToRGBA8SSE2(colors + i, packed + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void ColorsFromRGBA8AVX2(const uint32_t* packed, ColorBase<float>* colors, const size_t count)
+    {
+        const auto scale = _mm256_set1_ps(1.0f / 255.0f);
+
+        auto i = size_t(0);
+        for (; i + 2 <= count; i += 2)
+        {
+            const auto bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(packed + i));
+            _mm256_storeu_ps(colors[i].components, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), scale));
+        }
+
+        ColorsFromRGBA8Scalar(packed + i, colors + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static BoundingBoxBase<float> FromPointsAVX2(const Vector3Base<float>* points, const size_t count)
+    {
+        if (count < 8)
+            return FromPointsSSE2(points, count);
+
+        const auto values = &points[0].x;
+        __m256 minimum[3];
+        __m256 maximum[3];
+        for (auto r = 0; r < 3; r++)
+            minimum[r] = maximum[r] = _mm256_loadu_ps(values + r * 8);
+
+        auto i = size_t(8);
+        for (; i + 8 <= count; i += 8)
+        {
+            for (auto r = 0; r < 3; r++)
+            {
+                const auto value = _mm256_loadu_ps(values + i * 3 + r * 8);
+                minimum[r] = _mm256_min_ps(minimum[r], value);
+                maximum[r] = _mm256_max_ps(maximum[r], value);
+            }
+        }
+
+        float minimumValues[24];
+        float maximumValues[24];
+        for (auto r = 0; r < 3; r++)
+        {
+            _mm256_storeu_ps(minimumValues + r * 8, minimum[r]);
+            _mm256_storeu_ps(maximumValues + r * 8, maximum[r]);
+        }
+
+        return FoldBounds(minimumValues, maximumValues, 24, points + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void SinCos(const __m256 angle, __m256& sin, __m256& cos)
+    {
+        // Same reduction and polynomials as the SSE2 version
+        const auto quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(angle, _mm256_set1_ps(0.636619772f)));
+        const auto multiple = _mm256_cvtepi32_ps(quadrant);
+
+        auto r = _mm256_fnmadd_ps(multiple, _mm256_set1_ps(1.5703125f), angle);
+        r = _mm256_fnmadd_ps(multiple, _mm256_set1_ps(4.837512969970703125e-4f), r);
+        r = _mm256_fnmadd_ps(multiple, _mm256_set1_ps(7.54978995489188216e-8f), r);
+        const auto r2 = _mm256_mul_ps(r, r);
+
+        auto sinR = _mm256_fmadd_ps(_mm256_set1_ps(-1.9515295891e-4f), r2, _mm256_set1_ps(8.3321608736e-3f));
+        sinR = _mm256_fmadd_ps(sinR, r2, _mm256_set1_ps(-1.6666654611e-1f));
+        sinR = _mm256_fmadd_ps(_mm256_mul_ps(sinR, r2), r, r);
+
+        auto cosR = _mm256_fmadd_ps(_mm256_set1_ps(2.443315711809948e-5f), r2, _mm256_set1_ps(-1.388731625493765e-3f));
+        cosR = _mm256_fmadd_ps(cosR, r2, _mm256_set1_ps(4.166664568298827e-2f));
+        cosR = _mm256_fmadd_ps(_mm256_mul_ps(cosR, r2), r2, _mm256_fnmadd_ps(r2, _mm256_set1_ps(0.5f), _mm256_set1_ps(1.0f)));
+
+        const auto one = _mm256_set1_epi32(1);
+        const auto swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+        const auto sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+        const auto cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), _mm256_set1_epi32(2)), 30));
+
+        sin = _mm256_xor_ps(_mm256_blendv_ps(sinR, cosR, swap), sinSign);
+        cos = _mm256_xor_ps(_mm256_blendv_ps(cosR, sinR, swap), cosSign);
+    }
+
+    SIMD_TARGET_AVX2 static __m256 Atan2(const __m256 y, const __m256 x)
+    {
+        // Same octant reduction and polynomial as the SSE2 version
+        const auto signMask = _mm256_set1_ps(-0.0f);
+        const auto absoluteX = _mm256_andnot_ps(signMask, x);
+        const auto absoluteY = _mm256_andnot_ps(signMask, y);
+
+        const auto swap = _mm256_cmp_ps(absoluteY, absoluteX, _CMP_GT_OQ);
+        const auto numerator = _mm256_blendv_ps(absoluteY, absoluteX, swap);
+        const auto denominator = _mm256_blendv_ps(absoluteX, absoluteY, swap);
+        const auto ratio = _mm256_and_ps(_mm256_div_ps(numerator, denominator), _mm256_cmp_ps(denominator, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto reduce = _mm256_cmp_ps(ratio, _mm256_set1_ps(0.414213562f), _CMP_GT_OQ);
+        const auto t = _mm256_blendv_ps(ratio, _mm256_div_ps(_mm256_sub_ps(ratio, one), _mm256_add_ps(ratio, one)), reduce);
+        const auto t2 = _mm256_mul_ps(t, t);
+
+        auto result = _mm256_fmadd_ps(_mm256_set1_ps(8.05374449538e-2f), t2, _mm256_set1_ps(-1.38776856032e-1f));
+        result = _mm256_fmadd_ps(result, t2, _mm256_set1_ps(1.99777106478e-1f));
+        result = _mm256_fmadd_ps(result, t2, _mm256_set1_ps(-3.33329491539e-1f));
+        result = _mm256_fmadd_ps(_mm256_mul_ps(result, t2), t, t);
+        result = _mm256_add_ps(result, _mm256_and_ps(reduce, _mm256_set1_ps(0.785398163f)));
+
+        result = _mm256_blendv_ps(result, _mm256_sub_ps(_mm256_set1_ps(1.570796327f), result), swap);
+        result = _mm256_blendv_ps(result, _mm256_sub_ps(_mm256_set1_ps(3.141592654f), result), _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ));
+        return _mm256_or_ps(result, _mm256_and_ps(y, signMask));
+    }
+
+    SIMD_TARGET_AVX2 static void EulerToQuaternionsAVX2(const float* yaw, const float* pitch, const float* roll, float* x, float* y, float* z, float* w, const size_t count)
+    {
+        const auto half = _mm256_set1_ps(0.5f);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 sinYaw, cosYaw, sinPitch, cosPitch, sinRoll, cosRoll;
+            SinCos(_mm256_mul_ps(_mm256_loadu_ps(yaw + i), half), sinYaw, cosYaw);
+            SinCos(_mm256_mul_ps(_mm256_loadu_ps(pitch + i), half), sinPitch, cosPitch);
+            SinCos(_mm256_mul_ps(_mm256_loadu_ps(roll + i), half), sinRoll, cosRoll);
+
+            const auto cosYawCosPitch = _mm256_mul_ps(cosYaw, cosPitch);
+            const auto sinYawSinPitch = _mm256_mul_ps(sinYaw, sinPitch);
+            const auto cosYawSinPitch = _mm256_mul_ps(cosYaw, sinPitch);
+            const auto sinYawCosPitch = _mm256_mul_ps(sinYaw, cosPitch);
+
+            _mm256_storeu_ps(x + i, _mm256_fmadd_ps(cosYawSinPitch, cosRoll, _mm256_mul_ps(sinYawCosPitch, sinRoll)));
+            _mm256_storeu_ps(y + i, _mm256_fmsub_ps(sinYawCosPitch, cosRoll, _mm256_mul_ps(cosYawSinPitch, sinRoll)));
+            _mm256_storeu_ps(z + i, _mm256_fmsub_ps(cosYawCosPitch, sinRoll, _mm256_mul_ps(sinYawSinPitch, cosRoll)));
+            _mm256_storeu_ps(w + i, _mm256_fmadd_ps(cosYawCosPitch, cosRoll, _mm256_mul_ps(sinYawSinPitch, sinRoll)));
+        }
+
+        EulerToQuaternionsSSE2(yaw + i, pitch + i, roll + i, x + i, y + i, z + i, w + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void QuaternionsToEulerAVX2(const float* x, const float* y, const float* z, const float* w, float* yaw, float* pitch, float* roll, const size_t count)
+    {
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto two = _mm256_set1_ps(2.0f);
+        const auto signMask = _mm256_set1_ps(-0.0f);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto qx = _mm256_loadu_ps(x + i);
+            const auto qy = _mm256_loadu_ps(y + i);
+            const auto qz = _mm256_loadu_ps(z + i);
+            const auto qw = _mm256_loadu_ps(w + i);
+
+            const auto xx = _mm256_mul_ps(qx, qx);
+            const auto yy = _mm256_mul_ps(qy, qy);
+            const auto zz = _mm256_mul_ps(qz, qz);
+
+            auto sinPitch = _mm256_mul_ps(two, _mm256_fmsub_ps(qx, qw, _mm256_mul_ps(qy, qz)));
+            sinPitch = _mm256_max_ps(_mm256_min_ps(sinPitch, one), _mm256_set1_ps(-1.0f));
+            const auto cosPitch = _mm256_sqrt_ps(_mm256_max_ps(_mm256_fnmadd_ps(sinPitch, sinPitch, one), _mm256_setzero_ps()));
+
+            const auto zx = _mm256_mul_ps(qz, qx);
+            const auto yw = _mm256_mul_ps(qy, qw);
+            const auto yawDefault = Atan2(_mm256_mul_ps(two, _mm256_add_ps(zx, yw)), _mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one));
+            const auto yawLocked = Atan2(_mm256_mul_ps(two, _mm256_sub_ps(yw, zx)), _mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one));
+            const auto rollDefault = Atan2(_mm256_mul_ps(two, _mm256_fmadd_ps(qx, qy, _mm256_mul_ps(qz, qw))), _mm256_fnmadd_ps(two, _mm256_add_ps(zz, xx), one));
+
+            const auto locked = _mm256_cmp_ps(_mm256_andnot_ps(signMask, sinPitch), _mm256_set1_ps(GimbalLockSine), _CMP_GE_OQ);
+
+            _mm256_storeu_ps(yaw + i, _mm256_blendv_ps(yawDefault, yawLocked, locked));
+            _mm256_storeu_ps(pitch + i, Atan2(sinPitch, cosPitch));
+            _mm256_storeu_ps(roll + i, _mm256_andnot_ps(locked, rollDefault));
+        }
+
+        QuaternionsToEulerSSE2(x + i, y + i, z + i, w + i, yaw + i, pitch + i, roll + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void QuaternionsToMatricesAVX2(const float* x, const float* y, const float* z, const float* w, Matrix4x4Base<float>* matrices, const size_t count)
+    {
+        const auto one = _mm256_set1_ps(1.0f);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto qx = _mm256_loadu_ps(x + i);
+            const auto qy = _mm256_loadu_ps(y + i);
+            const auto qz = _mm256_loadu_ps(z + i);
+            const auto qw = _mm256_loadu_ps(w + i);
+
+            const auto x2 = _mm256_add_ps(qx, qx);
+            const auto y2 = _mm256_add_ps(qy, qy);
+            const auto z2 = _mm256_add_ps(qz, qz);
+            const auto wx = _mm256_mul_ps(qw, x2);
+            const auto wy = _mm256_mul_ps(qw, y2);
+            const auto wz = _mm256_mul_ps(qw, z2);
+            const auto xx = _mm256_mul_ps(qx, x2);
+            const auto xy = _mm256_mul_ps(qx, y2);
+            const auto xz = _mm256_mul_ps(qx, z2);
+            const auto yy = _mm256_mul_ps(qy, y2);
+            const auto yz = _mm256_mul_ps(qy, z2);
+            const auto zz = _mm256_mul_ps(qz, z2);
+
+            __m256 rows[3][4] = {
+                { _mm256_sub_ps(_mm256_sub_ps(one, yy), zz), _mm256_add_ps(xy, wz), _mm256_sub_ps(xz, wy), _mm256_setzero_ps() },
+                { _mm256_sub_ps(xy, wz), _mm256_sub_ps(_mm256_sub_ps(one, xx), zz), _mm256_add_ps(yz, wx), _mm256_setzero_ps() },
+                { _mm256_add_ps(xz, wy), _mm256_sub_ps(yz, wx), _mm256_sub_ps(_mm256_sub_ps(one, xx), yy), _mm256_setzero_ps() }
+            };
+
+            // The in-lane transpose leaves matrix k in the lower and k + 4 in the upper half of register k
+            for (auto r = 0; r < 3; r++)
+            {
+                Transpose(rows[r][0], rows[r][1], rows[r][2], rows[r][3]);
+                for (auto k = 0; k < 4; k++)
+                    Store2(&matrices[i + k].m11 + r * 4, &matrices[i + k + 4].m11 + r * 4, rows[r][k]);
+            }
+
+            for (auto k = 0; k < 8; k++)
+                _mm_storeu_ps(&matrices[i + k].m41, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+        }
+
+        QuaternionsToMatricesSSE2(x + i, y + i, z + i, w + i, matrices + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void MatricesToQuaternionsAVX2(const Matrix4x4Base<float>* matrices, float* x, float* y, float* z, float* w, const size_t count)
+    {
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto half = _mm256_set1_ps(0.5f);
+        const auto signMask = _mm256_set1_ps(-0.0f);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 m[3][4];
+            for (auto r = 0; r < 3; r++)
+            {
+                for (auto k = 0; k < 4; k++)
+                    m[r][k] = Load2(&matrices[i + k].m11 + r * 4, &matrices[i + k + 4].m11 + r * 4);
+                Transpose(m[r][0], m[r][1], m[r][2], m[r][3]);
+            }
+
+            // Same case selection as MatricesToQuaternionsSSE2, lane order matches the matrix order after the transpose
+            const auto trace = _mm256_add_ps(_mm256_add_ps(m[0][0], m[1][1]), m[2][2]);
+            const auto caseW = _mm256_cmp_ps(trace, _mm256_setzero_ps(), _CMP_GT_OQ);
+            const auto caseX = _mm256_andnot_ps(caseW, _mm256_and_ps(_mm256_cmp_ps(m[0][0], m[1][1], _CMP_GE_OQ), _mm256_cmp_ps(m[0][0], m[2][2], _CMP_GE_OQ)));
+            const auto caseY = _mm256_andnot_ps(_mm256_or_ps(caseW, caseX), _mm256_cmp_ps(m[1][1], m[2][2], _CMP_GT_OQ));
+            const auto caseZ = _mm256_andnot_ps(_mm256_or_ps(_mm256_or_ps(caseW, caseX), caseY), _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+
+            const auto negativeX = _mm256_and_ps(_mm256_or_ps(caseY, caseZ), signMask);
+            const auto negativeY = _mm256_and_ps(_mm256_or_ps(caseX, caseZ), signMask);
+            const auto negativeZ = _mm256_and_ps(_mm256_or_ps(caseX, caseY), signMask);
+            const auto largestSquared = _mm256_add_ps(_mm256_add_ps(one, _mm256_xor_ps(m[0][0], negativeX)),
+                _mm256_add_ps(_mm256_xor_ps(m[1][1], negativeY), _mm256_xor_ps(m[2][2], negativeZ)));
+
+            const auto root = _mm256_sqrt_ps(largestSquared);
+            const auto scale = _mm256_div_ps(half, root);
+            const auto largest = _mm256_mul_ps(half, root);
+
+            const auto differenceX = _mm256_sub_ps(m[1][2], m[2][1]);
+            const auto differenceY = _mm256_sub_ps(m[2][0], m[0][2]);
+            const auto differenceZ = _mm256_sub_ps(m[0][1], m[1][0]);
+            const auto sumXY = _mm256_add_ps(m[0][1], m[1][0]);
+            const auto sumXZ = _mm256_add_ps(m[0][2], m[2][0]);
+            const auto sumYZ = _mm256_add_ps(m[1][2], m[2][1]);
+
+            const auto qx = _mm256_blendv_ps(_mm256_mul_ps(_mm256_blendv_ps(_mm256_blendv_ps(sumXZ, sumXY, caseY), differenceX, caseW), scale), largest, caseX);
+            const auto qy = _mm256_blendv_ps(_mm256_mul_ps(_mm256_blendv_ps(_mm256_blendv_ps(sumYZ, sumXY, caseX), differenceY, caseW), scale), largest, caseY);
+            const auto qz = _mm256_blendv_ps(_mm256_mul_ps(_mm256_blendv_ps(_mm256_blendv_ps(sumYZ, sumXZ, caseX), differenceZ, caseW), scale), largest, caseZ);
+            const auto qw = _mm256_blendv_ps(_mm256_mul_ps(_mm256_blendv_ps(_mm256_blendv_ps(differenceZ, differenceY, caseY), differenceX, caseX), scale), largest, caseW);
+
+            _mm256_storeu_ps(x + i, qx);
+            _mm256_storeu_ps(y + i, qy);
+            _mm256_storeu_ps(z + i, qz);
+            _mm256_storeu_ps(w + i, qw);
+        }
+
+        MatricesToQuaternionsSSE2(matrices + i, x + i, y + i, z + i, w + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void ComposeTransforms8(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, __m256 (&m)[4][3])
+    {
+        // Same as ComposeTransforms4, transforms k and k + 4 share the register lanes
+        auto qx = Load2(&rotations[0].x, &rotations[4].x);
+        auto qy = Load2(&rotations[1].x, &rotations[5].x);
+        auto qz = Load2(&rotations[2].x, &rotations[6].x);
+        auto qw = Load2(&rotations[3].x, &rotations[7].x);
+        Transpose(qx, qy, qz, qw);
+
+        __m256 vectors[2][3];
+        const float* inputs[2] = { &scales[0].x, &positions[0].x };
+        for (auto v = 0; v < 2; v++)
+        {
+            const auto m03 = Load2(inputs[v] + 0, inputs[v] + 12);
+            const auto m14 = Load2(inputs[v] + 4, inputs[v] + 16);
+            const auto m25 = Load2(inputs[v] + 8, inputs[v] + 20);
+
+            const auto xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+            const auto yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+            vectors[v][0] = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+            vectors[v][1] = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            vectors[v][2] = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+        }
+
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto x2 = _mm256_add_ps(qx, qx);
+        const auto y2 = _mm256_add_ps(qy, qy);
+        const auto z2 = _mm256_add_ps(qz, qz);
+        const auto wx = _mm256_mul_ps(qw, x2);
+        const auto wy = _mm256_mul_ps(qw, y2);
+        const auto wz = _mm256_mul_ps(qw, z2);
+        const auto xx = _mm256_mul_ps(qx, x2);
+        const auto xy = _mm256_mul_ps(qx, y2);
+        const auto xz = _mm256_mul_ps(qx, z2);
+        const auto yy = _mm256_mul_ps(qy, y2);
+        const auto yz = _mm256_mul_ps(qy, z2);
+        const auto zz = _mm256_mul_ps(qz, z2);
+
+        const auto& scale = vectors[0];
+        m[0][0] = _mm256_mul_ps(scale[0], _mm256_sub_ps(one, _mm256_add_ps(yy, zz)));
+        m[0][1] = _mm256_mul_ps(scale[0], _mm256_add_ps(xy, wz));
+        m[0][2] = _mm256_mul_ps(scale[0], _mm256_sub_ps(xz, wy));
+        m[1][0] = _mm256_mul_ps(scale[1], _mm256_sub_ps(xy, wz));
+        m[1][1] = _mm256_mul_ps(scale[1], _mm256_sub_ps(one, _mm256_add_ps(zz, xx)));
+        m[1][2] = _mm256_mul_ps(scale[1], _mm256_add_ps(yz, wx));
+        m[2][0] = _mm256_mul_ps(scale[2], _mm256_add_ps(xz, wy));
+        m[2][1] = _mm256_mul_ps(scale[2], _mm256_sub_ps(yz, wx));
+        m[2][2] = _mm256_mul_ps(scale[2], _mm256_sub_ps(one, _mm256_add_ps(yy, xx)));
+        m[3][0] = vectors[1][0];
+        m[3][1] = vectors[1][1];
+        m[3][2] = vectors[1][2];
+    }
+
+    SIMD_TARGET_AVX2 static void ComposeTransformsAVX2(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, Matrix4x4Base<float>* matrices, const size_t count)
+    {
+        const auto zero = _mm256_setzero_ps();
+        const auto one = _mm256_set1_ps(1.0f);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 m[4][3];
+            ComposeTransforms8(positions + i, rotations + i, scales + i, m);
+
+            for (auto r = 0; r < 4; r++)
+            {
+                __m256 values[4] = { m[r][0], m[r][1], m[r][2], r == 3 ? one : zero };
+                Transpose(values[0], values[1], values[2], values[3]);
+                for (auto k = 0; k < 4; k++)
+                    Store2(&matrices[i + k].m11 + r * 4, &matrices[i + k + 4].m11 + r * 4, values[k]);
+            }
+        }
+
+        ComposeTransformsSSE2(positions + i, rotations + i, scales + i, matrices + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void ComposeTransforms3x4AVX2(const Vector3Base<float>* positions, const Quaternion* rotations, const Vector3Base<float>* scales, float* rows, const size_t count)
+    {
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 m[4][3];
+            ComposeTransforms8(positions + i, rotations + i, scales + i, m);
+
+            for (auto c = 0; c < 3; c++)
+            {
+                __m256 values[4] = { m[0][c], m[1][c], m[2][c], m[3][c] };
+                Transpose(values[0], values[1], values[2], values[3]);
+                for (auto k = 0; k < 4; k++)
+                    Store2(rows + (i + k) * 12 + c * 4, rows + (i + k + 4) * 12 + c * 4, values[k]);
+            }
+        }
+
+        ComposeTransforms3x4SSE2(positions + i, rotations + i, scales + i, rows + i * 12, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void TriangleNormalsAVX2(const Vector3Base<float>* positions, const uint32_t* indices, float* x, float* y, float* z,
+        float* weight0, float* weight1, float* weight2, const size_t count)
+    {
+        const auto components = reinterpret_cast<const float*>(positions);
+        const auto indexOffsets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+        const auto three = _mm256_set1_epi32(3);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            // Gather the corner indices of eight triangles, then the components of the corner positions
+            __m256 p[3][3];
+            for (auto k = 0; k < 3; k++)
+            {
+                const auto cornerIndices = _mm256_i32gather_epi32(reinterpret_cast<const int*>(indices + i * 3 + k), indexOffsets, 4);
+                const auto offsets = _mm256_mullo_epi32(cornerIndices, three);
+
+                for (auto c = 0; c < 3; c++)
+                    p[k][c] = _mm256_i32gather_ps(components + c, offsets, 4);
+            }
+
+            __m256 edge01[3], edge02[3], edge12[3];
+            for (auto c = 0; c < 3; c++)
+            {
+                edge01[c] = _mm256_sub_ps(p[1][c], p[0][c]);
+                edge02[c] = _mm256_sub_ps(p[2][c], p[0][c]);
+                edge12[c] = _mm256_sub_ps(p[2][c], p[1][c]);
+            }
+
+            const auto normalX = _mm256_fmsub_ps(edge01[1], edge02[2], _mm256_mul_ps(edge01[2], edge02[1]));
+            const auto normalY = _mm256_fmsub_ps(edge01[2], edge02[0], _mm256_mul_ps(edge01[0], edge02[2]));
+            const auto normalZ = _mm256_fmsub_ps(edge01[0], edge02[1], _mm256_mul_ps(edge01[1], edge02[0]));
+
+            _mm256_storeu_ps(x + i, normalX);
+            _mm256_storeu_ps(y + i, normalY);
+            _mm256_storeu_ps(z + i, normalZ);
+
+            if (weight0 == nullptr)
+                continue;
+
+            const auto length = _mm256_sqrt_ps(_mm256_fmadd_ps(normalZ, normalZ, _mm256_fmadd_ps(normalY, normalY, _mm256_mul_ps(normalX, normalX))));
+            const auto scale = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), length), _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+            const auto dot0 = _mm256_fmadd_ps(edge01[2], edge02[2], _mm256_fmadd_ps(edge01[1], edge02[1], _mm256_mul_ps(edge01[0], edge02[0])));
+            const auto dot1 = _mm256_fmadd_ps(edge01[2], edge12[2], _mm256_fmadd_ps(edge01[1], edge12[1], _mm256_mul_ps(edge01[0], edge12[0])));
+            const auto dot2 = _mm256_fmadd_ps(edge02[2], edge12[2], _mm256_fmadd_ps(edge02[1], edge12[1], _mm256_mul_ps(edge02[0], edge12[0])));
+
+            _mm256_storeu_ps(weight0 + i, _mm256_mul_ps(Atan2(length, dot0), scale));
+            _mm256_storeu_ps(weight1 + i, _mm256_mul_ps(Atan2(length, _mm256_xor_ps(dot1, _mm256_set1_ps(-0.0f))), scale));
+            _mm256_storeu_ps(weight2 + i, _mm256_mul_ps(Atan2(length, dot2), scale));
+        }
+
+        TriangleNormalsSSE2(positions, indices + i * 3, x + i, y + i, z + i,
+            weight0 != nullptr ? weight0 + i : nullptr, weight1 != nullptr ? weight1 + i : nullptr, weight2 != nullptr ? weight2 + i : nullptr, count - i);
+    }
+
+    /// <summary>
+    ///     Moller-Trumbore for eight ray and triangle pairs, see IntersectSSE2.
+    /// </summary>
+    SIMD_TARGET_AVX2 static __m256 IntersectAVX2(const __m256 (&position)[3], const __m256 (&direction)[3],
+        const __m256 (&corner)[3], const __m256 (&edge1)[3], const __m256 (&edge2)[3], __m256& distance, __m256& u, __m256& v)
+    {
+        const auto zero = _mm256_setzero_ps();
+
+        const auto pX = _mm256_fmsub_ps(direction[1], edge2[2], _mm256_mul_ps(direction[2], edge2[1]));
+        const auto pY = _mm256_fmsub_ps(direction[2], edge2[0], _mm256_mul_ps(direction[0], edge2[2]));
+        const auto pZ = _mm256_fmsub_ps(direction[0], edge2[1], _mm256_mul_ps(direction[1], edge2[0]));
+        const auto determinant = _mm256_fmadd_ps(edge1[2], pZ, _mm256_fmadd_ps(edge1[1], pY, _mm256_mul_ps(edge1[0], pX)));
+        const auto inverse = _mm256_div_ps(_mm256_set1_ps(1.0f), determinant);
+
+        const auto offsetX = _mm256_sub_ps(position[0], corner[0]);
+        const auto offsetY = _mm256_sub_ps(position[1], corner[1]);
+        const auto offsetZ = _mm256_sub_ps(position[2], corner[2]);
+        const auto qX = _mm256_fmsub_ps(offsetY, edge1[2], _mm256_mul_ps(offsetZ, edge1[1]));
+        const auto qY = _mm256_fmsub_ps(offsetZ, edge1[0], _mm256_mul_ps(offsetX, edge1[2]));
+        const auto qZ = _mm256_fmsub_ps(offsetX, edge1[1], _mm256_mul_ps(offsetY, edge1[0]));
+
+        u = _mm256_mul_ps(_mm256_fmadd_ps(offsetZ, pZ, _mm256_fmadd_ps(offsetY, pY, _mm256_mul_ps(offsetX, pX))), inverse);
+        v = _mm256_mul_ps(_mm256_fmadd_ps(direction[2], qZ, _mm256_fmadd_ps(direction[1], qY, _mm256_mul_ps(direction[0], qX))), inverse);
+        distance = _mm256_mul_ps(_mm256_fmadd_ps(edge2[2], qZ, _mm256_fmadd_ps(edge2[1], qY, _mm256_mul_ps(edge2[0], qX))), inverse);
+
+        auto hit = _mm256_and_ps(_mm256_cmp_ps(determinant, zero, _CMP_NEQ_OQ), _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(v, zero, _CMP_GE_OQ)));
+        return _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_add_ps(u, v), _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+    }
+
+    SIMD_TARGET_AVX2 static bool IntersectRayAVX2(const RayBase<float>& ray, const float* const* triangles, const size_t begin, const size_t end, RayHit& hit)
+    {
+        const __m256 position[3] = { _mm256_set1_ps(ray.position.x), _mm256_set1_ps(ray.position.y), _mm256_set1_ps(ray.position.z) };
+        const __m256 direction[3] = { _mm256_set1_ps(ray.direction.x), _mm256_set1_ps(ray.direction.y), _mm256_set1_ps(ray.direction.z) };
+
+        auto bestDistance = _mm256_set1_ps(hit.distance);
+        auto bestU = _mm256_setzero_ps();
+        auto bestV = _mm256_setzero_ps();
+        auto bestTriangle = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        auto indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(begin)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+        auto i = begin;
+        for (; i + 8 <= end; i += 8)
+        {
+            __m256 corner[3], edge1[3], edge2[3];
+            for (auto c = 0; c < 3; c++)
+            {
+                corner[c] = _mm256_loadu_ps(triangles[c] + i);
+                edge1[c] = _mm256_loadu_ps(triangles[3 + c] + i);
+                edge2[c] = _mm256_loadu_ps(triangles[6 + c] + i);
+            }
+
+            __m256 distance, u, v;
+            const auto intersects = IntersectAVX2(position, direction, corner, edge1, edge2, distance, u, v);
+            const auto closer = _mm256_and_ps(intersects, _mm256_cmp_ps(distance, bestDistance, _CMP_LT_OQ));
+
+            bestDistance = _mm256_blendv_ps(bestDistance, distance, closer);
+            bestU = _mm256_blendv_ps(bestU, u, closer);
+            bestV = _mm256_blendv_ps(bestV, v, closer);
+            bestTriangle = _mm256_blendv_ps(bestTriangle, _mm256_castsi256_ps(indices), closer);
+            indices = _mm256_add_epi32(indices, _mm256_set1_epi32(8));
+        }
+
+        float distances[8], us[8], vs[8];
+        uint32_t indexValues[8];
+        _mm256_storeu_ps(distances, bestDistance);
+        _mm256_storeu_ps(us, bestU);
+        _mm256_storeu_ps(vs, bestV);
+        _mm256_storeu_ps(reinterpret_cast<float*>(indexValues), bestTriangle);
+
+        const auto found = ReduceHits(distances, us, vs, indexValues, 8, hit);
+        return IntersectRaySSE2(ray, triangles, i, end, hit) || found;
+    }
+
+    SIMD_TARGET_AVX2 static void IntersectPacketAVX2(RayPacket& packet, const float* const* triangles, const size_t count)
+    {
+        const __m256 position[3] = { _mm256_loadu_ps(packet.positionX), _mm256_loadu_ps(packet.positionY), _mm256_loadu_ps(packet.positionZ) };
+        const __m256 direction[3] = { _mm256_loadu_ps(packet.directionX), _mm256_loadu_ps(packet.directionY), _mm256_loadu_ps(packet.directionZ) };
+
+        auto bestDistance = _mm256_loadu_ps(packet.distance);
+        auto bestU = _mm256_loadu_ps(packet.u);
+        auto bestV = _mm256_loadu_ps(packet.v);
+        auto bestTriangle = _mm256_loadu_ps(reinterpret_cast<const float*>(packet.triangle));
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            __m256 corner[3], edge1[3], edge2[3];
+            for (auto c = 0; c < 3; c++)
+            {
+                corner[c] = _mm256_broadcast_ss(triangles[c] + i);
+                edge1[c] = _mm256_broadcast_ss(triangles[3 + c] + i);
+                edge2[c] = _mm256_broadcast_ss(triangles[6 + c] + i);
+            }
+
+            __m256 distance, u, v;
+            const auto intersects = IntersectAVX2(position, direction, corner, edge1, edge2, distance, u, v);
+            const auto closer = _mm256_and_ps(intersects, _mm256_cmp_ps(distance, bestDistance, _CMP_LT_OQ));
+
+            if (_mm256_movemask_ps(closer) == 0)
+                continue;
+
+            bestDistance = _mm256_blendv_ps(bestDistance, distance, closer);
+            bestU = _mm256_blendv_ps(bestU, u, closer);
+            bestV = _mm256_blendv_ps(bestV, v, closer);
+            bestTriangle = _mm256_blendv_ps(bestTriangle, _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(i))), closer);
+        }
+
+        _mm256_storeu_ps(packet.distance, bestDistance);
+        _mm256_storeu_ps(packet.u, bestU);
+        _mm256_storeu_ps(packet.v, bestV);
+        _mm256_storeu_ps(reinterpret_cast<float*>(packet.triangle), bestTriangle);
+    }
+
+    SIMD_TARGET_AVX2 static void LoadPlane(const PlaneBase<float>& plane, __m256 (&components)[4])
+    {
+        const auto value = _mm_loadu_ps(&plane.normal.x);
+        components[0] = _mm256_broadcastss_ps(value);
+        components[1] = _mm256_broadcastss_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1)));
+        components[2] = _mm256_broadcastss_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 2, 2)));
+        components[3] = _mm256_broadcastss_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+
+    SIMD_TARGET_AVX2 static __m256 GetPlaneDistances(const __m256 (&plane)[4], const Vector3Base<float>* points)
+    {
+        // Points 0-3 go to the lower lane and 4-7 to the upper lane, see TransformPointsSSE2
+        const auto input = &points[0].x;
+        const auto m03 = Load2(input + 0, input + 12);
+        const auto m14 = Load2(input + 4, input + 16);
+        const auto m25 = Load2(input + 8, input + 20);
+
+        const auto xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+        const auto yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+        const auto x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+        const auto y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        const auto z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+
+        return _mm256_fmadd_ps(plane[2], z, _mm256_fmadd_ps(plane[1], y, _mm256_fmadd_ps(plane[0], x, plane[3])));
+    }
+
+    SIMD_TARGET_AVX2 static __m256i ClassifyDistances(const __m256 distance, const __m256 radius)
+    {
+        const auto front = _mm256_castps_si256(_mm256_cmp_ps(distance, radius, _CMP_GT_OQ));
+        const auto back = _mm256_castps_si256(_mm256_cmp_ps(distance, _mm256_xor_ps(radius, _mm256_set1_ps(-0.0f)), _CMP_LT_OQ));
+
+        const auto intersecting = _mm256_set1_epi32(static_cast<int>(PlaneIntersection::Intersecting));
+        return _mm256_sub_epi32(_mm256_sub_epi32(intersecting, back), _mm256_add_epi32(front, front));
+    }
+
+    SIMD_TARGET_AVX2 static void SignedDistancesAVX2(const PlaneBase<float>& plane, const Vector3Base<float>* points, float* distances, const size_t count)
+    {
+        __m256 components[4];
+        LoadPlane(plane, components);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(distances + i, GetPlaneDistances(components, points + i));
+
+        SignedDistancesSSE2(plane, points + i, distances + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void ClassifyPointsAVX2(const PlaneBase<float>& plane, const Vector3Base<float>* points, PlaneIntersection* results, const size_t count)
+    {
+        __m256 components[4];
+        LoadPlane(plane, components);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + i), ClassifyDistances(GetPlaneDistances(components, points + i), _mm256_setzero_ps()));
+
+        ClassifyPointsSSE2(plane, points + i, results + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void ClassifySpheresAVX2(const PlaneBase<float>& plane, const BoundingSphereBase<float>* spheres, PlaneIntersection* results, const size_t count)
+    {
+        __m256 components[4];
+        LoadPlane(plane, components);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            // Spheres 0-3 go to the lower lane and 4-7 to the upper lane, so the results are stored in order
+            auto x = Load2(&spheres[i + 0].center.x, &spheres[i + 4].center.x);
+            auto y = Load2(&spheres[i + 1].center.x, &spheres[i + 5].center.x);
+            auto z = Load2(&spheres[i + 2].center.x, &spheres[i + 6].center.x);
+            auto radius = Load2(&spheres[i + 3].center.x, &spheres[i + 7].center.x);
+            Transpose(x, y, z, radius);
+
+            const auto distance = _mm256_fmadd_ps(components[2], z, _mm256_fmadd_ps(components[1], y, _mm256_fmadd_ps(components[0], x, components[3])));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + i), ClassifyDistances(distance, radius));
+        }
+
+        ClassifySpheresSSE2(plane, spheres + i, results + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static void ClassifyBoxesAVX2(const PlaneBase<float>& plane, const BoundingBoxBase<float>* boxes, PlaneIntersection* results, const size_t count)
+    {
+        __m256 components[4];
+        LoadPlane(plane, components);
+
+        const auto half = _mm256_set1_ps(0.5f);
+        const auto signMask = _mm256_set1_ps(-0.0f);
+        const auto absoluteX = _mm256_andnot_ps(signMask, components[0]);
+        const auto absoluteY = _mm256_andnot_ps(signMask, components[1]);
+        const auto absoluteZ = _mm256_andnot_ps(signMask, components[2]);
+
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto box = &boxes[i].center.x;
+            const auto high = box + 24;
+
+            auto cx = Load2(box + 0, high + 0), cy = Load2(box + 6, high + 6), cz = Load2(box + 12, high + 12), sx = Load2(box + 18, high + 18);
+            auto cz2 = Load2(box + 2, high + 2), sx2 = Load2(box + 8, high + 8), sy = Load2(box + 14, high + 14), sz = Load2(box + 20, high + 20);
+            Transpose(cx, cy, cz, sx);
+            Transpose(cz2, sx2, sy, sz);
+
+            const auto distance = _mm256_fmadd_ps(components[2], cz, _mm256_fmadd_ps(components[1], cy, _mm256_fmadd_ps(components[0], cx, components[3])));
+            const auto radius = _mm256_fmadd_ps(absoluteZ, _mm256_mul_ps(sz, half),
+                _mm256_fmadd_ps(absoluteY, _mm256_mul_ps(sy, half), _mm256_mul_ps(absoluteX, _mm256_mul_ps(sx, half))));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + i), ClassifyDistances(distance, radius));
+        }
+
+        ClassifyBoxesSSE2(plane, boxes + i, results + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2 static __m256 Broadcast2(const float low, const float high)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(low)), _mm_set1_ps(high), 1);
+    }
+
+    SIMD_TARGET_AVX2 static void SkinVerticesAVX2(const Vector3Base<float>* positions, const Vector3Base<float>* normals, const uint32_t* boneIndices, const float* boneWeights,
+        const Matrix4x4Base<float>* palette, Vector3Base<float>* outPositions, Vector3Base<float>* outNormals, const size_t count)
+    {
+        const auto skinNormals = normals != nullptr && outNormals != nullptr;
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto epsilon = _mm256_set1_ps(FLT_EPSILON);
+
+        // Two vertices per iteration, the first one in the lower and the second one in the upper lane, see SkinVerticesSSE2.
+        // The bone rows are contiguous, so two row loads beat gathering every matrix element across eight vertices
+        // (12 gathers per influence), which measured about twice as slow.
+        auto i = size_t(0);
+        for (; i + 2 <= count; i += 2)
+        {
+            const auto indices = boneIndices + i * 4;
+            const auto weights = boneWeights + i * 4;
+
+            auto r0 = _mm256_setzero_ps(), r1 = _mm256_setzero_ps(), r2 = _mm256_setzero_ps(), r3 = _mm256_setzero_ps();
+            for (auto k = size_t(0); k < 4; k++)
+            {
+                const auto weight = Broadcast2(weights[k], weights[k + 4]);
+                const auto low = &palette[indices[k]].m11;
+                const auto high = &palette[indices[k + 4]].m11;
+
+                r0 = _mm256_fmadd_ps(Load2(low + 0, high + 0), weight, r0);
+                r1 = _mm256_fmadd_ps(Load2(low + 4, high + 4), weight, r1);
+                r2 = _mm256_fmadd_ps(Load2(low + 8, high + 8), weight, r2);
+                r3 = _mm256_fmadd_ps(Load2(low + 12, high + 12), weight, r3);
+            }
+
+            const auto& p0 = positions[i];
+            const auto& p1 = positions[i + 1];
+            const auto transformed = _mm256_fmadd_ps(Broadcast2(p0.z, p1.z), r2,
+                _mm256_fmadd_ps(Broadcast2(p0.y, p1.y), r1, _mm256_fmadd_ps(Broadcast2(p0.x, p1.x), r0, r3)));
+            StoreVector3(outPositions[i], _mm256_castps256_ps128(transformed));
+            StoreVector3(outPositions[i + 1], _mm256_extractf128_ps(transformed, 1));
+
+            if (!skinNormals)
+                continue;
+
+            const auto& n0 = normals[i];
+            const auto& n1 = normals[i + 1];
+            const auto rotated = _mm256_fmadd_ps(Broadcast2(n0.z, n1.z), r2,
+                _mm256_fmadd_ps(Broadcast2(n0.y, n1.y), r1, _mm256_mul_ps(Broadcast2(n0.x, n1.x), r0)));
+
+            const auto squared = _mm256_mul_ps(rotated, rotated);
+            const auto lengthSquared = _mm256_add_ps(_mm256_add_ps(
+                _mm256_permute_ps(squared, _MM_SHUFFLE(0, 0, 0, 0)),
+                _mm256_permute_ps(squared, _MM_SHUFFLE(1, 1, 1, 1))),
+                _mm256_permute_ps(squared, _MM_SHUFFLE(2, 2, 2, 2)));
+            const auto scale = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared));
+            const auto normalized = _mm256_blendv_ps(_mm256_mul_ps(rotated, scale), rotated, _mm256_cmp_ps(lengthSquared, epsilon, _CMP_LT_OQ));
+            StoreVector3(outNormals[i], _mm256_castps256_ps128(normalized));
+            StoreVector3(outNormals[i + 1], _mm256_extractf128_ps(normalized, 1));
+        }
+
+        SkinVerticesSSE2(positions + i, normals != nullptr ? normals + i : nullptr, boneIndices + i * 4, boneWeights + i * 4,
+            palette, outPositions + i, outNormals != nullptr ? outNormals + i : nullptr, count - i);
+    }
+
+private:
+    /* AVX-512 kernels */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // False positive in the GCC 12 AVX-512 intrinsics
+#endif
+
+    SIMD_TARGET_AVX512 static void MultiplyMatricesAVX512(const Matrix4x4Base<float>* a, const Matrix4x4Base<float>* b, Matrix4x4Base<float>* result, const size_t count)
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto lhs = _mm512_loadu_ps(&a[i].m11);
+            const auto rhs = _mm512_loadu_ps(&b[i].m11);
+
+            // The whole matrix in one register, every 128-bit lane multiplies one row
+            const auto b0 = _mm512_shuffle_f32x4(rhs, rhs, _MM_SHUFFLE(0, 0, 0, 0));
+            const auto b1 = _mm512_shuffle_f32x4(rhs, rhs, _MM_SHUFFLE(1, 1, 1, 1));
+            const auto b2 = _mm512_shuffle_f32x4(rhs, rhs, _MM_SHUFFLE(2, 2, 2, 2));
+            const auto b3 = _mm512_shuffle_f32x4(rhs, rhs, _MM_SHUFFLE(3, 3, 3, 3));
+
+            auto value = _mm512_mul_ps(_mm512_permute_ps(lhs, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+            value = _mm512_fmadd_ps(_mm512_permute_ps(lhs, _MM_SHUFFLE(1, 1, 1, 1)), b1, value);
+            value = _mm512_fmadd_ps(_mm512_permute_ps(lhs, _MM_SHUFFLE(2, 2, 2, 2)), b2, value);
+            value = _mm512_fmadd_ps(_mm512_permute_ps(lhs, _MM_SHUFFLE(3, 3, 3, 3)), b3, value);
+
+            _mm512_storeu_ps(&result[i].m11, value);
+        }
+    }
+
+    SIMD_TARGET_AVX512 static __m512 Deinterleave(const __m512* source, const __m512i positions, const __mmask16 secondPair, const __mmask16 thirdPair)
+    {
+        // Gathers the floats at the given positions from up to 6 consecutive registers; every permutation
+        // picks from a pair of registers (only the low 5 index bits are used) and the results are merged
+        auto value = _mm512_permutex2var_ps(source[0], positions, source[1]);
+        value = _mm512_mask_blend_ps(secondPair, value, _mm512_permutex2var_ps(source[2], positions, source[3]));
+
+        if (thirdPair != 0)
+            value = _mm512_mask_blend_ps(thirdPair, value, _mm512_permutex2var_ps(source[4], positions, source[5]));
+
+        return value;
+    }
+
+    SIMD_TARGET_AVX512 static void GetDeinterleavePositions(const int stride, const int component, __m512i* positions, __mmask16* secondPair, __mmask16* thirdPair)
+    {
+        *positions = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+            _mm512_set1_epi32(stride)), _mm512_set1_epi32(component));
+
+        *thirdPair = _mm512_cmpge_epi32_mask(*positions, _mm512_set1_epi32(64));
+        *secondPair = _mm512_cmpge_epi32_mask(*positions, _mm512_set1_epi32(32)) & ~*thirdPair;
+    }
+
+    SIMD_TARGET_AVX512 static size_t StoreVisible16(const __mmask16 mask, const __m512i indices, const CompressTable& compressTable, uint32_t* visibleIndices, const size_t visibleCount)
+    {
+        // vpcompressd into a register followed by a full store, the memory form of the instruction is much slower
+        // on some CPUs. Writes all 16 lanes, the caller guarantees there is room for them.
+        _mm512_storeu_si512(visibleIndices + visibleCount, _mm512_maskz_compress_epi32(mask, indices));
+
+        return visibleCount + compressTable.counts[mask & 0xFFu] + compressTable.counts[mask >> 8];
+    }
+
+    SIMD_TARGET_AVX512 static size_t CullBoxesAVX512(const PlaneBase<float>* planes, const size_t planeCount, const BoundingBoxBase<float>* boxes, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex)
+    {
+        // 16 boxes are 96 floats (6 registers), every component is deinterleaved with 3 two-register permutations
+        __m512i positions[6];
+        __mmask16 secondPair[6];
+        __mmask16 thirdPair[6];
+
+        for (auto c = 0; c < 6; c++)
+            GetDeinterleavePositions(6, c, &positions[c], &secondPair[c], &thirdPair[c]);
+
+        const auto half = _mm512_set1_ps(0.5f);
+        const auto laneIndices = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const auto& compressTable = GetCompressTable();
+
+        auto visibleCount = size_t(0);
+        auto i = size_t(0);
+        for (; i + 16 <= count; i += 16)
+        {
+            const auto box = &boxes[i].center.x;
+
+            __m512 source[6];
+            for (auto r = 0; r < 6; r++)
+                source[r] = _mm512_loadu_ps(box + r * 16);
+
+            const auto cx = Deinterleave(source, positions[0], secondPair[0], thirdPair[0]);
+            const auto cy = Deinterleave(source, positions[1], secondPair[1], thirdPair[1]);
+            const auto cz = Deinterleave(source, positions[2], secondPair[2], thirdPair[2]);
+            const auto ex = _mm512_mul_ps(Deinterleave(source, positions[3], secondPair[3], thirdPair[3]), half);
+            const auto ey = _mm512_mul_ps(Deinterleave(source, positions[4], secondPair[4], thirdPair[4]), half);
+            const auto ez = _mm512_mul_ps(Deinterleave(source, positions[5], secondPair[5], thirdPair[5]), half);
+
+            auto visible = __mmask16(0xFFFF);
+            for (auto p = size_t(0); p < planeCount; p++)
+            {
+                const auto& plane = planes[p];
+                const auto nx = _mm512_set1_ps(plane.normal.x);
+                const auto ny = _mm512_set1_ps(plane.normal.y);
+                const auto nz = _mm512_set1_ps(plane.normal.z);
+
+                const auto distance = _mm512_fmadd_ps(nz, cz, _mm512_fmadd_ps(ny, cy, _mm512_fmadd_ps(nx, cx, _mm512_set1_ps(plane.distance))));
+                const auto radius = _mm512_fmadd_ps(_mm512_set1_ps(Math::Abs(plane.normal.z)), ez,
+                    _mm512_fmadd_ps(_mm512_set1_ps(Math::Abs(plane.normal.y)), ey, _mm512_mul_ps(_mm512_set1_ps(Math::Abs(plane.normal.x)), ex)));
+
+                visible = _mm512_mask_cmp_ps_mask(visible, distance, _mm512_sub_ps(_mm512_setzero_ps(), radius), _CMP_NLT_UQ);
+            }
+
+            const auto indices = _mm512_add_epi32(laneIndices, _mm512_set1_epi32(static_cast<int>(firstIndex + static_cast<uint32_t>(i))));
+            visibleCount = StoreVisible16(visible, indices, compressTable, visibleIndices, visibleCount);
+        }
+
+        return visibleCount + CullBoxesAVX2(planes, planeCount, boxes + i, count - i, visibleIndices + visibleCount, firstIndex + static_cast<uint32_t>(i));
+    }
+
+    SIMD_TARGET_AVX512 static size_t CullSpheresAVX512(const PlaneBase<float>* planes, const size_t planeCount, const BoundingSphereBase<float>* spheres, const size_t count, uint32_t* visibleIndices, const uint32_t firstIndex)
+    {
+        __m512i positions[4];
+        __mmask16 secondPair[4];
+        __mmask16 thirdPair[4];
+
+        for (auto c = 0; c < 4; c++)
+            GetDeinterleavePositions(4, c, &positions[c], &secondPair[c], &thirdPair[c]);
+
+        const auto laneIndices = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const auto& compressTable = GetCompressTable();
+
+        auto visibleCount = size_t(0);
+        auto i = size_t(0);
+        for (; i + 16 <= count; i += 16)
+        {
+            const auto sphere = &spheres[i].center.x;
+
+            __m512 source[4];
+            for (auto r = 0; r < 4; r++)
+                source[r] = _mm512_loadu_ps(sphere + r * 16);
+
+            const auto x = Deinterleave(source, positions[0], secondPair[0], 0);
+            const auto y = Deinterleave(source, positions[1], secondPair[1], 0);
+            const auto z = Deinterleave(source, positions[2], secondPair[2], 0);
+            const auto negativeRadius = _mm512_sub_ps(_mm512_setzero_ps(), Deinterleave(source, positions[3], secondPair[3], 0));
+
+            auto visible = __mmask16(0xFFFF);
+            for (auto p = size_t(0); p < planeCount; p++)
+            {
+                const auto& plane = planes[p];
+                const auto distance = _mm512_fmadd_ps(_mm512_set1_ps(plane.normal.z), z,
+                    _mm512_fmadd_ps(_mm512_set1_ps(plane.normal.y), y,
+                    _mm512_fmadd_ps(_mm512_set1_ps(plane.normal.x), x, _mm512_set1_ps(plane.distance))));
+
+                visible = _mm512_mask_cmp_ps_mask(visible, distance, negativeRadius, _CMP_GE_OQ);
+            }
+
+            const auto indices = _mm512_add_epi32(laneIndices, _mm512_set1_epi32(static_cast<int>(firstIndex + static_cast<uint32_t>(i))));
+            visibleCount = StoreVisible16(visible, indices, compressTable, visibleIndices, visibleCount);
+        }
+
+        return visibleCount + CullSpheresAVX2(planes, planeCount, spheres + i, count - i, visibleIndices + visibleCount, firstIndex + static_cast<uint32_t>(i));
+    }
+
+    SIMD_TARGET_AVX512 static BoundingBoxBase<float> FromPointsAVX512(const Vector3Base<float>* points, const size_t count)
+    {
+        if (count < 16)
+            return FromPointsAVX2(points, count);
+
+        const auto values = &points[0].x;
+        __m512 minimum[3];
+        __m512 maximum[3];
+        for (auto r = 0; r < 3; r++)
+            minimum[r] = maximum[r] = _mm512_loadu_ps(values + r * 16);
+
+        auto i = size_t(16);
+        for (; i + 16 <= count; i += 16)
+        {
+            for (auto r = 0; r < 3; r++)
+            {
+                const auto value = _mm512_loadu_ps(values + i * 3 + r * 16);
+                minimum[r] = _mm512_min_ps(minimum[r], value);
+                maximum[r] = _mm512_max_ps(maximum[r], value);
+            }
+        }
+
+        float minimumValues[48];
+        float maximumValues[48];
+        for (auto r = 0; r < 3; r++)
+        {
+            _mm512_storeu_ps(minimumValues + r * 16, minimum[r]);
+            _mm512_storeu_ps(maximumValues + r * 16, maximum[r]);
+        }
+
+        return FoldBounds(minimumValues, maximumValues, 48, points + i, count - i);
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+};
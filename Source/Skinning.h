@@ -0,0 +1,134 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "Vector4Base.h"
+#include "Matrix4x4Base.h"
+#include "SimdKernels.h"
+
+class Skinning
+{
+public:
+    /// <summary>
+    ///     Number of bone influences per vertex.
+    /// </summary>
+    static const size_t MaxInfluences = 4;
+
+public:
+    /// <summary>
+    ///     Linear-blend skinning of an array of vertices.
+    ///     The weighted 3x4 affine rows of all influencing bones are blended first,
+    ///     then every vertex is transformed once by the blended matrix.
+    /// </summary>
+    /// <param name="positions">The bind-pose positions.</param>
+    /// <param name="normals">The bind-pose normals, can be null.</param>
+    /// <param name="boneIndices">Four palette indices per vertex.</param>
+    /// <param name="boneWeights">Four bone weights per vertex, expected to sum up to one.</param>
+    /// <param name="palette">The bone matrix palette, only the affine part (3x4) is used.</param>
+    /// <param name="outPositions">The skinned positions.</param>
+    /// <param name="outNormals">The skinned normals, can be null.</param>
+    /// <param name="count">The vertex count.</param>
+    /// <remarks>
+    ///     Vertices are independent of each other, the mesh can be skinned in chunks
+    ///     (e.g. on multiple threads) by offsetting all of the input and output pointers.
+    ///     Single precision vertices with 32-bit integer indices use SimdKernels::SkinVertices.
+    /// </remarks>
+    template<typename T, typename TIndex>
+    static void SkinVertices(const Vector3Base<T>* positions, const Vector3Base<T>* normals,
+        const Vector4Base<TIndex>* boneIndices, const Vector4Base<T>* boneWeights, const Matrix4x4Base<T>* palette,
+        Vector3Base<T>* outPositions, Vector3Base<T>* outNormals, const size_t count)
+    {
+        SkinArray(positions, normals, boneIndices, boneWeights, palette, outPositions, outNormals, count);
+    }
+
+    /// <summary>
+    ///     Linear-blend skinning of an array of positions.
+    /// </summary>
+    template<typename T, typename TIndex>
+    static void SkinVertices(const Vector3Base<T>* positions, const Vector4Base<TIndex>* boneIndices,
+        const Vector4Base<T>* boneWeights, const Matrix4x4Base<T>* palette, Vector3Base<T>* outPositions, const size_t count)
+    {
+        SkinVertices<T, TIndex>(positions, nullptr, boneIndices, boneWeights, palette, outPositions, nullptr, count);
+    }
+
+private:
+    template<typename T, typename TIndex>
+    static void SkinArray(const Vector3Base<T>* positions, const Vector3Base<T>* normals,
+        const Vector4Base<TIndex>* boneIndices, const Vector4Base<T>* boneWeights, const Matrix4x4Base<T>* palette,
+        Vector3Base<T>* outPositions, Vector3Base<T>* outNormals, const size_t count)
+    {
+        const auto skinNormals = normals != nullptr && outNormals != nullptr;
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            T rows[12];
+            BlendRows(boneIndices[i], boneWeights[i], palette, rows);
+
+            const auto& position = positions[i];
+            outPositions[i] = Vector3Base<T>(
+                position.x * rows[0] + position.y * rows[3] + position.z * rows[6] + rows[9],
+                position.x * rows[1] + position.y * rows[4] + position.z * rows[7] + rows[10],
+                position.x * rows[2] + position.y * rows[5] + position.z * rows[8] + rows[11]);
+
+            if (!skinNormals)
+                continue;
+
+            const auto& normal = normals[i];
+            outNormals[i] = Vector3Base<T>(
+                normal.x * rows[0] + normal.y * rows[3] + normal.z * rows[6],
+                normal.x * rows[1] + normal.y * rows[4] + normal.z * rows[7],
+                normal.x * rows[2] + normal.y * rows[5] + normal.z * rows[8]);
+            outNormals[i].Normalize();
+        }
+    }
+
+    static void SkinArray(const Vector3Base<float>* positions, const Vector3Base<float>* normals,
+        const Vector4Base<uint32_t>* boneIndices, const Vector4Base<float>* boneWeights, const Matrix4x4Base<float>* palette,
+        Vector3Base<float>* outPositions, Vector3Base<float>* outNormals, const size_t count)
+    {
+        SimdKernels::SkinVertices(positions, normals, reinterpret_cast<const uint32_t*>(boneIndices), reinterpret_cast<const float*>(boneWeights),
+            palette, outPositions, outNormals, count);
+    }
+
+    static void SkinArray(const Vector3Base<float>* positions, const Vector3Base<float>* normals,
+        const Vector4Base<int32_t>* boneIndices, const Vector4Base<float>* boneWeights, const Matrix4x4Base<float>* palette,
+        Vector3Base<float>* outPositions, Vector3Base<float>* outNormals, const size_t count)
+    {
+        // Negative indices are invalid either way
+        SimdKernels::SkinVertices(positions, normals, reinterpret_cast<const uint32_t*>(boneIndices), reinterpret_cast<const float*>(boneWeights),
+            palette, outPositions, outNormals, count);
+    }
+
+    template<typename T, typename TIndex>
+    static void BlendRows(const Vector4Base<TIndex>& indices, const Vector4Base<T>& weights, const Matrix4x4Base<T>* palette, T* rows)
+    {
+        // Accumulate weight * [m11 m12 m13 | m21 m22 m23 | m31 m32 m33 | m41 m42 m43]
+        // for all influences, with no branching on zero weights so the loop stays straight-line code.
+        for (auto j = size_t(0); j < 12; j++)
+            rows[j] = T(0);
+
+        for (auto k = size_t(0); k < MaxInfluences; k++)
+        {
+            const auto weight = weights[k];
+            const auto& bone = palette[static_cast<size_t>(indices[k])];
+
+            rows[0] += bone.m11 * weight;
+            rows[1] += bone.m12 * weight;
+            rows[2] += bone.m13 * weight;
+            rows[3] += bone.m21 * weight;
+            rows[4] += bone.m22 * weight;
+            rows[5] += bone.m23 * weight;
+            rows[6] += bone.m31 * weight;
+            rows[7] += bone.m32 * weight;
+            rows[8] += bone.m33 * weight;
+            rows[9] += bone.m41 * weight;
+            rows[10] += bone.m42 * weight;
+            rows[11] += bone.m43 * weight;
+        }
+    }
+};
@@ -0,0 +1,308 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "Config.h"
+#include "Math.h"
+#include "Vector3Base.h"
+#include "BoundingSphereBase.h"
+
+/// <summary>
+///     Uniform-grid spatial hash for points and spheres.
+///     Entries are bucketed by the hash of their quantized Vector3Base&lt;int&gt; cell coordinate
+///     and stored in a flat array sorted by bucket (counting sort), so a rebuild does no per-entry allocation
+///     and the entries of a single cell are contiguous in memory.
+/// </summary>
+template<typename T>
+class SpatialHashGridBase
+{
+private:
+    struct Entry
+    {
+        Vector3Base<T> position;
+        uint32_t index;
+    };
+
+public:
+    /// <summary>
+    ///     Constructs an empty grid.
+    /// </summary>
+    /// <param name="cellSize">
+    ///     The size of a single grid cell, the best performance is usually achieved
+    ///     when it is close to the typical query radius.
+    /// </param>
+    explicit SpatialHashGridBase(const T cellSize = T(1))
+    {
+        SetCellSize(cellSize);
+    }
+
+public:
+    /// <summary>
+    ///     Sets the size of a single grid cell, the grid has to be rebuilt afterwards.
+    /// </summary>
+    void SetCellSize(const T cellSize)
+    {
+        m_cellSize = cellSize;
+        m_invCellSize = T(1) / cellSize;
+    }
+
+    /// <summary>
+    ///     Rebuilds the grid from an array of points.
+    /// </summary>
+    /// <param name="points">The points.</param>
+    /// <param name="count">The point count.</param>
+    void Build(const Vector3Base<T>* points, const size_t count)
+    {
+        m_radii.clear();
+        m_maxRadius = T(0);
+
+        BuildInternal(points, sizeof(Vector3Base<T>), count);
+    }
+
+    /// <summary>
+    ///     Rebuilds the grid from an array of spheres.
+    ///     Spheres are bucketed by their centers, queries are extended by the largest radius.
+    /// </summary>
+    /// <param name="spheres">The spheres.</param>
+    /// <param name="count">The sphere count.</param>
+    void Build(const BoundingSphereBase<T>* spheres, const size_t count)
+    {
+        m_maxRadius = T(0);
+        for (auto i = size_t(0); i < count; i++)
+            m_maxRadius = Math::Max(m_maxRadius, spheres[i].radius);
+
+        BuildInternal(&spheres[0].center, sizeof(BoundingSphereBase<T>), count);
+
+        m_radii.resize(count);
+        for (auto i = size_t(0); i < count; i++)
+            m_radii[i] = spheres[m_entries[i].index].radius;
+    }
+
+    /// <summary>
+    ///     Calls the callback with the index of every entry within the given radius of a point.
+    ///     When the grid was built from spheres, entries whose spheres overlap the query sphere are reported.
+    /// </summary>
+    /// <param name="point">The query point.</param>
+    /// <param name="radius">The query radius.</param>
+    /// <param name="callback">The callback, called as callback(uint32_t index).</param>
+    template<typename TCallback>
+    void ForEach(const Vector3Base<T>& point, const T radius, TCallback callback) const
+    {
+        if (m_entries.empty())
+            return;
+
+        const auto extent = radius + m_maxRadius;
+        const auto minCell = GetCell(point - Vector3Base<T>(extent));
+        const auto maxCell = GetCell(point + Vector3Base<T>(extent));
+
+        const auto cellCount = static_cast<size_t>(maxCell.x - minCell.x + 1)
+            * static_cast<size_t>(maxCell.y - minCell.y + 1)
+            * static_cast<size_t>(maxCell.z - minCell.z + 1);
+
+        const auto visit = [&](const size_t i)
+        {
+            const auto& entry = m_entries[i];
+            const auto reach = m_radii.empty() ? radius : radius + m_radii[i];
+
+            if (Vector3Base<T>::DistanceSquared(point, entry.position) <= reach * reach)
+                callback(entry.index);
+        };
+
+        // Testing every entry is cheaper than visiting more cells than there are entries
+        if (cellCount >= m_entries.size())
+        {
+            for (auto i = size_t(0); i < m_entries.size(); i++)
+                visit(i);
+            return;
+        }
+
+        if (cellCount > MaxSortedBuckets)
+        {
+            // Large ranges visit their cells directly. The entries of the other cells sharing a bucket are skipped,
+            // so every entry is reported from its own cell only, without collecting the buckets first
+            for (auto z = minCell.z; z <= maxCell.z; z++)
+            {
+                for (auto y = minCell.y; y <= maxCell.y; y++)
+                {
+                    for (auto x = minCell.x; x <= maxCell.x; x++)
+                    {
+                        const auto cell = Vector3Base<int>(x, y, z);
+                        const auto bucket = Hash(cell);
+
+                        for (auto i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1]; i++)
+                        {
+                            if (GetCell(m_entries[i].position) == cell)
+                                visit(i);
+                        }
+                    }
+                }
+            }
+            return;
+        }
+
+        // Several cells of the range can map to the same bucket, every bucket has to be visited only once.
+        // Entries of other cells sharing a bucket are rejected by the distance test.
+        uint32_t buckets[MaxSortedBuckets];
+
+        auto bucketCount = size_t(0);
+        for (auto z = minCell.z; z <= maxCell.z; z++)
+        {
+            for (auto y = minCell.y; y <= maxCell.y; y++)
+            {
+                for (auto x = minCell.x; x <= maxCell.x; x++)
+                    buckets[bucketCount++] = Hash(Vector3Base<int>(x, y, z));
+            }
+        }
+
+        std::sort(buckets, buckets + bucketCount);
+        bucketCount = static_cast<size_t>(std::unique(buckets, buckets + bucketCount) - buckets);
+
+        for (auto b = size_t(0); b < bucketCount; b++)
+        {
+            const auto bucket = buckets[b];
+
+            for (auto i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1]; i++)
+                visit(i);
+        }
+    }
+
+    /// <summary>
+    ///     Finds all entries within the given radius of a point.
+    /// </summary>
+    /// <param name="point">The query point.</param>
+    /// <param name="radius">The query radius.</param>
+    /// <param name="result">The output list of entry indices, it is cleared first.</param>
+    void Query(const Vector3Base<T>& point, const T radius, std::vector<uint32_t>& result) const
+    {
+        result.clear();
+        ForEach(point, radius, [&result](const uint32_t index)
+        {
+            result.push_back(index);
+        });
+    }
+
+    /// <summary>
+    ///     Finds all entries overlapping the given sphere.
+    /// </summary>
+    /// <param name="sphere">The query sphere.</param>
+    /// <param name="result">The output list of entry indices, it is cleared first.</param>
+    void Query(const BoundingSphereBase<T>& sphere, std::vector<uint32_t>& result) const
+    {
+        Query(sphere.center, sphere.radius, result);
+    }
+
+    /// <summary>
+    ///     Finds all pairs of entries that are within the given radius of each other.
+    ///     When the grid was built from spheres, the radius is added to the sum of the sphere radii.
+    /// </summary>
+    /// <param name="radius">The pair distance.</param>
+    /// <param name="pairs">The output list of pairs (lower index first), it is cleared first.</param>
+    void FindPairs(const T radius, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const
+    {
+        pairs.clear();
+
+        for (auto i = size_t(0); i < m_entries.size(); i++)
+        {
+            const auto index = m_entries[i].index;
+            const auto reach = m_radii.empty() ? radius : radius + m_radii[i];
+
+            ForEach(m_entries[i].position, reach, [&pairs, index](const uint32_t other)
+            {
+                if (other > index)
+                    pairs.emplace_back(index, other);
+            });
+        }
+    }
+
+    /// <summary>
+    ///     Returns the cell coordinate containing the given point.
+    /// </summary>
+    Vector3Base<int> GetCell(const Vector3Base<T>& point) const
+    {
+        return Vector3Base<int>(
+            Math::FloorToInt(point.x * m_invCellSize),
+            Math::FloorToInt(point.y * m_invCellSize),
+            Math::FloorToInt(point.z * m_invCellSize));
+    }
+
+    /// <summary>
+    ///     Returns the entry count.
+    /// </summary>
+    size_t GetCount() const
+    {
+        return m_entries.size();
+    }
+
+    /// <summary>
+    ///     Returns the size of a single grid cell.
+    /// </summary>
+    T GetCellSize() const
+    {
+        return m_cellSize;
+    }
+
+private:
+    static const size_t MaxSortedBuckets = 64;
+
+    uint32_t Hash(const Vector3Base<int>& cell) const
+    {
+        const auto hash = (static_cast<uint32_t>(cell.x) * 73856093u)
+            ^ (static_cast<uint32_t>(cell.y) * 19349663u)
+            ^ (static_cast<uint32_t>(cell.z) * 83492791u);
+
+        return hash & m_bucketMask;
+    }
+
+    void BuildInternal(const Vector3Base<T>* points, const size_t stride, const size_t count)
+    {
+        const auto bucketCount = Math::RoundUpToPow2(static_cast<unsigned int>(Math::Max(count, size_t(1))));
+        m_bucketMask = bucketCount - 1;
+
+        m_bucketStart.assign(bucketCount + 1, 0u);
+        m_entryBucket.resize(count);
+        m_entries.resize(count);
+
+        const auto point = [points, stride](const size_t i) -> const Vector3Base<T>&
+        {
+            return *reinterpret_cast<const Vector3Base<T>*>(reinterpret_cast<const char*>(points) + i * stride);
+        };
+
+        // Counting sort by bucket: count, prefix sum, scatter
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto bucket = Hash(GetCell(point(i)));
+            m_entryBucket[i] = bucket;
+            m_bucketStart[bucket]++;
+        }
+
+        for (auto i = 1u; i < bucketCount; i++)
+            m_bucketStart[i] += m_bucketStart[i - 1];
+
+        m_bucketStart[bucketCount] = static_cast<uint32_t>(count);
+
+        // Scatter in reverse while decrementing the bucket ends, this turns the end offsets back
+        // into start offsets and keeps the entries of a bucket in their input order
+        for (auto i = count; i-- > 0;)
+        {
+            const auto slot = --m_bucketStart[m_entryBucket[i]];
+            m_entries[slot] = Entry{ point(i), static_cast<uint32_t>(i) };
+        }
+    }
+
+private:
+    T m_cellSize = T(1);
+    T m_invCellSize = T(1);
+    T m_maxRadius = T(0);
+    uint32_t m_bucketMask = 0u;
+
+    std::vector<uint32_t> m_bucketStart;
+    std::vector<uint32_t> m_entryBucket;
+
+    std::vector<Entry> m_entries;
+    std::vector<T> m_radii;
+};
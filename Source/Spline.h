@@ -0,0 +1,399 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "Cpu.h"
+#include "SimdKernels.h"
+#include "Vector2Base.h"
+#include "Vector3Base.h"
+#include "Vector4Base.h"
+
+enum class SplineType
+{
+    CatmullRom, // Passes through the control points, tangents from the neighbouring points
+    Hermite,    // Passes through the control points with explicit tangents
+    Bezier,     // Cubic Bezier segments sharing their end points, 3n + 1 control points
+    BSpline     // Uniform cubic B-spline, C2 continuous, does not pass through the control points
+};
+
+/// <summary>
+///     A cubic curve segment in power form, p(t) = a + b * t + c * t^2 + d * t^3 for t in 0..1.
+///     Every spline basis is converted to this form once, so all of them are evaluated the same way (Horner's method).
+/// </summary>
+template<typename TVector>
+struct CubicSegment
+{
+public:
+    typedef typename TVector::value_type T;
+
+public:
+    /// <summary>
+    ///     Evaluates the position.
+    /// </summary>
+    TVector Evaluate(const T t) const
+    {
+        return ((d * t + c) * t + b) * t + a;
+    }
+
+    /// <summary>
+    ///     Evaluates the first derivative (the tangent, not normalized).
+    /// </summary>
+    TVector EvaluateDerivative(const T t) const
+    {
+        return (d * (T(3) * t) + c * T(2)) * t + b;
+    }
+
+    /// <summary>
+    ///     Evaluates the second derivative.
+    /// </summary>
+    TVector EvaluateSecondDerivative(const T t) const
+    {
+        return d * (T(6) * t) + c * T(2);
+    }
+
+public:
+    /// <summary>
+    ///     Creates the uniform Catmull-Rom segment between p1 and p2.
+    /// </summary>
+    static CubicSegment CatmullRom(const TVector& p0, const TVector& p1, const TVector& p2, const TVector& p3)
+    {
+        CubicSegment segment;
+        segment.a = p1;
+        segment.b = (p2 - p0) * T(0.5);
+        segment.c = (p0 * T(2) - p1 * T(5) + p2 * T(4) - p3) * T(0.5);
+        segment.d = (p1 * T(3) - p0 - p2 * T(3) + p3) * T(0.5);
+        return segment;
+    }
+
+    /// <summary>
+    ///     Creates the Hermite segment between p0 and p1 with the tangents m0 and m1.
+    /// </summary>
+    static CubicSegment Hermite(const TVector& p0, const TVector& m0, const TVector& p1, const TVector& m1)
+    {
+        CubicSegment segment;
+        segment.a = p0;
+        segment.b = m0;
+        segment.c = (p1 - p0) * T(3) - m0 * T(2) - m1;
+        segment.d = (p0 - p1) * T(2) + m0 + m1;
+        return segment;
+    }
+
+    /// <summary>
+    ///     Creates the cubic Bezier segment of the given control points.
+    /// </summary>
+    static CubicSegment Bezier(const TVector& p0, const TVector& p1, const TVector& p2, const TVector& p3)
+    {
+        CubicSegment segment;
+        segment.a = p0;
+        segment.b = (p1 - p0) * T(3);
+        segment.c = (p0 - p1 * T(2) + p2) * T(3);
+        segment.d = (p1 - p2) * T(3) - p0 + p3;
+        return segment;
+    }
+
+    /// <summary>
+    ///     Creates the uniform cubic B-spline segment of the given control points.
+    /// </summary>
+    static CubicSegment BSpline(const TVector& p0, const TVector& p1, const TVector& p2, const TVector& p3)
+    {
+        const auto sixth = T(1) / T(6);
+
+        CubicSegment segment;
+        segment.a = (p0 + p1 * T(4) + p2) * sixth;
+        segment.b = (p2 - p0) * T(0.5);
+        segment.c = (p0 - p1 * T(2) + p2) * T(0.5);
+        segment.d = ((p1 - p2) * T(3) - p0 + p3) * sixth;
+        return segment;
+    }
+
+public:
+    TVector a;
+    TVector b;
+    TVector c;
+    TVector d;
+};
+
+/// <summary>
+///     Piecewise cubic spline over Vector2Base, Vector3Base or Vector4Base.
+///     The spline parameter runs from 0 to the segment count, segment i covers [i, i + 1].
+///     An optional arc-length table maps distances along the curve to parameters, for constant speed movement.
+///     Splines built from too few control points have no segments and evaluate to zero everywhere.
+/// </summary>
+template<typename TVector>
+class Spline
+{
+public:
+    typedef typename TVector::value_type T;
+    typedef CubicSegment<TVector> Segment;
+
+    static const size_t Dimension = TVector::Dimension;
+
+public:
+    Spline() = default;
+
+    /// <summary>
+    ///     Constructs a Catmull-Rom, Bezier or B-spline curve.
+    /// </summary>
+    /// <param name="type">The spline type, Hermite splines need the constructor taking tangents.</param>
+    /// <param name="points">The control points.</param>
+    /// <param name="count">The control point count.</param>
+    /// <remarks>
+    ///     Catmull-Rom splines pass through all of the points, the end segments reuse the end points as the outer neighbours.
+    ///     Bezier splines need 3n + 1 points, B-splines need at least 4 points and have count - 3 segments.
+    /// </remarks>
+    Spline(const SplineType type, const TVector* points, const size_t count)
+    {
+        switch (type)
+        {
+        case SplineType::CatmullRom:
+            for (auto i = size_t(0); i + 1 < count; i++)
+            {
+                const auto& p0 = points[i > 0 ? i - 1 : 0];
+                const auto& p3 = points[i + 2 < count ? i + 2 : count - 1];
+                AddSegment(Segment::CatmullRom(p0, points[i], points[i + 1], p3));
+            }
+            break;
+
+        case SplineType::Bezier:
+            for (auto i = size_t(0); i + 3 < count; i += 3)
+                AddSegment(Segment::Bezier(points[i], points[i + 1], points[i + 2], points[i + 3]));
+            break;
+
+        case SplineType::BSpline:
+            for (auto i = size_t(0); i + 3 < count; i++)
+                AddSegment(Segment::BSpline(points[i], points[i + 1], points[i + 2], points[i + 3]));
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    /// <summary>
+    ///     Constructs a Hermite spline.
+    /// </summary>
+    /// <param name="points">The control points.</param>
+    /// <param name="tangents">The tangents at the control points.</param>
+    /// <param name="count">The control point count.</param>
+    Spline(const TVector* points, const TVector* tangents, const size_t count)
+    {
+        for (auto i = size_t(0); i + 1 < count; i++)
+            AddSegment(Segment::Hermite(points[i], tangents[i], points[i + 1], tangents[i + 1]));
+    }
+
+public:
+    /// <summary>
+    ///     Evaluates the position at the given spline parameter.
+    /// </summary>
+    TVector Evaluate(const T parameter) const
+    {
+        if (m_segments.empty())
+            return TVector::Zero;
+
+        T t;
+        const auto& segment = m_segments[Locate(parameter, t)];
+        return segment.Evaluate(t);
+    }
+
+    /// <summary>
+    ///     Evaluates the derivative with respect to the spline parameter.
+    /// </summary>
+    TVector EvaluateDerivative(const T parameter) const
+    {
+        if (m_segments.empty())
+            return TVector::Zero;
+
+        T t;
+        const auto& segment = m_segments[Locate(parameter, t)];
+        return segment.EvaluateDerivative(t);
+    }
+
+    /// <summary>
+    ///     Evaluates the second derivative with respect to the spline parameter.
+    /// </summary>
+    TVector EvaluateSecondDerivative(const T parameter) const
+    {
+        if (m_segments.empty())
+            return TVector::Zero;
+
+        T t;
+        const auto& segment = m_segments[Locate(parameter, t)];
+        return segment.EvaluateSecondDerivative(t);
+    }
+
+    /// <summary>
+    ///     Evaluates the positions at an array of spline parameters.
+    ///     Single precision curves are evaluated with SSE2, all of the components of a sample at once
+    ///     using Horner's method on the coefficients padded to 4 floats.
+    /// </summary>
+    /// <param name="parameters">The spline parameters.</param>
+    /// <param name="count">The parameter count.</param>
+    /// <param name="positions">The output positions.</param>
+    void Evaluate(const T* parameters, const size_t count, TVector* positions) const
+    {
+        if (m_segments.empty())
+        {
+            std::fill(positions, positions + count, TVector::Zero);
+            return;
+        }
+
+        EvaluateArray(parameters, count, positions);
+    }
+
+    /// <summary>
+    ///     Builds the arc-length table used by the distance functions.
+    ///     Every segment is sampled uniformly, the length between the samples is approximated by the chord.
+    /// </summary>
+    /// <param name="samplesPerSegment">The sample count per segment.</param>
+    void BuildArcLengthTable(const uint32_t samplesPerSegment = 16)
+    {
+        m_samplesPerSegment = Math::Max(samplesPerSegment, 1u);
+        m_arcLengths.resize(m_segments.size() * m_samplesPerSegment + 1);
+        m_arcLengths[0] = T(0);
+
+        auto length = T(0);
+        auto index = size_t(1);
+
+        for (const auto& segment : m_segments)
+        {
+            auto previous = segment.Evaluate(T(0));
+
+            for (auto i = 1u; i <= m_samplesPerSegment; i++)
+            {
+                const auto position = segment.Evaluate(static_cast<T>(i) / static_cast<T>(m_samplesPerSegment));
+                length += TVector::Distance(previous, position);
+                m_arcLengths[index++] = length;
+                previous = position;
+            }
+        }
+    }
+
+    /// <summary>
+    ///     Returns the spline parameter at the given distance along the curve, requires BuildArcLengthTable.
+    /// </summary>
+    T GetParameterAtDistance(const T distance) const
+    {
+        if (m_arcLengths.size() < 2)
+            return T(0);
+
+        const auto sampleCount = m_arcLengths.size() - 1;
+        const auto clamped = Math::Clamp(distance, T(0), m_arcLengths.back());
+
+        // The last sample at or before the distance
+        const auto found = std::upper_bound(m_arcLengths.begin(), m_arcLengths.end(), clamped);
+        const auto sample = Math::Min(static_cast<size_t>(found - m_arcLengths.begin()), sampleCount) - 1;
+
+        const auto span = m_arcLengths[sample + 1] - m_arcLengths[sample];
+        const auto fraction = span > T(0) ? (clamped - m_arcLengths[sample]) / span : T(0);
+
+        return (static_cast<T>(sample) + fraction) / static_cast<T>(m_samplesPerSegment);
+    }
+
+    /// <summary>
+    ///     Evaluates the position at the given distance along the curve, requires BuildArcLengthTable.
+    /// </summary>
+    TVector EvaluateAtDistance(const T distance) const
+    {
+        return Evaluate(GetParameterAtDistance(distance));
+    }
+
+    /// <summary>
+    ///     Returns the curve length, requires BuildArcLengthTable.
+    /// </summary>
+    T GetLength() const
+    {
+        return m_arcLengths.empty() ? T(0) : m_arcLengths.back();
+    }
+
+    size_t GetSegmentCount() const
+    {
+        return m_segments.size();
+    }
+
+    const Segment& GetSegment(const size_t index) const
+    {
+        return m_segments[index];
+    }
+
+private:
+    // The spline has to have at least one segment, the public functions return early otherwise
+    size_t Locate(const T parameter, T& t) const
+    {
+        const auto lastSegment = m_segments.size() - 1;
+        const auto clamped = Math::Clamp(parameter, T(0), static_cast<T>(m_segments.size()));
+        const auto index = Math::Min(static_cast<size_t>(clamped), lastSegment);
+
+        t = clamped - static_cast<T>(index);
+        return index;
+    }
+
+    void AddSegment(const Segment& segment)
+    {
+        m_segments.push_back(segment);
+
+        // Four padded vectors per segment, in the order a, b, c, d
+        const TVector* coefficients[4] = { &segment.a, &segment.b, &segment.c, &segment.d };
+        for (const auto coefficient : coefficients)
+        {
+            for (auto c = size_t(0); c < 4; c++)
+                m_paddedCoefficients.push_back(c < Dimension ? (*coefficient)[c] : T(0));
+        }
+    }
+
+    template<typename TValue>
+    void EvaluateArray(const TValue* parameters, const size_t count, TVector* positions) const
+    {
+        for (auto i = size_t(0); i < count; i++)
+            positions[i] = Evaluate(parameters[i]);
+    }
+
+    void EvaluateArray(const float* parameters, const size_t count, TVector* positions) const
+    {
+#if SIMD_X86
+        if (m_useSSE2)
+        {
+            EvaluateArraySSE2(parameters, count, positions);
+            return;
+        }
+#endif
+        for (auto i = size_t(0); i < count; i++)
+            positions[i] = Evaluate(parameters[i]);
+    }
+
+#if SIMD_X86
+    SIMD_TARGET_SSE2 void EvaluateArraySSE2(const float* parameters, const size_t count, TVector* positions) const
+    {
+        for (auto i = size_t(0); i < count; i++)
+        {
+            float t;
+            const auto coefficients = m_paddedCoefficients.data() + Locate(parameters[i], t) * 16;
+            const auto parameter = _mm_set1_ps(t);
+
+            auto value = _mm_loadu_ps(coefficients + 12);
+            value = _mm_add_ps(_mm_mul_ps(value, parameter), _mm_loadu_ps(coefficients + 8));
+            value = _mm_add_ps(_mm_mul_ps(value, parameter), _mm_loadu_ps(coefficients + 4));
+            value = _mm_add_ps(_mm_mul_ps(value, parameter), _mm_loadu_ps(coefficients));
+
+            float result[4];
+            _mm_storeu_ps(result, value);
+
+            auto& position = positions[i];
+            for (auto c = size_t(0); c < Dimension; c++)
+                position[c] = result[c];
+        }
+    }
+#endif
+
+private:
+    std::vector<Segment> m_segments;
+    std::vector<T> m_paddedCoefficients;
+    std::vector<T> m_arcLengths;
+    uint32_t m_samplesPerSegment = 0;
+    bool m_useSSE2 = Cpu::GetSimdLevel() >= SimdLevel::SSE2;
+};
@@ -0,0 +1,360 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+
+#include "Config.h"
+#include "Vector3Base.h"
+#include "BoundingBoxBase.h"
+
+/// <summary>
+///     Incremental sweep-and-prune broadphase.
+///     Keeps one sorted endpoint array per axis and re-sorts it with insertion sort on every update,
+///     which is close to O(n) when the objects move only a little between updates (temporal coherence).
+///     Overlapping pairs are tracked incrementally from the endpoint swaps.
+/// </summary>
+template<typename T>
+class SweepAndPruneBase
+{
+public:
+    /// <summary>
+    ///     A pair of overlapping object handles, where a is always lower than b.
+    /// </summary>
+    struct Pair
+    {
+        uint32_t a;
+        uint32_t b;
+    };
+
+private:
+    struct Endpoint
+    {
+        T value;
+        uint32_t data; // (handle << 1) | isMaximum
+    };
+
+public:
+    /// <summary>
+    ///     Adds a new object into the broadphase.
+    ///     The object is inserted and its overlaps are reported by the next Update call.
+    /// </summary>
+    /// <param name="box">The bounds of the object.</param>
+    /// <returns>The handle of the object.</returns>
+    uint32_t Add(const BoundingBoxBase<T>& box)
+    {
+        uint32_t handle;
+        if (!m_freeHandles.empty())
+        {
+            handle = m_freeHandles.back();
+            m_freeHandles.pop_back();
+        }
+        else
+        {
+            handle = static_cast<uint32_t>(m_alive.size());
+            m_alive.push_back(false);
+            m_added.push_back(false);
+            m_activeSlots.push_back(0);
+
+            for (auto axis = 0; axis < 3; axis++)
+            {
+                m_minimum[axis].push_back(T(0));
+                m_maximum[axis].push_back(T(0));
+            }
+        }
+
+        m_alive[handle] = true;
+        m_addedHandles.push_back(handle);
+        SetBounds(handle, box);
+
+        return handle;
+    }
+
+    /// <summary>
+    ///     Removes an object from the broadphase.
+    ///     Its pairs are no longer reported, the endpoints are purged in batch by the next Update call.
+    /// </summary>
+    /// <param name="handle">The handle of the object.</param>
+    void Remove(const uint32_t handle)
+    {
+        if (handle >= m_alive.size() || !m_alive[handle])
+            return;
+
+        m_alive[handle] = false;
+        m_removedHandles.push_back(handle);
+    }
+
+    /// <summary>
+    ///     Sets new bounds of an object.
+    ///     The overlaps are reported after the next Update call.
+    /// </summary>
+    /// <param name="handle">The handle of the object.</param>
+    /// <param name="box">The new bounds of the object.</param>
+    void Move(const uint32_t handle, const BoundingBoxBase<T>& box)
+    {
+        if (handle >= m_alive.size() || !m_alive[handle])
+            return;
+
+        SetBounds(handle, box);
+    }
+
+    /// <summary>
+    ///     Re-sorts the endpoint arrays and updates the overlapping pairs.
+    /// </summary>
+    void Update()
+    {
+        if (!m_removedHandles.empty())
+            PurgeRemoved();
+
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            auto& endpoints = m_endpoints[axis];
+            const auto& minimum = m_minimum[axis];
+            const auto& maximum = m_maximum[axis];
+
+            for (auto& endpoint : endpoints)
+            {
+                const auto handle = endpoint.data >> 1;
+                endpoint.value = (endpoint.data & 1u) ? maximum[handle] : minimum[handle];
+            }
+
+            SortAxis(endpoints, axis);
+        }
+
+        if (!m_addedHandles.empty())
+            InsertAdded();
+    }
+
+    /// <summary>
+    ///     Returns the current overlapping pairs.
+    /// </summary>
+    /// <param name="pairs">The output list of pairs, it is cleared first.</param>
+    void GetPairs(std::vector<Pair>& pairs) const
+    {
+        pairs.clear();
+        pairs.reserve(m_pairs.size());
+
+        for (const auto key : m_pairs)
+        {
+            const auto a = static_cast<uint32_t>(key >> 32);
+            const auto b = static_cast<uint32_t>(key);
+
+            if (m_alive[a] && m_alive[b])
+                pairs.push_back(Pair{ a, b });
+        }
+    }
+
+    /// <summary>
+    ///     Checks if two objects are currently overlapping.
+    /// </summary>
+    bool IsOverlapping(const uint32_t a, const uint32_t b) const
+    {
+        if (a >= m_alive.size() || b >= m_alive.size() || !m_alive[a] || !m_alive[b])
+            return false;
+
+        return m_pairs.find(MakeKey(a, b)) != m_pairs.end();
+    }
+
+    /// <summary>
+    ///     Removes all objects and pairs.
+    /// </summary>
+    void Clear()
+    {
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            m_endpoints[axis].clear();
+            m_minimum[axis].clear();
+            m_maximum[axis].clear();
+        }
+
+        m_alive.clear();
+        m_added.clear();
+        m_activeSlots.clear();
+        m_freeHandles.clear();
+        m_addedHandles.clear();
+        m_removedHandles.clear();
+        m_pairs.clear();
+    }
+
+private:
+    static uint64_t MakeKey(uint32_t a, uint32_t b)
+    {
+        if (a > b)
+            std::swap(a, b);
+
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    static bool IsLess(const Endpoint& a, const Endpoint& b)
+    {
+        // Minimum endpoints go before maximum endpoints of equal value, so touching boxes overlap
+        // the same way as in BoundingBoxBase::Intersects.
+        return a.value < b.value || (a.value == b.value && (a.data & 1u) < (b.data & 1u));
+    }
+
+    void SetBounds(const uint32_t handle, const BoundingBoxBase<T>& box)
+    {
+        const auto minimum = box.Minimum();
+        const auto maximum = box.Maximum();
+
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            m_minimum[axis][handle] = minimum[axis];
+            m_maximum[axis][handle] = maximum[axis];
+        }
+    }
+
+    bool Overlaps(const uint32_t a, const uint32_t b, const int axis) const
+    {
+        return m_minimum[axis][a] <= m_maximum[axis][b] && m_minimum[axis][b] <= m_maximum[axis][a];
+    }
+
+    bool OverlapsOtherAxes(const uint32_t a, const uint32_t b, const int axis) const
+    {
+        return Overlaps(a, b, (axis + 1) % 3) && Overlaps(a, b, (axis + 2) % 3);
+    }
+
+    void PurgeRemoved()
+    {
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            auto& endpoints = m_endpoints[axis];
+
+            auto write = size_t(0);
+            for (auto read = size_t(0); read < endpoints.size(); read++)
+            {
+                if (m_alive[endpoints[read].data >> 1])
+                    endpoints[write++] = endpoints[read];
+            }
+            endpoints.resize(write);
+        }
+
+        for (auto it = m_pairs.begin(); it != m_pairs.end();)
+        {
+            if (!m_alive[static_cast<uint32_t>(*it >> 32)] || !m_alive[static_cast<uint32_t>(*it)])
+                it = m_pairs.erase(it);
+            else
+                ++it;
+        }
+
+        auto write = size_t(0);
+        for (const auto handle : m_addedHandles)
+        {
+            if (m_alive[handle])
+                m_addedHandles[write++] = handle;
+        }
+        m_addedHandles.resize(write);
+
+        // Handles are recycled only once nothing refers to them anymore
+        m_freeHandles.insert(m_freeHandles.end(), m_removedHandles.begin(), m_removedHandles.end());
+        m_removedHandles.clear();
+    }
+
+    void InsertAdded()
+    {
+        // Inserting the new endpoints one by one with insertion sort would move each of them across
+        // the whole array, so they are sorted separately, merged in, and their pairs are found
+        // with a single sweep over the X axis instead.
+        for (const auto handle : m_addedHandles)
+            m_added[handle] = true;
+
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            auto& endpoints = m_endpoints[axis];
+            const auto middle = endpoints.size();
+
+            for (const auto handle : m_addedHandles)
+            {
+                endpoints.push_back(Endpoint{ m_minimum[axis][handle], handle << 1 });
+                endpoints.push_back(Endpoint{ m_maximum[axis][handle], (handle << 1) | 1u });
+            }
+
+            std::sort(endpoints.begin() + middle, endpoints.end(), IsLess);
+            std::inplace_merge(endpoints.begin(), endpoints.begin() + middle, endpoints.end(), IsLess);
+        }
+
+        std::vector<uint32_t> active;
+        for (const auto& endpoint : m_endpoints[0])
+        {
+            const auto handle = endpoint.data >> 1;
+
+            if (endpoint.data & 1u)
+            {
+                // Swap-remove, the slot of every active handle is tracked so no search is needed
+                const auto slot = m_activeSlots[handle];
+                const auto last = active.back();
+                active[slot] = last;
+                m_activeSlots[last] = slot;
+                active.pop_back();
+                continue;
+            }
+
+            for (const auto other : active)
+            {
+                if ((m_added[handle] || m_added[other]) && OverlapsOtherAxes(handle, other, 0))
+                    m_pairs.insert(MakeKey(handle, other));
+            }
+
+            m_activeSlots[handle] = static_cast<uint32_t>(active.size());
+            active.push_back(handle);
+        }
+
+        for (const auto handle : m_addedHandles)
+            m_added[handle] = false;
+
+        m_addedHandles.clear();
+    }
+
+    void SortAxis(std::vector<Endpoint>& endpoints, const int axis)
+    {
+        const auto count = endpoints.size();
+
+        for (auto i = size_t(1); i < count; i++)
+        {
+            const auto current = endpoints[i];
+            const auto handle = current.data >> 1;
+            const auto isMaximum = (current.data & 1u) != 0;
+
+            auto j = i;
+            while (j > 0 && IsLess(current, endpoints[j - 1]))
+            {
+                const auto& other = endpoints[j - 1];
+                const auto otherHandle = other.data >> 1;
+                const auto otherIsMaximum = (other.data & 1u) != 0;
+
+                if (!isMaximum && otherIsMaximum)
+                {
+                    // Minimum moved below other's maximum: the objects start to overlap on this axis
+                    if (OverlapsOtherAxes(handle, otherHandle, axis))
+                        m_pairs.insert(MakeKey(handle, otherHandle));
+                }
+                else if (isMaximum && !otherIsMaximum)
+                {
+                    // Maximum moved below other's minimum: the objects are now separated on this axis
+                    m_pairs.erase(MakeKey(handle, otherHandle));
+                }
+
+                endpoints[j] = other;
+                j--;
+            }
+
+            endpoints[j] = current;
+        }
+    }
+
+private:
+    std::vector<Endpoint> m_endpoints[3];
+    std::vector<T> m_minimum[3];
+    std::vector<T> m_maximum[3];
+
+    std::vector<bool> m_alive;
+    std::vector<bool> m_added;
+    std::vector<uint32_t> m_activeSlots; // The index of every handle in the active list of InsertAdded
+    std::vector<uint32_t> m_freeHandles;
+    std::vector<uint32_t> m_removedHandles;
+    std::vector<uint32_t> m_addedHandles;
+    std::unordered_set<uint64_t> m_pairs;
+};
@@ -0,0 +1,112 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "RayBase.h"
+#include "SimdKernels.h"
+#include "Vector3Base.h"
+
+/// <summary>
+///     Single-precision triangles in structure of arrays layout for raycasting, for example a collision mesh.
+///     Every triangle is stored as its first corner and the edges p1 - p0 and p2 - p0, nine arrays of components,
+///     so the SIMD kernels test four (SSE2) or eight (AVX2) triangles per iteration with plain loads.
+///     The triangle indices in the hits are the order of the Add calls.
+/// </summary>
+class TriangleArray
+{
+public:
+    /// <summary>
+    ///     Adds a triangle.
+    /// </summary>
+    void Add(const Vector3Base<float>& p0, const Vector3Base<float>& p1, const Vector3Base<float>& p2)
+    {
+        const auto edge1 = p1 - p0;
+        const auto edge2 = p2 - p0;
+        const float values[ComponentCount] = { p0.x, p0.y, p0.z, edge1.x, edge1.y, edge1.z, edge2.x, edge2.y, edge2.z };
+
+        for (auto c = 0; c < ComponentCount; c++)
+            m_components[c].push_back(values[c]);
+    }
+
+    /// <summary>
+    ///     Adds indexed triangles (three indices per triangle).
+    /// </summary>
+    /// <param name="positions">The vertex positions.</param>
+    /// <param name="indices">The triangle indices.</param>
+    /// <param name="indexCount">The index count, a multiple of three.</param>
+    template<typename TIndex>
+    void Add(const Vector3Base<float>* positions, const TIndex* indices, const size_t indexCount)
+    {
+        Reserve(GetCount() + indexCount / 3);
+
+        for (auto i = size_t(0); i + 3 <= indexCount; i += 3)
+            Add(positions[indices[i + 0]], positions[indices[i + 1]], positions[indices[i + 2]]);
+    }
+
+    void Reserve(const size_t count)
+    {
+        for (auto& component : m_components)
+            component.reserve(count);
+    }
+
+    void Clear()
+    {
+        for (auto& component : m_components)
+            component.clear();
+    }
+
+    size_t GetCount() const
+    {
+        return m_components[0].size();
+    }
+
+public:
+    /// <summary>
+    ///     Finds the closest triangle hit by a ray, both faces are hit.
+    /// </summary>
+    /// <param name="ray">The ray.</param>
+    /// <param name="hit">Receives the closest hit, its triangle is RayHit::InvalidTriangle when nothing was hit.</param>
+    /// <param name="maxDistance">Only the hits closer than this distance are considered.</param>
+    /// <returns>True when a triangle was hit.</returns>
+    bool Raycast(const RayBase<float>& ray, RayHit& hit, const float maxDistance = std::numeric_limits<float>::max()) const
+    {
+        hit = RayHit();
+        hit.distance = maxDistance;
+
+        const float* components[ComponentCount];
+        GetComponents(components);
+
+        return SimdKernels::IntersectTriangles(ray, components, GetCount(), hit);
+    }
+
+    /// <summary>
+    ///     Finds the closest triangles hit by the eight rays of a packet, see RayPacket.
+    ///     Every lane only considers the hits closer than its current distance, so a packet can be cast against
+    ///     several arrays in a row, the triangle index of a lane then refers to the array it was last hit by.
+    /// </summary>
+    void Raycast(RayPacket& packet) const
+    {
+        const float* components[ComponentCount];
+        GetComponents(components);
+
+        SimdKernels::IntersectTriangles(packet, components, GetCount());
+    }
+
+private:
+    static const int ComponentCount = 9;
+
+    void GetComponents(const float* (&components)[ComponentCount]) const
+    {
+        for (auto c = 0; c < ComponentCount; c++)
+            components[c] = m_components[c].data();
+    }
+
+private:
+    std::vector<float> m_components[ComponentCount];
+};
@@ -554,3 +554,15 @@ Vector2Base<T>& Vector2Base<T>::operator=(const Vector2Base<T>& other)
     components[1] = other[1];
     return *this;
 }
+
+namespace std
+{
+    template<typename T>
+    struct hash<Vector2Base<T>>
+    {
+        size_t operator()(const Vector2Base<T>& vector) const
+        {
+            return vector.GetHash();
+        }
+    };
+}
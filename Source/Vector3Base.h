@@ -76,6 +76,10 @@ public:
     static Vector3Base<T> Transform(const Vector3Base<T>& a, const Quaternion& rotation);
     static Vector3Base<T> Transform(const Vector3Base<T>& a, const MatrixBase<T, 4, 4>& matrix);
 
+    static void TransformArray(const Vector3Base<T>* source, const Quaternion& rotation, Vector3Base<T>* destination, size_t count);
+    static void TransformArray(const Vector3Base<T>* source, const MatrixBase<T, 4, 4>& matrix, Vector3Base<T>* destination, size_t count);
+    static void NormalizeArray(const Vector3Base<T>* source, Vector3Base<T>* destination, size_t count);
+
     static T Dot(const Vector3Base<T>& a, const Vector3Base<T>& b);
     static T Length(const Vector3Base<T>& a);
     static T LengthSquared(const Vector3Base<T>& a);
@@ -290,18 +294,18 @@ Vector3Base<T> Vector3Base<T>::Cross(const Vector3Base<T>& a, const Vector3Base<
 template <typename T>
 Vector3Base<T> Vector3Base<T>::Transform(const Vector3Base<T>& a, const Quaternion& rotation)
 {
-    const auto x = T(rotation.X + rotation.X);
-    const auto y = T(rotation.Y + rotation.Y);
-    const auto z = T(rotation.Z + rotation.Z);
-    const auto wx = T(rotation.W * x);
-    const auto wy = T(rotation.W * y);
-    const auto wz = T(rotation.W * z);
-    const auto xx = T(rotation.X * x);
-    const auto xy = T(rotation.X * y);
-    const auto xz = T(rotation.X * z);
-    const auto yy = T(rotation.Y * y);
-    const auto yz = T(rotation.Y * z);
-    const auto zz = T(rotation.Z * z);
+    const auto x = T(rotation.x + rotation.x);
+    const auto y = T(rotation.y + rotation.y);
+    const auto z = T(rotation.z + rotation.z);
+    const auto wx = T(rotation.w * x);
+    const auto wy = T(rotation.w * y);
+    const auto wz = T(rotation.w * z);
+    const auto xx = T(rotation.x * x);
+    const auto xy = T(rotation.x * y);
+    const auto xz = T(rotation.x * z);
+    const auto yy = T(rotation.y * y);
+    const auto yz = T(rotation.y * z);
+    const auto zz = T(rotation.z * z);
 
     return Vector3Base<T>(
         ((a.x * ((T(1) - yy) - zz)) + (a.y * (xy - wz))) + (a.z * (xz + wy)),
@@ -319,6 +323,65 @@ Vector3Base<T> Vector3Base<T>::Transform(const Vector3Base<T>& a, const MatrixBa
         (a.x * matrix.m13) + (a.y * matrix.m23) + (a.z * matrix.m33) + matrix.m43);
 }
 
+template <typename T>
+void Vector3Base<T>::TransformArray(const Vector3Base<T>* source, const Quaternion& rotation, Vector3Base<T>* destination, const size_t count)
+{
+    // Same as Transform(a, rotation), with the rotation matrix terms hoisted out of the loop
+    const auto x = T(rotation.x + rotation.x);
+    const auto y = T(rotation.y + rotation.y);
+    const auto z = T(rotation.z + rotation.z);
+    const auto wx = T(rotation.w * x);
+    const auto wy = T(rotation.w * y);
+    const auto wz = T(rotation.w * z);
+    const auto xx = T(rotation.x * x);
+    const auto xy = T(rotation.x * y);
+    const auto xz = T(rotation.x * z);
+    const auto yy = T(rotation.y * y);
+    const auto yz = T(rotation.y * z);
+    const auto zz = T(rotation.z * z);
+
+    const auto m11 = (T(1) - yy) - zz;
+    const auto m21 = xy - wz;
+    const auto m31 = xz + wy;
+    const auto m12 = xy + wz;
+    const auto m22 = (T(1) - xx) - zz;
+    const auto m32 = yz - wx;
+    const auto m13 = xz - wy;
+    const auto m23 = yz + wx;
+    const auto m33 = (T(1) - xx) - yy;
+
+    for (auto i = size_t(0); i < count; i++)
+    {
+        const auto a = source[i];
+        destination[i] = Vector3Base<T>(
+            a.x * m11 + a.y * m21 + a.z * m31,
+            a.x * m12 + a.y * m22 + a.z * m32,
+            a.x * m13 + a.y * m23 + a.z * m33);
+    }
+}
+
+template <typename T>
+void Vector3Base<T>::TransformArray(const Vector3Base<T>* source, const MatrixBase<T, 4, 4>& matrix, Vector3Base<T>* destination, const size_t count)
+{
+    const auto m = matrix;
+
+    for (auto i = size_t(0); i < count; i++)
+    {
+        const auto a = source[i];
+        destination[i] = Vector3Base<T>(
+            (a.x * m.m11) + (a.y * m.m21) + (a.z * m.m31) + m.m41,
+            (a.x * m.m12) + (a.y * m.m22) + (a.z * m.m32) + m.m42,
+            (a.x * m.m13) + (a.y * m.m23) + (a.z * m.m33) + m.m43);
+    }
+}
+
+template <typename T>
+void Vector3Base<T>::NormalizeArray(const Vector3Base<T>* source, Vector3Base<T>* destination, const size_t count)
+{
+    for (auto i = size_t(0); i < count; i++)
+        destination[i] = Normalize(source[i]);
+}
+
 template <typename T>
 T Vector3Base<T>::Dot(const Vector3Base<T>& a, const Vector3Base<T>& b)
 {
@@ -610,3 +673,15 @@ Vector3Base<T>& Vector3Base<T>::operator=(const Vector3Base<T>& other)
     components[2] = other[2];
     return *this;
 }
+
+namespace std
+{
+    template<typename T>
+    struct hash<Vector3Base<T>>
+    {
+        size_t operator()(const Vector3Base<T>& vector) const
+        {
+            return vector.GetHash();
+        }
+    };
+}
@@ -291,18 +291,18 @@ Vector4Base<T> Vector4Base<T>::Lerp(const Vector4Base<T>& from, const Vector4Bas
 template <typename T>
 Vector4Base<T> Vector4Base<T>::Transform(const Vector4Base<T>& a, const Quaternion& rotation)
 {
-    const auto x = T(rotation.X + rotation.X);
-    const auto y = T(rotation.Y + rotation.Y);
-    const auto z = T(rotation.Z + rotation.Z);
-    const auto wx = T(rotation.W * x);
-    const auto wy = T(rotation.W * y);
-    const auto wz = T(rotation.W * z);
-    const auto xx = T(rotation.X * x);
-    const auto xy = T(rotation.X * y);
-    const auto xz = T(rotation.X * z);
-    const auto yy = T(rotation.Y * y);
-    const auto yz = T(rotation.Y * z);
-    const auto zz = T(rotation.Z * z);
+    const auto x = T(rotation.x + rotation.x);
+    const auto y = T(rotation.y + rotation.y);
+    const auto z = T(rotation.z + rotation.z);
+    const auto wx = T(rotation.w * x);
+    const auto wy = T(rotation.w * y);
+    const auto wz = T(rotation.w * z);
+    const auto xx = T(rotation.x * x);
+    const auto xy = T(rotation.x * y);
+    const auto xz = T(rotation.x * z);
+    const auto yy = T(rotation.y * y);
+    const auto yz = T(rotation.y * z);
+    const auto zz = T(rotation.z * z);
 
     return Vector4Base<T>(
         ((a.x * ((T(1) - yy) - zz)) + (a.y * (xy - wz))) + (a.z * (xz + wy)),
@@ -638,3 +638,15 @@ Vector4Base<T>& Vector4Base<T>::operator=(const Vector4Base<T>& other)
     components[3] = other[3];
     return *this;
 }
+
+namespace std
+{
+    template<typename T>
+    struct hash<Vector4Base<T>>
+    {
+        size_t operator()(const Vector4Base<T>& vector) const
+        {
+            return vector.GetHash();
+        }
+    };
+}
@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
 #include "Config.h"
 #include "Math.h"
 
@@ -162,6 +166,33 @@ public:
         return components - 1;
     }
 
+public:
+    /* Hashing */
+
+    /// <summary>
+    ///     Hashes the component bits, consistent with operator== (positive and negative zero hash the same).
+    ///     Used by the std::hash specializations of the vector types.
+    /// </summary>
+    size_t GetHash() const
+    {
+        static_assert(sizeof(T) <= sizeof(uint64_t), "The components have to fit 64 bits");
+
+        auto hash = uint64_t(0);
+        for (auto i = size_t(0); i < S; i++)
+        {
+            // Adding zero turns -0 into +0 and leaves the other values unchanged
+            const auto value = static_cast<T>(components[i] + T(0));
+
+            auto bits = uint64_t(0);
+            std::memcpy(&bits, &value, sizeof(T));
+
+            hash = (hash ^ bits) * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 29;
+        }
+
+        return static_cast<size_t>(hash);
+    }
+
 public:
     /* Static constant members */
     static const size_t Dimension = S;
@@ -11,8 +11,31 @@
 #include "Matrix4x4Base.h"
 #include "PlaneBase.h"
 #include "BoundingBoxBase.h"
+#include "RayBase.h"
+#include "OrientedBoundingBoxBase.h"
 #include "BoundingFrustumBase.h"
 #include "ColorBase.h"
+#include "Skinning.h"
+#include "AnimationTrack.h"
+#include "AnimationCompression.h"
+#include "Spline.h"
+#include "SweepAndPruneBase.h"
+#include "SpatialHashGridBase.h"
+#include "LooseOctreeBase.h"
+#include "ShadowCascades.h"
+#include "CameraBase.h"
+#include "JobSystem.h"
+#include "Parallel.h"
+#include "Cpu.h"
+#include "SimdKernels.h"
+#include "OcclusionBufferBase.h"
+#include "ArrayArchive.h"
+#include "MappedFile.h"
+#include "PointCloudStream.h"
+#include "VertexWelderBase.h"
+#include "Mesh.h"
+#include "TriangleArray.h"
+#include "VectorText.h"
 
 using Vector2f = Vector2Base<float>;
 using Vector3f = Vector3Base<float>;
@@ -29,13 +52,39 @@ using Matrix = Matrix4x4f; // Maybe we want to also make the matrix double preci
 
 using PlaneF = PlaneBase<float>;
 using BoundingBoxF = BoundingBoxBase<float>;
+using OrientedBoundingBoxF = OrientedBoundingBoxBase<float>;
 using BoundingFrustumF = BoundingFrustumBase<float>;
 using BoundingSphereF = BoundingSphereBase<float>;
+using RayF = RayBase<float>;
+using SweepAndPruneF = SweepAndPruneBase<float>;
+using SpatialHashGridF = SpatialHashGridBase<float>;
+using VertexWelderF = VertexWelderBase<float>;
+using LooseOctreeF = LooseOctreeBase<float>;
+using ShadowCascadeF = ShadowCascadeBase<float>;
+using CameraF = CameraBase<float>;
+using OcclusionBufferF = OcclusionBufferBase<float>;
+using PointCloudStreamF = PointCloudStreamBase<float>;
+using Spline2F = Spline<Vector2f>;
+using Spline3F = Spline<Vector3f>;
+using Spline4F = Spline<Vector4f>;
 
 using PlaneD = PlaneBase<double>;
 using BoundingBoxD = BoundingBoxBase<double>;
+using OrientedBoundingBoxD = OrientedBoundingBoxBase<double>;
 using BoundingFrustumD = BoundingFrustumBase<double>;
 using BoundingSphereD = BoundingSphereBase<double>;
+using RayD = RayBase<double>;
+using SweepAndPruneD = SweepAndPruneBase<double>;
+using SpatialHashGridD = SpatialHashGridBase<double>;
+using VertexWelderD = VertexWelderBase<double>;
+using LooseOctreeD = LooseOctreeBase<double>;
+using ShadowCascadeD = ShadowCascadeBase<double>;
+using CameraD = CameraBase<double>;
+using OcclusionBufferD = OcclusionBufferBase<double>;
+using PointCloudStreamD = PointCloudStreamBase<double>;
+using Spline2D = Spline<Vector2d>;
+using Spline3D = Spline<Vector3d>;
+using Spline4D = Spline<Vector4d>;
 
 #ifndef MATH_DEFAULT_DOUBLE_PRECISION
 using Vector2 = Vector2f;
@@ -44,8 +93,21 @@ using Vector4 = Vector4f;
 
 using Plane = PlaneF;
 using BoundingBox = BoundingBoxF;
+using OrientedBoundingBox = OrientedBoundingBoxF;
 using BoundingFrustum = BoundingFrustumF;
 using BoundingSphere = BoundingSphereF;
+using Ray = RayF;
+using SweepAndPrune = SweepAndPruneF;
+using SpatialHashGrid = SpatialHashGridF;
+using VertexWelder = VertexWelderF;
+using LooseOctree = LooseOctreeF;
+using ShadowCascade = ShadowCascadeF;
+using Camera = CameraF;
+using OcclusionBuffer = OcclusionBufferF;
+using PointCloudStream = PointCloudStreamF;
+using Spline2 = Spline2F;
+using Spline3 = Spline3F;
+using Spline4 = Spline4F;
 #else
 using Vector2 = Vector2d;
 using Vector3 = Vector3d;
@@ -53,10 +115,28 @@ using Vector4 = Vector4d;
 
 using Plane = PlaneD;
 using BoundingBox = BoundingBoxD;
+using OrientedBoundingBox = OrientedBoundingBoxD;
 using BoundingFrustum = BoundingFrustumD;
 using BoundingSphere = BoundingSphereD;
+using Ray = RayD;
+using SweepAndPrune = SweepAndPruneD;
+using SpatialHashGrid = SpatialHashGridD;
+using VertexWelder = VertexWelderD;
+using LooseOctree = LooseOctreeD;
+using ShadowCascade = ShadowCascadeD;
+using Camera = CameraD;
+using OcclusionBuffer = OcclusionBufferD;
+using PointCloudStream = PointCloudStreamD;
+using Spline2 = Spline2D;
+using Spline3 = Spline3D;
+using Spline4 = Spline4D;
 #endif
 
 using Color = ColorBase<float>;
 using Color4 = Color;
 using Color32 = Color;
+
+using Vector3Track = AnimationTrack<Vector3f>;
+using QuaternionTrack = AnimationTrack<Quaternion>;
+using Vector3TrackSampler = AnimationSampler<Vector3f>;
+using QuaternionTrackSampler = AnimationSampler<Quaternion>;
@@ -0,0 +1,450 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#include "Config.h"
+#include "Cpu.h"
+#include "Parallel.h"
+#include "SimdKernels.h"
+#include "Vector2Base.h"
+#include "Vector3Base.h"
+#include "Vector4Base.h"
+#include "Matrix4x4Base.h"
+
+// Floating-point std::from_chars/std::to_chars are missing from older standard libraries (libstdc++ < 11),
+// strtod/snprintf are used instead, which are slower and depend on the C locale.
+#if defined(__cpp_lib_to_chars)
+#define HAS_FLOAT_CHARCONV              ENABLE
+#else
+#define HAS_FLOAT_CHARCONV              DISABLE
+#endif
+
+/// <summary>
+///     Describes which lines and columns of a text buffer hold the elements.
+/// </summary>
+struct VectorTextLayout
+{
+    /// <summary>
+    ///     When set, only the lines starting with this keyword are parsed (e.g. "v" or "vn" for OBJ),
+    ///     the other lines are skipped. When not set, every line which is not blank or a '#' comment is an element.
+    /// </summary>
+    const char* keyword = nullptr;
+
+    /// <summary>
+    ///     The number of values skipped before the first component of an element (e.g. an id column).
+    /// </summary>
+    size_t skipColumns = 0;
+
+    /// <summary>
+    ///     The number of lines skipped at the beginning of the buffer (e.g. a CSV header).
+    /// </summary>
+    size_t skipLines = 0;
+};
+
+/// <summary>
+///     Bulk ASCII parsing and formatting of Vector2Base, Vector3Base, Vector4Base and Matrix4x4Base arrays,
+///     one element per line (OBJ, PLY and CSV data). Values are separated by any run of spaces, tabs, commas
+///     or semicolons, the values after the last component of an element are ignored.
+///     Matrices are written as 16 values in the m11, m12, ..., m44 order.
+///     The parallel variants split the buffer at line boundaries and give exactly the same result.
+/// </summary>
+class VectorText
+{
+public:
+    /// <summary>
+    ///     The number of text bytes parsed (or elements formatted) by a single job of the parallel variants.
+    /// </summary>
+    static const size_t ParallelChunkBytes = 256 * 1024;
+    static const size_t ParallelChunkElements = 16 * 1024;
+
+public:
+    /// <summary>
+    ///     Parses the elements of a text buffer and appends them to an array.
+    /// </summary>
+    /// <param name="text">The text buffer, it does not have to be null-terminated.</param>
+    /// <param name="length">The length of the text buffer in bytes.</param>
+    /// <param name="elements">The array the elements are appended to.</param>
+    /// <param name="layout">The text layout.</param>
+    /// <param name="errorLine">Receives the 1-based number of the first malformed line, may be null.</param>
+    /// <returns>False when a line has fewer values than the element has components, or a value is malformed,
+    /// the array is left unchanged in that case.</returns>
+    template<typename TElement>
+    static bool Parse(const char* text, const size_t length, std::vector<TElement>& elements,
+        const VectorTextLayout& layout = VectorTextLayout(), size_t* errorLine = nullptr)
+    {
+        const auto end = text + length;
+        const auto sse2 = UseSSE2();
+        const auto begin = SkipLines(text, end, layout.skipLines, sse2);
+
+        const auto previousCount = elements.size();
+        auto lineCount = size_t(0);
+
+        if (!ParseLines(begin, end, layout, sse2, elements, lineCount))
+        {
+            elements.resize(previousCount);
+
+            if (errorLine != nullptr)
+                *errorLine = layout.skipLines + lineCount + 1;
+            return false;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    ///     Multithreaded Parse, the buffer is split into ParallelChunkBytes pieces at line boundaries.
+    /// </summary>
+    template<typename TElement>
+    static bool ParseParallel(const char* text, const size_t length, std::vector<TElement>& elements,
+        const VectorTextLayout& layout = VectorTextLayout(), size_t* errorLine = nullptr)
+    {
+        const auto end = text + length;
+        const auto sse2 = UseSSE2();
+        const auto begin = SkipLines(text, end, layout.skipLines, sse2);
+
+        // Every piece starts right after a new line, so each line belongs to exactly one piece
+        std::vector<const char*> pieces(1, begin);
+        while (static_cast<size_t>(end - pieces.back()) > ParallelChunkBytes)
+        {
+            const auto lineEnd = FindLineEnd(pieces.back() + ParallelChunkBytes, end, sse2);
+            if (lineEnd == end)
+                break;
+
+            pieces.push_back(lineEnd + 1);
+        }
+        pieces.push_back(end);
+
+        const auto pieceCount = pieces.size() - 1;
+        if (pieceCount == 1)
+            return Parse(text, length, elements, layout, errorLine);
+
+        std::vector<std::vector<TElement>> pieceElements(pieceCount);
+        std::vector<size_t> pieceLines(pieceCount, 0);
+        std::vector<uint8_t> pieceResults(pieceCount, 0);
+
+        Parallel::For(pieceCount, 1, [&](const size_t first, const size_t last)
+        {
+            for (auto i = first; i < last; i++)
+            {
+                pieceElements[i].reserve(static_cast<size_t>(pieces[i + 1] - pieces[i]) / (sizeof(TElement) * 2));
+                pieceResults[i] = ParseLines(pieces[i], pieces[i + 1], layout, sse2, pieceElements[i], pieceLines[i]);
+            }
+        });
+
+        auto totalCount = size_t(0);
+        auto lineCount = layout.skipLines;
+
+        for (auto i = size_t(0); i < pieceCount; i++)
+        {
+            if (!pieceResults[i])
+            {
+                if (errorLine != nullptr)
+                    *errorLine = lineCount + pieceLines[i] + 1;
+                return false;
+            }
+
+            totalCount += pieceElements[i].size();
+            lineCount += pieceLines[i];
+        }
+
+        elements.reserve(elements.size() + totalCount);
+        for (const auto& piece : pieceElements)
+            elements.insert(elements.end(), piece.begin(), piece.end());
+
+        return true;
+    }
+
+    /// <summary>
+    ///     Formats elements, one per line, and appends them to a string.
+    ///     Floating-point values use the shortest representation which parses back to the same value.
+    /// </summary>
+    /// <param name="elements">The elements.</param>
+    /// <param name="count">The element count.</param>
+    /// <param name="text">The string the lines are appended to.</param>
+    /// <param name="keyword">Optional keyword written at the beginning of every line (e.g. "v").</param>
+    /// <param name="separator">The value separator.</param>
+    template<typename TElement>
+    static void Format(const TElement* elements, const size_t count, std::string& text,
+        const char* keyword = nullptr, const char separator = ' ')
+    {
+        typedef typename TElement::value_type T;
+        const auto componentCount = GetComponentCount<TElement>();
+        const auto keywordLength = keyword != nullptr ? std::char_traits<char>::length(keyword) : size_t(0);
+
+        // Lines are formatted into a local buffer which is appended in blocks
+        const auto maximumLineLength = keywordLength + 1 + componentCount * (MaxValueLength + 1);
+        std::vector<char> buffer(Math::Max(size_t(16 * 1024), maximumLineLength));
+
+        auto cursor = buffer.data();
+        const auto bufferEnd = buffer.data() + buffer.size();
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            if (static_cast<size_t>(bufferEnd - cursor) < maximumLineLength)
+            {
+                text.append(buffer.data(), cursor);
+                cursor = buffer.data();
+            }
+
+            if (keywordLength > 0)
+            {
+                std::char_traits<char>::copy(cursor, keyword, keywordLength);
+                cursor += keywordLength;
+                *cursor++ = separator;
+            }
+
+            const auto& element = elements[i];
+            for (auto j = size_t(0); j < componentCount; j++)
+            {
+                if (j > 0)
+                    *cursor++ = separator;
+
+                cursor = ToChars(cursor, cursor + MaxValueLength, static_cast<T>(element[j]));
+            }
+
+            *cursor++ = '\n';
+        }
+
+        text.append(buffer.data(), cursor);
+    }
+
+    /// <summary>
+    ///     Multithreaded Format, every ParallelChunkElements elements are formatted into a separate string.
+    /// </summary>
+    template<typename TElement>
+    static void FormatParallel(const TElement* elements, const size_t count, std::string& text,
+        const char* keyword = nullptr, const char separator = ' ')
+    {
+        const auto chunkCount = (count + ParallelChunkElements - 1) / ParallelChunkElements;
+        if (chunkCount <= 1)
+        {
+            Format(elements, count, text, keyword, separator);
+            return;
+        }
+
+        std::vector<std::string> chunkTexts(chunkCount);
+        Parallel::For(count, ParallelChunkElements, [&](const size_t begin, const size_t end)
+        {
+            Format(elements + begin, end - begin, chunkTexts[begin / ParallelChunkElements], keyword, separator);
+        });
+
+        auto totalLength = text.size();
+        for (const auto& chunkText : chunkTexts)
+            totalLength += chunkText.size();
+
+        text.reserve(totalLength);
+        for (const auto& chunkText : chunkTexts)
+            text += chunkText;
+    }
+
+private:
+    /// <summary>
+    ///     The maximum length of a formatted value, the shortest round-trip double takes at most 24 characters.
+    /// </summary>
+    static const size_t MaxValueLength = 32;
+
+    template<typename TElement>
+    static constexpr size_t GetComponentCount()
+    {
+        typedef typename TElement::value_type T;
+        static_assert(std::is_arithmetic<T>::value, "The element components have to be arithmetic");
+        static_assert(sizeof(TElement) % sizeof(T) == 0, "The element has to consist of its components only");
+
+        return sizeof(TElement) / sizeof(T);
+    }
+
+    static bool IsSeparator(const char character)
+    {
+        return character == ' ' || character == '\t' || character == ',' || character == ';' || character == '\r';
+    }
+
+    static const char* SkipSeparators(const char* text, const char* end)
+    {
+        while (text < end && IsSeparator(*text))
+            text++;
+        return text;
+    }
+
+    static const char* SkipValue(const char* text, const char* end)
+    {
+        while (text < end && !IsSeparator(*text))
+            text++;
+        return text;
+    }
+
+    static bool UseSSE2()
+    {
+#if SIMD_X86
+        return Cpu::GetSimdLevel() >= SimdLevel::SSE2;
+#else
+        return false;
+#endif
+    }
+
+#if SIMD_X86
+    SIMD_TARGET_SSE2 static const char* FindLineEndSSE2(const char* text, const char* end)
+    {
+        const auto newLine = _mm_set1_epi8('\n');
+
+        // Skip 16 characters at a time until the block with the new line is found
+        for (; end - text >= 16; text += 16)
+        {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, newLine)) != 0)
+                break;
+        }
+
+        while (text < end && *text != '\n')
+            text++;
+        return text;
+    }
+#endif
+
+    /// <summary>
+    ///     Returns the position of the next new line character, or end when there is none.
+    /// </summary>
+    static const char* FindLineEnd(const char* text, const char* end, const bool sse2)
+    {
+#if SIMD_X86
+        if (sse2)
+            return FindLineEndSSE2(text, end);
+#endif
+        while (text < end && *text != '\n')
+            text++;
+        return text;
+    }
+
+    static const char* SkipLines(const char* text, const char* end, const size_t lineCount, const bool sse2)
+    {
+        for (auto i = size_t(0); i < lineCount && text < end; i++)
+        {
+            text = FindLineEnd(text, end, sse2);
+            if (text < end)
+                text++;
+        }
+
+        return text;
+    }
+
+    /// <summary>
+    ///     Parses the lines of [begin, end), lineCount receives the number of lines processed,
+    ///     or the index of the malformed line on failure.
+    /// </summary>
+    template<typename TElement>
+    static bool ParseLines(const char* begin, const char* end, const VectorTextLayout& layout, const bool sse2,
+        std::vector<TElement>& elements, size_t& lineCount)
+    {
+        const auto componentCount = GetComponentCount<TElement>();
+        const auto keywordLength = layout.keyword != nullptr ? std::char_traits<char>::length(layout.keyword) : size_t(0);
+
+        lineCount = 0;
+
+        for (auto line = begin; line < end; line++, lineCount++)
+        {
+            const auto lineEnd = FindLineEnd(line, end, sse2);
+            auto cursor = SkipSeparators(line, lineEnd);
+            line = lineEnd;
+
+            if (cursor == lineEnd)
+                continue;
+
+            if (keywordLength > 0)
+            {
+                const auto keywordEnd = SkipValue(cursor, lineEnd);
+                if (static_cast<size_t>(keywordEnd - cursor) != keywordLength ||
+                    std::char_traits<char>::compare(cursor, layout.keyword, keywordLength) != 0)
+                    continue;
+
+                cursor = keywordEnd;
+            }
+            else if (*cursor == '#')
+                continue;
+
+            for (auto i = size_t(0); i < layout.skipColumns; i++)
+                cursor = SkipValue(SkipSeparators(cursor, lineEnd), lineEnd);
+
+            TElement element;
+            for (auto i = size_t(0); i < componentCount; i++)
+            {
+                cursor = SkipSeparators(cursor, lineEnd);
+                cursor = FromChars(cursor, lineEnd, element[i]);
+
+                // The value has to end at a separator, "1.5x" is malformed rather than 1.5
+                if (cursor == nullptr || (cursor < lineEnd && !IsSeparator(*cursor)))
+                    return false;
+            }
+
+            elements.push_back(element);
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    ///     Parses a single value, returns the position after it or null when there is no valid value.
+    /// </summary>
+    template<typename T>
+    static const char* FromChars(const char* text, const char* end, T& value)
+    {
+        // from_chars does not accept the leading plus sign, which is valid in all of the supported formats
+        if (text < end && *text == '+')
+            text++;
+
+        if (text == end)
+            return nullptr;
+
+#if HAS_FLOAT_CHARCONV
+        const auto result = std::from_chars(text, end, value);
+        return result.ec == std::errc() ? result.ptr : nullptr;
+#else
+        char buffer[MaxValueLength * 2];
+        const auto length = Math::Min(static_cast<size_t>(SkipValue(text, end) - text), sizeof(buffer) - 1);
+        std::char_traits<char>::copy(buffer, text, length);
+        buffer[length] = '\0';
+
+        char* bufferEnd = nullptr;
+        if (std::is_floating_point<T>::value)
+            value = static_cast<T>(std::strtod(buffer, &bufferEnd));
+        else if (std::is_signed<T>::value)
+            value = static_cast<T>(std::strtoll(buffer, &bufferEnd, 10));
+        else
+            value = static_cast<T>(std::strtoull(buffer, &bufferEnd, 10));
+
+        return bufferEnd != buffer ? text + (bufferEnd - buffer) : nullptr;
+#endif
+    }
+
+    /// <summary>
+    ///     Formats a single value into [text, end), returns the position after it.
+    /// </summary>
+    template<typename T>
+    static char* ToChars(char* text, char* end, const T value)
+    {
+#if HAS_FLOAT_CHARCONV
+        return std::to_chars(text, end, value).ptr;
+#else
+        int length;
+        if (std::is_floating_point<T>::value)
+            length = std::snprintf(text, end - text, sizeof(T) > sizeof(float) ? "%.17g" : "%.9g", static_cast<double>(value));
+        else if (std::is_signed<T>::value)
+            length = std::snprintf(text, end - text, "%lld", static_cast<long long>(value));
+        else
+            length = std::snprintf(text, end - text, "%llu", static_cast<unsigned long long>(value));
+
+        return text + Math::Max(length, 0);
+#endif
+    }
+};
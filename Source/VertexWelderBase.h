@@ -0,0 +1,286 @@
+// VectorMath (c) 2018-2022 Damian 'Erdroy' Korczowski
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Config.h"
+#include "Math.h"
+#include "Cpu.h"
+#include "Vector3Base.h"
+
+/// <summary>
+///     Epsilon-aware vertex welding in linear time.
+///     Every vertex is merged into the nearest earlier unique vertex within epsilon, otherwise it becomes a new
+///     unique vertex. Unique vertices are linked into every quantized cell (eight epsilon in size) their epsilon box
+///     overlaps, so a vertex only looks up its own cell. Cells live in an open-addressing table and link their
+///     unique vertices through a flat node array, so there is no per-entry allocation.
+///     With zero epsilon only bitwise equal positions (as compared by operator==) are merged.
+/// </summary>
+template<typename T>
+class VertexWelderBase
+{
+public:
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+public:
+    /// <summary>
+    ///     Constructs a welder.
+    /// </summary>
+    /// <param name="epsilon">The maximum distance between two merged vertices.</param>
+    explicit VertexWelderBase(const T epsilon = T(0))
+    {
+        SetEpsilon(epsilon);
+    }
+
+public:
+    /// <summary>
+    ///     Sets the maximum distance between two merged vertices.
+    /// </summary>
+    void SetEpsilon(const T epsilon)
+    {
+        m_epsilon = Math::Max(epsilon, T(0));
+
+        // With cells eight times epsilon, the epsilon box of a unique vertex overlaps about two of them (1.25^3)
+        m_inverseCellSize = m_epsilon > T(0) ? T(1) / (m_epsilon * T(8)) : T(0);
+    }
+
+    /// <summary>
+    ///     Welds an array of positions.
+    /// </summary>
+    /// <param name="positions">The vertex positions.</param>
+    /// <param name="count">The vertex count, has to be lower than InvalidIndex.</param>
+    /// <param name="remap">Receives the index of the unique vertex of every vertex, has to hold count elements.</param>
+    /// <returns>The number of unique vertices.</returns>
+    size_t Weld(const Vector3Base<T>* positions, const size_t count, uint32_t* remap)
+    {
+        Reset(count);
+
+        // The keys are computed PrefetchDistance vertices ahead, so their slots are already cached when needed
+        uint32_t keys[PrefetchDistance];
+        for (auto i = size_t(0); i < PrefetchDistance && i < count; i++)
+            keys[i] = GetKey(positions[i]);
+
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto& position = positions[i];
+            const auto key = keys[i % PrefetchDistance];
+
+            if (i + PrefetchDistance < count)
+            {
+                const auto nextKey = GetKey(positions[i + PrefetchDistance]);
+                keys[i % PrefetchDistance] = nextKey;
+                Prefetch(&m_slots[nextKey & (m_slots.size() - 1)]);
+            }
+
+            // Every unique vertex is linked into all of the cells its epsilon box overlaps,
+            // so only the cell of the vertex itself has to be searched
+            auto match = InvalidIndex;
+            auto bestDistance = m_epsilon * m_epsilon;
+
+            for (auto node = m_slots[FindSlot(key)].head; node != InvalidIndex; node = m_nodes[node].next)
+            {
+                const auto& candidate = m_nodes[node];
+                const auto distance = Vector3Base<T>::DistanceSquared(candidate.position, position);
+
+                // Ties go to the earliest unique vertex, so the result does not depend on the list order
+                if (distance < bestDistance || (distance == bestDistance && candidate.unique < match))
+                {
+                    bestDistance = distance;
+                    match = candidate.unique;
+                }
+            }
+
+            if (match == InvalidIndex)
+            {
+                match = static_cast<uint32_t>(m_uniqueIndices.size());
+                m_uniqueIndices.push_back(static_cast<uint32_t>(i));
+
+                if (m_epsilon > T(0))
+                {
+                    const auto minimum = GetCell(position - Vector3Base<T>(m_epsilon));
+                    const auto maximum = GetCell(position + Vector3Base<T>(m_epsilon));
+
+                    for (auto z = minimum[2]; z <= maximum[2]; z++)
+                    for (auto y = minimum[1]; y <= maximum[1]; y++)
+                    for (auto x = minimum[0]; x <= maximum[0]; x++)
+                        Insert(GetCellKey(x, y, z), position, match);
+                }
+                else
+                    Insert(key, position, match);
+            }
+
+            remap[i] = match;
+        }
+
+        return m_uniqueIndices.size();
+    }
+
+    /// <summary>
+    ///     Welds an array of positions and replaces it with the unique positions.
+    /// </summary>
+    /// <param name="positions">The vertex positions.</param>
+    /// <param name="remap">Receives the index of the unique vertex of every vertex, resized to the vertex count.</param>
+    void Weld(std::vector<Vector3Base<T>>& positions, std::vector<uint32_t>& remap)
+    {
+        remap.resize(positions.size());
+        Weld(positions.data(), positions.size(), remap.data());
+
+        // Unique vertices keep their relative order, so the array can be compacted in place
+        for (auto i = size_t(0); i < m_uniqueIndices.size(); i++)
+            positions[i] = positions[m_uniqueIndices[i]];
+
+        positions.resize(m_uniqueIndices.size());
+    }
+
+public:
+    /// <summary>
+    ///     Returns the index of the source vertex of every unique vertex found by the last Weld call,
+    ///     in increasing order. Used to compact the other vertex attributes.
+    /// </summary>
+    const std::vector<uint32_t>& GetUniqueIndices() const
+    {
+        return m_uniqueIndices;
+    }
+
+    size_t GetUniqueCount() const
+    {
+        return m_uniqueIndices.size();
+    }
+
+    T GetEpsilon() const
+    {
+        return m_epsilon;
+    }
+
+private:
+    static const size_t PrefetchDistance = 16;
+
+    struct Slot
+    {
+        uint32_t key;
+        uint32_t head;
+    };
+
+    struct Node
+    {
+        Vector3Base<T> position;
+        uint32_t unique;
+        uint32_t next;
+    };
+
+    struct Cell
+    {
+        int64_t components[3];
+
+        int64_t operator[](const size_t index) const
+        {
+            return components[index];
+        }
+    };
+
+    Cell GetCell(const Vector3Base<T>& position) const
+    {
+        return Cell { {
+            static_cast<int64_t>(std::floor(position.x * m_inverseCellSize)),
+            static_cast<int64_t>(std::floor(position.y * m_inverseCellSize)),
+            static_cast<int64_t>(std::floor(position.z * m_inverseCellSize)) } };
+    }
+
+    static void Prefetch(const void* address)
+    {
+#if defined(_MSC_VER) && SIMD_X86
+        _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#endif
+    }
+
+    static uint32_t GetCellKey(const int64_t x, const int64_t y, const int64_t z)
+    {
+        const auto hash = (static_cast<uint64_t>(x) * 73856093ull) ^ (static_cast<uint64_t>(y) * 19349663ull) ^ (static_cast<uint64_t>(z) * 83492791ull);
+        return static_cast<uint32_t>((hash * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    /// <summary>
+    ///     Returns the 32-bit key of the cell of a position (of the position itself with zero epsilon).
+    ///     Different cells sharing a key only put more vertices into a single list, the distance test stays exact.
+    /// </summary>
+    uint32_t GetKey(const Vector3Base<T>& position) const
+    {
+        if (m_epsilon > T(0))
+        {
+            const auto cell = GetCell(position);
+            return GetCellKey(cell[0], cell[1], cell[2]);
+        }
+
+        const auto hash = static_cast<uint64_t>(std::hash<Vector3Base<T>>()(position));
+        return static_cast<uint32_t>((hash * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    size_t FindSlot(const uint32_t key) const
+    {
+        const auto mask = m_slots.size() - 1;
+        auto index = static_cast<size_t>(key) & mask;
+
+        while (m_slots[index].head != InvalidIndex && m_slots[index].key != key)
+            index = (index + 1) & mask;
+
+        return index;
+    }
+
+    void Insert(const uint32_t key, const Vector3Base<T>& position, const uint32_t unique)
+    {
+        // Keep the table at most half full
+        if ((m_cellCount + 1) * 2 > m_slots.size())
+            Grow();
+
+        auto& slot = m_slots[FindSlot(key)];
+        if (slot.head == InvalidIndex)
+        {
+            slot.key = key;
+            m_cellCount++;
+        }
+
+        m_nodes.push_back(Node { position, unique, slot.head });
+        slot.head = static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    void Grow()
+    {
+        std::vector<Slot> slots(m_slots.size() * 2, Slot { 0, InvalidIndex });
+        slots.swap(m_slots);
+
+        for (const auto& slot : slots)
+        {
+            if (slot.head != InvalidIndex)
+                m_slots[FindSlot(slot.key)] = slot;
+        }
+    }
+
+    void Reset(const size_t count)
+    {
+        // The table starts large enough for a mesh with every vertex shared by a few triangles,
+        // the buffers keep their capacity between the calls
+        auto capacity = size_t(1024);
+        while (capacity < count)
+            capacity *= 2;
+
+        m_slots.assign(capacity, Slot { 0, InvalidIndex });
+        m_nodes.clear();
+        m_uniqueIndices.clear();
+        m_cellCount = 0;
+    }
+
+private:
+    T m_epsilon = T(0);
+    T m_inverseCellSize = T(0);
+
+    std::vector<Slot> m_slots;
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_uniqueIndices;
+    size_t m_cellCount = 0;
+};